@@ -0,0 +1,62 @@
+#ifndef BLENDED_MOVE_H
+#define BLENDED_MOVE_H
+
+#include <Arduino.h>
+#include "MotionHandle.h"
+
+//* ************************************************************************
+//* ************************ BLENDED X/Z MOVES ***************************
+//* ************************************************************************
+// Two-axis path planner that overlaps Z and X travel. A blended move is:
+//   1. Z moves to its lift height
+//   2. X starts toward its target once Z is within the clearance envelope
+//      of the lift height (Z_BLEND_CLEARANCE_POS)
+//   3. Z starts toward its final height once X is within the blend window
+//      of its target (X_BLEND_WINDOW_POS) and the optional descent gate
+//      allows it
+// With both envelope values at zero this degrades to the old strictly
+// serial Z-up / X-move / Z-down sequence. The arm follows one path at a
+// time; starting a new path replaces the one in progress.
+
+// Planner phases
+enum BlendPhase {
+  BLEND_IDLE,
+  BLEND_LIFT,      // Z moving to lift height, X waiting for clearance
+  BLEND_TRAVEL,    // X moving, Z waiting for the blend window
+  BLEND_DESCEND,   // Z moving to its final height, X finishing
+  BLEND_DONE
+};
+
+// Returns true when Z may start its final move (e.g. Stage 2 safety signal)
+typedef bool (*BlendGate)();
+
+// Handle to a blended move (same idea as MotionHandle)
+class BlendedPath {
+ public:
+  BlendedPath() : id(0) {}
+
+  bool isIdle() const { return id == 0; }
+  bool isXReleased() const;   // X has started travelling
+  bool isDescending() const;  // Z has started its final move
+  bool isDone() const;        // Both axes at their final targets
+  void reset() { id = 0; }
+
+ private:
+  friend BlendedPath startBlendedMove(long xTarget, long zLift, long zFinal, BlendGate descentGate);
+  BlendPhase phase() const;
+  uint32_t id;
+};
+
+// Start a blended move along Z lift -> X travel -> Z final
+BlendedPath startBlendedMove(long xTarget, long zLift, long zFinal, BlendGate descentGate = nullptr);
+
+// Advance the planner (call once per loop)
+void updateBlendedMove();
+
+// Current planner phase (for status reporting)
+BlendPhase getBlendPhase();
+
+// True while Z is held back only by the descent gate
+bool isWaitingForDescentGate();
+
+#endif  // BLENDED_MOVE_H
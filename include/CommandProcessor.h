@@ -0,0 +1,48 @@
+#ifndef COMMAND_PROCESSOR_H
+#define COMMAND_PROCESSOR_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ COMMAND PROCESSOR ***************************
+//* ************************************************************************
+// Serial console. pollSerialCommands() moves whatever bytes have arrived
+// into a fixed line buffer and returns at once - a half-typed line just
+// waits for the rest - so typing never stalls a task. Complete lines are
+// looked up in one command table and split into arguments in place.
+//
+// Each command runs where it belongs:
+//   - COMMAND_COMMS: reports and settings that do not touch motion run on
+//     the comms task straight away, so long output never holds up the
+//     motion task. stop is here too: it raises the emergency stop flag
+//     instead of queueing, so a full queue cannot drop it.
+//   - COMMAND_MOTION: anything that moves the machine or changes what the
+//     cycle reads is queued and run on the motion task between updates.
+//     These reply through the log (LOG_INFO/LOG_WARN), never with a
+//     blocking Serial write.
+//
+// Other command sources (the dashboard) submit lines the same way.
+
+enum CommandContext {
+  COMMAND_COMMS,
+  COMMAND_MOTION
+};
+
+struct SerialCommand {
+  const char* name;   // One or more words; the longest match wins ("phases reset" before "phases")
+  CommandContext context;
+  bool (*handler)(char* args);  // args: rest of the line, split in place; false prints the usage
+  const char* usage;  // Argument summary for help
+  const char* help;
+};
+
+// Comms task: read available Serial bytes and run complete lines (never blocks)
+void pollSerialCommands();
+
+// Comms task: run or queue one command line (modified in place)
+void submitCommandLine(char* line);
+
+// Motion task: run a line queued by submitCommandLine()
+void runQueuedCommand(char* line);
+
+#endif  // COMMAND_PROCESSOR_H
@@ -1,6 +1,8 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include "../FixedPoint.h"
+
 // Board identification
 extern const char* BOARD_ID;
 extern const char* BOARD_DESCRIPTION;
@@ -13,8 +15,8 @@ extern const float STEPS_PER_MM;  // Steps per mm of linear movement
 extern const float STEPS_PER_INCH;  // Convert to steps per inch
 
 // Positions
-extern const float X_HOME_POS;  // X-axis home position (in steps)
-extern const float Z_HOME_POS;  // Z-axis home position (in steps)
+extern const long X_HOME_POS;  // X-axis home position (in steps)
+extern const long Z_HOME_POS;  // Z-axis home position (in steps)
 
 // X-axis positions in inches from home
 extern const float X_PICKUP_POS_INCHES;      // X-axis pickup position (1 inch)
@@ -28,38 +30,127 @@ extern const float Z_PICKUP_LOWER_INCHES;   // Lower Z-axis by 5 inches for pick
 extern const float Z_SUCTION_START_INCHES;  // Start suction when Z is 4 inches down
 extern const float Z_DROPOFF_LOWER_INCHES;  // Lower Z-axis by 5.5 inches for dropoff
 
-// Converted positions to steps
-extern const float X_PICKUP_POS;
-extern const float X_DROPOFF_POS;
-extern const float X_DROPOFF_OVERSHOOT_POS;  // Overshoot position in steps
-extern const float X_SERVO_ROTATE_POS;  // Position to start servo rotation for dropoff
-extern const float X_MIDPOINT_POS;  // Kept for reference
-
-extern const float Z_UP_POS;  // Z-axis fully up position
-extern const float Z_PICKUP_POS;  // Z-axis down position for pickup
-extern const float Z_SUCTION_START_POS;  // Z position to start suction
-extern const float Z_DROPOFF_POS;  // Z-axis down position for dropoff
-
-// Servo angles
+// Converted positions in whole steps (rounded once here)
+extern const long X_PICKUP_POS;
+extern const long X_DROPOFF_POS;
+extern const long X_DROPOFF_OVERSHOOT_POS;  // Overshoot position in steps
+extern const long X_SERVO_ROTATE_POS;  // Position to start servo rotation for dropoff
+extern const long X_MIDPOINT_POS;  // Kept for reference
+
+extern const long Z_UP_POS;  // Z-axis fully up position
+extern const long Z_PICKUP_POS;  // Z-axis down position for pickup
+extern const long Z_SUCTION_START_POS;  // Z position to start suction
+extern const long Z_DROPOFF_POS;  // Z-axis down position for dropoff
+
+// Blended X/Z motion envelope
+extern const bool BLENDED_MOTION_ENABLED;    // Overlap Z lift/lower with X travel
+extern const float Z_BLEND_CLEARANCE_INCHES;  // X may move once Z is this close to its lift height
+extern const float X_BLEND_WINDOW_INCHES;     // Z may lower once X is this close to its target
+extern const long Z_BLEND_CLEARANCE_POS;     // Clearance envelope in steps (0 when disabled)
+extern const long X_BLEND_WINDOW_POS;        // Blend window in steps (0 when disabled)
+
+// Servo angles (pickup, travel and dropoff can be changed with 'config set' - see ConfigSettings.h)
 extern const float SERVO_HOME_POS;    // Servo home position (in degrees)
-extern const float SERVO_PICKUP_POS;  // Servo pickup position (in degrees)
-extern const float SERVO_TRAVEL_POS;   // Servo position for travel after pickup (in degrees)
-extern const float SERVO_DROPOFF_POS; // Servo dropoff position (90 degrees from pickup)
-
-// Timing constants
-extern const unsigned long PICKUP_HOLD_TIME;  // Hold time at pickup position (300ms)
-extern const unsigned long DROPOFF_HOLD_TIME; // Hold time at dropoff position (100ms)
-extern const unsigned long SERVO_ROTATION_WAIT_TIME;  // Wait time for servo to complete rotation at overshoot position (500ms)
-
-// Stepper settings
-extern const float X_MAX_SPEED;      // Maximum speed for X-axis in steps per second
-extern const float X_ACCELERATION;   // Acceleration for X-axis in steps per second^2
-extern const float Z_MAX_SPEED;      // Maximum speed for Z-axis in steps per second
-extern const float Z_ACCELERATION;   // Acceleration for Z-axis in steps per second^2
-extern const float Z_DROPOFF_MAX_SPEED;  // Same speed for now for dropoff
-extern const float Z_DROPOFF_ACCELERATION;  // Same acceleration for now for dropoff
-extern const float X_HOME_SPEED;      // Homing speed for X-axis in steps per second
-extern const float Z_HOME_SPEED;      // Homing speed for Z-axis in steps per second
+extern float SERVO_PICKUP_POS;  // Servo pickup position (in degrees)
+extern float SERVO_TRAVEL_POS;   // Servo position for travel after pickup (in degrees)
+extern float SERVO_DROPOFF_POS; // Servo dropoff position (90 degrees from pickup)
+
+// Timing constants (can be changed with 'config set' - see ConfigSettings.h)
+extern unsigned long PICKUP_HOLD_TIME;  // Hold time at pickup position (300ms)
+extern unsigned long DROPOFF_HOLD_TIME; // Hold time at dropoff position (100ms)
+extern unsigned long SERVO_ROTATION_WAIT_TIME;  // Wait time for servo to complete rotation at overshoot position (500ms)
+
+// Transport mode
+enum TransportMode {
+  TRANSPORT_MODE_ROTATE_IN_MOTION,  // Rotate servo as X passes X_SERVO_ROTATE_POS, go straight to dropoff
+  TRANSPORT_MODE_OVERSHOOT          // Rotate servo at the overshoot position, then return to dropoff
+};
+extern const TransportMode TRANSPORT_MODE;  // How the servo is rotated for dropoff
+
+// Stepper settings (Q16.16 fixed point)
+extern const q16_t X_MAX_SPEED;      // Maximum speed for X-axis in steps per second
+extern const q16_t X_ACCELERATION;   // Acceleration for X-axis in steps per second^2
+extern const q16_t Z_MAX_SPEED;      // Maximum speed for Z-axis in steps per second
+extern const q16_t Z_ACCELERATION;   // Acceleration for Z-axis in steps per second^2
+extern const q16_t Z_DROPOFF_MAX_SPEED;  // Same speed for now for dropoff
+extern const q16_t Z_DROPOFF_ACCELERATION;  // Same acceleration for now for dropoff
+extern const q16_t X_HOME_SPEED;      // Homing speed for X-axis in steps per second
+extern const q16_t Z_HOME_SPEED;      // Homing speed for Z-axis in steps per second
+
+// Two-speed homing
+extern const q16_t X_HOME_FAST_SPEED;    // Fast approach speed for X-axis in steps per second
+extern const q16_t Z_HOME_FAST_SPEED;    // Fast approach speed for Z-axis in steps per second
+extern const q16_t HOME_ACCELERATION;    // Acceleration/deceleration while homing in steps per second^2
+extern const float HOME_BACKOFF_INCHES;  // Back-off distance before the slow re-touch
+extern const long HOME_BACKOFF_STEPS;    // Back-off distance in steps
+extern const float X_HOME_SEARCH_INCHES; // Fast search distance for X before falling back to a slow crawl
+extern const float Z_HOME_SEARCH_INCHES; // Fast search distance for Z before falling back to a slow crawl
+extern const long X_HOME_SEARCH_STEPS;   // X search distance in steps
+extern const long Z_HOME_SEARCH_STEPS;   // Z search distance in steps
+extern const uint32_t HOME_SWITCH_CONFIRM_MS;  // How long a latched switch edge must stay HIGH (longer than the 2 ms debounce)
+
+// X re-reference policy
+extern const unsigned long X_REHOME_INTERVAL_CYCLES;       // Re-home X every N cycles (0 = only on drift)
+extern const unsigned long X_DRIFT_CHECK_INTERVAL_CYCLES;  // Check X drift at the home switch every N cycles (0 = never)
+extern const long X_DRIFT_TOLERANCE_STEPS;                 // Drift that triggers a re-home
+extern const float X_DRIFT_CHECK_OVERTRAVEL_INCHES;        // How far past the switch edge the drift check travels
+extern const long X_DRIFT_CHECK_OVERTRAVEL_STEPS;          // Drift check overtravel in steps
+
+// Task layout (see TaskManager.h)
+extern const int MOTION_TASK_CORE;                // Core running motion and the state machines
+extern const int COMMS_TASK_CORE;                 // Core running WiFi, OTA, Serial and logging
+extern const unsigned int MOTION_TASK_PRIORITY;   // FreeRTOS priority of the motion task
+extern const unsigned int COMMS_TASK_PRIORITY;    // FreeRTOS priority of the comms task
+extern const uint32_t MOTION_TASK_STACK_SIZE;     // Motion task stack in bytes
+extern const uint32_t COMMS_TASK_STACK_SIZE;      // Comms task stack in bytes
+extern const uint32_t MOTION_TASK_PERIOD_MS;      // Motion task update period
+extern const uint32_t COMMS_TASK_PERIOD_MS;       // Comms task update period
+extern const unsigned int LOG_TASK_PRIORITY;      // FreeRTOS priority of the log drain task (comms core)
+extern const uint32_t LOG_TASK_STACK_SIZE;        // Log drain task stack in bytes
+extern const uint32_t LOG_DRAIN_IDLE_MS;          // Log drain sleep when the rings are empty
+extern const unsigned long LOG_THROTTLE_SUMMARY_MS;  // Summary interval for repeated wait logs
+
+// Pulse outputs (see PulseOutput.h)
+extern const uint32_t STAGE2_SIGNAL_PULSE_MS;    // Width of the "part ready" pulse to Stage 2
+extern const bool STAGE2_SIGNAL_ACTIVE_HIGH;      // Pulse polarity: true drives HIGH during the pulse
+
+// Trigger capture (see TriggerCapture.h)
+extern const uint32_t TRIGGER_CONFIRM_MS;   // Bounce window and how long an edge must stay HIGH
+extern const uint32_t TRIGGER_MAX_AGE_MS;   // Pending triggers older than this are discarded
+
+// PSRAM trace store (see TraceStore.h)
+extern const uint32_t TRACE_STORE_FINE_PERIOD_MS;    // Fine tier sample period
+extern const uint32_t TRACE_STORE_COARSE_PERIOD_MS;  // Coarse tier sample period
+extern const uint32_t TRACE_STORE_FINE_BYTES;        // PSRAM used by the fine tier
+extern const uint32_t TRACE_STORE_COARSE_BYTES;      // PSRAM used by the coarse tier
+
+// Dashboard WebSocket server (see DashboardServer.h)
+extern const uint16_t DASHBOARD_PORT;                // Port data/index.html connects to
+extern const uint32_t DASHBOARD_STATUS_INTERVAL_MS;  // Minimum time between status pushes
+
+// Binary telemetry stream (see Telemetry.h)
+extern const uint16_t TELEMETRY_DEFAULT_PORT;     // UDP port when 'telemetry <ip>' names none
+extern const uint32_t TELEMETRY_DEFAULT_RATE_HZ;  // Sample rate when 'telemetry <ip>' names none
+extern const uint32_t TELEMETRY_MAX_RATE_HZ;      // Highest accepted sample rate
+extern const uint32_t TELEMETRY_MAX_BATCH_MS;     // A partly filled packet is sent after this long
+
+// Resource monitor (see ResourceMonitor.h)
+extern const uint32_t RESOURCE_SAMPLE_PERIOD_MS;           // How often heap and stacks are sampled
+extern const uint32_t RESOURCE_HISTORY_PERIOD_MS;          // Interval summarised by one history entry
+extern const uint32_t RESOURCE_MIN_FREE_HEAP_BYTES;        // Warn when free heap drops below this
+extern const uint32_t RESOURCE_MIN_LARGEST_BLOCK_BYTES;    // Warn when the largest free block drops below this
+extern const uint8_t RESOURCE_MAX_FRAGMENTATION_PERCENT;   // Warn when fragmentation rises above this
+extern const uint32_t RESOURCE_MIN_STACK_FREE_BYTES;       // Warn when a task's stack headroom drops below this
+
+// Motion profile shape per axis
+enum MotionProfileType {
+  PROFILE_TRAPEZOID,  // Constant acceleration (AccelStepper-style ramp)
+  PROFILE_SCURVE      // Jerk-limited acceleration
+};
+extern const MotionProfileType X_MOTION_PROFILE;  // Profile used for X-axis moves
+extern const MotionProfileType Z_MOTION_PROFILE;  // Profile used for Z-axis moves
+extern const long X_JERK;           // Jerk limit for X-axis in steps per second^3 (S-curve only)
+extern const long Z_JERK;           // Jerk limit for Z-axis in steps per second^3 (S-curve only)
 
 // State enum for pick cycle
 enum PickCycleState {
@@ -99,6 +190,7 @@ enum PickupSequenceState {
 enum TransportSequenceState {
   TRANSPORT_ROTATE_SERVO_TO_TRAVEL,
   TRANSPORT_MOVE_TO_OVERSHOOT,
+  TRANSPORT_ROTATE_SERVO_IN_MOTION,
   TRANSPORT_WAIT_FOR_SERVO_ROTATION,
   TRANSPORT_RETURN_TO_DROPOFF_POS,
   TRANSPORT_COMPLETE
@@ -112,6 +204,14 @@ enum DropoffSequenceState {
   DROPOFF_COMPLETE
 };
 
+enum HomingSequenceState {
+  HOMING_Z_AXIS,
+  HOMING_RAISE_Z,
+  HOMING_X_AXIS,
+  HOMING_MOVE_X_TO_PICKUP,
+  HOMING_COMPLETE
+};
+
 enum CompletionSequenceState {
   COMPLETION_SIGNAL_STAGE2_STATE,
   COMPLETION_RETURN_TO_PICKUP_PRE_HOME,
@@ -19,4 +19,8 @@ extern const int SERVO_PIN;           // Servo control pin
 extern const int SOLENOID_RELAY_PIN;  // Solenoid relay control pin
 extern const int STAGE2_SIGNAL_PIN;   // Signal output to Stage 2 machine (active high)
 
+// Hardware timers
+extern const int X_STEP_TIMER;        // Hardware timer driving X-axis step pulses
+extern const int Z_STEP_TIMER;        // Hardware timer driving Z-axis step pulses
+
 #endif  // PINS_DEFINITIONS_H 
\ No newline at end of file
@@ -0,0 +1,54 @@
+#ifndef CONFIG_SETTINGS_H
+#define CONFIG_SETTINGS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+//* ************************************************************************
+//* ************************ CONFIG SETTINGS ***************************
+//* ************************************************************************
+// Named view of the Config values an operator tunes, for 'config get/set'
+// and the dashboard's settings form (names match data/index.html). Most
+// entries are read-only: positions and speeds feed precomputed move
+// profiles and step conversions at boot. The servo angles and hold times
+// are read each cycle, so they can be changed at run time; a change lasts
+// until the next reboot. Writes happen on the motion task, the only task
+// that reads these values during a cycle.
+
+enum ConfigSettingType {
+  SETTING_FLOAT,  // float
+  SETTING_ULONG,  // unsigned long
+  SETTING_Q16     // q16_t, shown as a whole number
+};
+
+struct ConfigSetting {
+  const char* name;        // Dashboard key
+  ConfigSettingType type;
+  const void* value;       // The Config variable
+  bool writable;
+  float minimum;           // Accepted range for writes
+  float maximum;
+  const char* units;
+};
+
+enum ConfigSetResult {
+  CONFIG_SET_OK,
+  CONFIG_SET_UNKNOWN,
+  CONFIG_SET_READ_ONLY,
+  CONFIG_SET_INVALID,
+  CONFIG_SET_OUT_OF_RANGE
+};
+
+uint8_t getConfigSettingCount();
+const ConfigSetting& getConfigSetting(uint8_t index);
+
+// nullptr if no setting has that name
+const ConfigSetting* findConfigSetting(const char* name);
+
+// Current value as text; returns the length written
+size_t formatConfigSetting(const ConfigSetting& setting, char* buffer, size_t size);
+
+// Motion task: parse and store a new value
+ConfigSetResult setConfigSetting(const char* name, const char* text);
+
+#endif  // CONFIG_SETTINGS_H
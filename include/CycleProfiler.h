@@ -0,0 +1,39 @@
+#ifndef CYCLE_PROFILER_H
+#define CYCLE_PROFILER_H
+
+#include <Arduino.h>
+#include "../src/Config/Config.h"
+
+//* ************************************************************************
+//* ************************ CYCLE PROFILER ***************************
+//* ************************************************************************
+// Per-phase cycle time breakdown. The pick cycle coordinator reports its
+// current sequence and sub-state after every update; each change closes
+// the previous sub-state and opens the next one. Completed cycles go into a
+// rolling window of the last CYCLE_PROFILE_WINDOW cycles, which is
+// summarised as p50/p95/p99/max per sub-state, per sequence and for the
+// whole cycle, plus parts per hour. Time spent held by the Stage 2 safety
+// signal is tracked separately (it overlaps the sub-state it happens in).
+// Cycles interrupted before the completion sequence are discarded.
+
+const uint8_t CYCLE_PROFILE_WINDOW = 50;
+
+// Sequences of one pick cycle (sub-states come from the sequence enums in Config.h)
+enum CycleSequence {
+  CYCLE_SEQUENCE_NONE,        // Idle or homing - no cycle running
+  CYCLE_SEQUENCE_PICKUP,
+  CYCLE_SEQUENCE_TRANSPORT,
+  CYCLE_SEQUENCE_DROPOFF,
+  CYCLE_SEQUENCE_COMPLETION
+};
+
+// Report the current sequence and sub-state (called once per update)
+void profileCycleState(CycleSequence sequence, uint8_t subState, bool stage2Waiting);
+
+// Print the breakdown for the cycles in the window
+void reportCycleProfile();
+
+// Empty the window
+void resetCycleProfile();
+
+#endif  // CYCLE_PROFILER_H
@@ -0,0 +1,82 @@
+#ifndef DASHBOARD_PROTOCOL_H
+#define DASHBOARD_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+//* ************************************************************************
+//* ************************ DASHBOARD PROTOCOL ***************************
+//* ************************************************************************
+// The JSON side of the dashboard server (see DashboardServer.h): status
+// deltas, the config message and the client commands. It knows nothing of
+// WebSocketsServer or the firmware tasks. Everything it needs from outside
+// comes through a DashboardTransport, so the same code runs behind the
+// WebSocket server on the ESP32 and behind a recording transport in the
+// host tests (pio test -e native).
+
+static const size_t DASHBOARD_MESSAGE_SIZE = 512;  // Longest message sent or accepted
+static const size_t DASHBOARD_COMMAND_LENGTH = 64;  // Console line buffer (COMMAND_LINE_LENGTH)
+
+// Status fields, one bit each, for delta messages
+enum DashboardField : uint16_t {
+  FIELD_STATE = 1 << 0,
+  FIELD_X_POS = 1 << 1,
+  FIELD_Z_POS = 1 << 2,
+  FIELD_SERVO_POS = 1 << 3,
+  FIELD_VACUUM = 1 << 4,
+  FIELD_X_HOME = 1 << 5,
+  FIELD_Z_HOME = 1 << 6,
+  FIELD_FREE_HEAP = 1 << 7,
+  FIELD_RESOURCE_WARNINGS = 1 << 8,
+  FIELD_ALL = 0x1FF
+};
+
+// What the dashboard shows
+struct DashboardStatus {
+  const char* state;  // getStateString() name
+  long xPos;
+  long zPos;
+  float servoPos;
+  bool vacuum;
+  bool xHome;
+  bool zHome;
+  uint16_t freeHeapKb;      // Whole KB, so byte-level churn does not push a message
+  uint8_t resourceWarnings;  // ResourceWarning bits
+};
+
+// What the push timer last broadcast - deltas are taken against it
+struct DashboardPushState {
+  DashboardStatus lastSent;
+  bool haveLastSent;  // False until the first push (which sends every field)
+};
+
+// Where messages go and commands come from
+struct DashboardTransport {
+  void (*sendText)(uint8_t client, const char* text, size_t length);  // One text frame to a client
+  void (*submitCommand)(char* line);                                  // Console command line (split in place)
+  bool (*readStatus)(DashboardStatus& status);                        // False if no status yet
+};
+
+// Fields that differ between two statuses
+uint16_t changedDashboardFields(const DashboardStatus& before, const DashboardStatus& after);
+
+// Status message holding the given fields; returns the length written
+size_t formatDashboardStatus(char* buffer, size_t size, const DashboardStatus& status, uint16_t fields);
+
+// Push message for a new status: the fields changed since the last push,
+// or every field the first time. Returns 0 (and keeps the state) when
+// nothing changed; otherwise records the status as sent.
+size_t formatDashboardPush(DashboardPushState& push, const DashboardStatus& status, char* buffer, size_t size);
+
+// Config message from the settings table; returns the length written
+size_t formatDashboardConfig(char* buffer, size_t size);
+
+void sendDashboardStatus(const DashboardTransport& transport, uint8_t client);  // Every field
+void sendDashboardConfig(const DashboardTransport& transport, uint8_t client);
+void sendDashboardLog(const DashboardTransport& transport, uint8_t client, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+// Act on one text frame from a client
+void handleDashboardMessage(const DashboardTransport& transport, uint8_t client, const char* text);
+
+#endif  // DASHBOARD_PROTOCOL_H
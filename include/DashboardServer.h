@@ -0,0 +1,40 @@
+#ifndef DASHBOARD_SERVER_H
+#define DASHBOARD_SERVER_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ DASHBOARD SERVER ***************************
+//* ************************************************************************
+// WebSocket server for data/index.html on DASHBOARD_PORT. Runs entirely on
+// the comms task: status comes from the motion snapshot and commands go
+// through the command queue, so a slow or stalled client never reaches
+// TransferArm::update().
+//
+// Status is pushed rather than polled. At most every
+// DASHBOARD_STATUS_INTERVAL_MS the snapshot is compared with what was last
+// sent; if anything changed, one message holding only the changed fields
+// is formatted once and broadcast to every client. A client gets the full
+// status when it connects or sends getStatus.
+//
+// The messages themselves are built and parsed in DashboardProtocol.cpp;
+// this file is the WebSocket transport and the push timer around it.
+// HostDashboardServer.h serves the same protocol from a Linux host build.
+//
+// Messages (JSON text frames):
+//   client -> server  {"command":"getStatus"} | {"command":"getConfig"}
+//                     {"command":"emergencyStop"}
+//                     {"command":"manualControl","action":"home"|"pickCycle"|...}
+//   server -> client  {"type":"status", changed fields of state, xPos, zPos,
+//                      servoPos, vacuum, xHome, zHome, freeHeapKb,
+//                      resourceWarnings (ResourceWarning bits)}
+//                     {"type":"config","config":{...}}
+//                     {"type":"log","message":"..."}
+
+// Start listening (comms task, after WiFi is connected)
+void beginDashboardServer();
+
+// Comms task: serve clients and push status changes (call every period)
+void updateDashboardServer();
+
+#endif  // DASHBOARD_SERVER_H
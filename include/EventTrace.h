@@ -0,0 +1,73 @@
+#ifndef EVENT_TRACE_H
+#define EVENT_TRACE_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ EVENT TRACE ***************************
+//* ************************************************************************
+// Flight recorder for deep investigations. Each event is a fixed 12-byte
+// record (microsecond timestamp, type, track, value) written into a
+// preallocated ring that keeps the newest TRACE_BUFFER_EVENTS events.
+// Recording is a short critical section, so events can come from the
+// motion task and from the step ISRs.
+//
+// 'trace dump' streams the ring over Serial as text lines (see
+// dumpEventTrace()); tools/trace_to_chrome.py turns a captured dump into
+// Chrome trace JSON for chrome://tracing or ui.perfetto.dev, with one
+// track per axis, servo, vacuum, Stage 2 output, input and state machine.
+
+const uint16_t TRACE_BUFFER_EVENTS = 2048;
+
+// Event types (numbers are part of the dump format)
+enum TraceEventType {
+  TRACE_STATE = 0,         // track: main state (MainState in PickCycle.cpp), value: sub-state
+  TRACE_MOTION_START = 1,  // track: TraceAxis, value: target position in steps (start position for jogs)
+  TRACE_MOTION_END = 2,    // track: TraceAxis, value: final position in steps
+  TRACE_INPUT = 3,         // track: TraceInput, value: debounced level
+  TRACE_OUTPUT = 4,        // track: GPIO number, value: level written
+  TRACE_SERVO = 5          // track: 0, value: servo position in hundredths of a degree
+};
+
+enum TraceAxis {
+  TRACE_AXIS_X = 0,
+  TRACE_AXIS_Z = 1
+};
+
+enum TraceInput {
+  TRACE_INPUT_START_BUTTON = 0,
+  TRACE_INPUT_STAGE1 = 1,
+  TRACE_INPUT_STAGE2_STOP = 2,
+  TRACE_INPUT_X_HOME = 3,
+  TRACE_INPUT_Z_HOME = 4
+};
+
+// One recorded event
+struct TraceEvent {
+  uint32_t timestamp;  // micros()
+  uint8_t type;        // TraceEventType
+  uint8_t track;
+  uint16_t reserved;
+  int32_t value;
+};
+
+// Record one event (task or ISR context)
+void traceEvent(TraceEventType type, uint8_t track, int32_t value);
+
+// Write an output pin and record the change (task or ISR context)
+void traceDigitalWrite(uint8_t pin, uint8_t level);
+
+// Enable or pause recording (enabled at boot)
+void setEventTraceEnabled(bool enabled);
+bool isEventTraceEnabled();
+
+// Discard all recorded events
+void clearEventTrace();
+
+// Print buffer fill and recording state
+void reportEventTrace();
+
+// Stream the ring over Serial, oldest first (comms task - blocks on the UART)
+void dumpEventTrace();
+
+#endif  // EVENT_TRACE_H
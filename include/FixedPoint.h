@@ -0,0 +1,62 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <stdint.h>
+
+//* ************************************************************************
+//* ************************ FIXED POINT ***************************
+//* ************************************************************************
+// Q16.16 fixed point used for motion speeds and accelerations. The range is
+// +/-32767 with a resolution of 1/65536, which covers every speed (steps/s)
+// and acceleration (steps/s^2) the arm uses. Integer math keeps the motion
+// layer deterministic and avoids float equality comparisons.
+
+typedef int32_t q16_t;
+
+#define Q16_SHIFT 16
+#define Q16_ONE ((q16_t)1 << Q16_SHIFT)
+#define Q16_MAX_INT 32767  // Largest whole value
+
+// Conversions (constexpr so config values can be folded at compile time)
+constexpr q16_t q16FromInt(int32_t value) {
+  return (q16_t)(value * Q16_ONE);
+}
+
+constexpr q16_t q16FromFloat(float value) {
+  return (q16_t)(value * (float)Q16_ONE + (value >= 0.0f ? 0.5f : -0.5f));
+}
+
+// True for a positive speed or acceleration inside the Q16.16 range (for
+// static_assert on config values)
+constexpr bool q16IsValidRate(q16_t value) {
+  return value > 0 && value <= q16FromInt(Q16_MAX_INT);
+}
+
+inline float q16ToFloat(q16_t value) {
+  return (float)value / (float)Q16_ONE;
+}
+
+// Round to the nearest integer
+inline int32_t q16ToInt(q16_t value) {
+  return (value >= 0) ? (value + (Q16_ONE >> 1)) >> Q16_SHIFT
+                      : -((-value + (Q16_ONE >> 1)) >> Q16_SHIFT);
+}
+
+inline q16_t q16Abs(q16_t value) {
+  return (value >= 0) ? value : -value;
+}
+
+inline q16_t q16Mul(q16_t a, q16_t b) {
+  return (q16_t)(((int64_t)a * b) >> Q16_SHIFT);
+}
+
+inline q16_t q16Div(q16_t a, q16_t b) {
+  return (q16_t)(((int64_t)a << Q16_SHIFT) / b);
+}
+
+// Convert a distance in inches to whole steps, rounded to the nearest step
+constexpr long inchesToSteps(float inches, float stepsPerInch) {
+  return (long)(inches * stepsPerInch + (inches >= 0.0f ? 0.5f : -0.5f));
+}
+
+#endif  // FIXED_POINT_H
@@ -0,0 +1,29 @@
+#ifndef HEAP_AUDIT_H
+#define HEAP_AUDIT_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ HEAP AUDIT ***************************
+//* ************************************************************************
+// Checks that the pick cycle runs without touching the heap. In a build
+// with -DHEAP_AUDIT and the linker wraps for malloc, calloc and realloc
+// (the freenove_esp32_wrover_heap_audit environment), every allocation
+// made while a cycle is active is counted - motion task and other tasks
+// separately - and the first HEAP_AUDIT_CALLERS distinct call sites are
+// kept for the report. Decode them with
+//   xtensa-esp32-elf-addr2line -pfe .pio/build/<env>/firmware.elf <address>
+// In normal builds the functions below are empty and the report says so.
+
+const uint8_t HEAP_AUDIT_CALLERS = 8;
+
+// Motion task: count allocations from now on while active
+void setHeapAuditCycleActive(bool active);
+
+// Print allocation counts and call sites seen during cycles
+void reportHeapAudit();
+
+// Clear counts and call sites
+void resetHeapAudit();
+
+#endif  // HEAP_AUDIT_H
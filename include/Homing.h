@@ -14,9 +14,36 @@
 // Forward declaration
 class TransferArm;
 
-// Function declarations
-void homeSystem();
-void homeZAxis();
-void homeXAxis();
+// Homing sequence (non-blocking, driven from the pick cycle state machine)
+void initializeHomingSequence();
+void updateHomingSequence();
+HomingSequenceState getCurrentHomingState();
+
+// Per-axis homing (non-blocking: start, then update until it returns true;
+// a failed homing also returns true and latches the homing fault)
+void startHomeZAxis();
+bool updateHomeZAxis();
+void startHomeXAxis();
+bool updateHomeXAxis();
+
+// Latched when an axis fails to home; cleared when that axis homes again.
+// No cycle, trigger or manual move is started while it is set.
+bool isHomingFaulted();
+
+// Homing telemetry per axis
+struct HomingTelemetry {
+  unsigned long lastDurationMs;  // Duration of the last homing
+  unsigned long homeCount;       // Completed homings since boot
+  unsigned long faultCount;      // Homings that ended in a fault
+  unsigned long latchSamples;    // Homings made with a previous reference
+  long lastLatchError;           // Switch edge vs. the previous reference (steps)
+  float latchMean;               // Mean switch edge error (steps)
+  float latchM2;                 // Sum of squared deviations (Welford)
+  unsigned long switchGlitches;  // Switch edges rejected as glitches (homing and drift checks)
+};
+
+const HomingTelemetry& getXHomingTelemetry();
+const HomingTelemetry& getZHomingTelemetry();
+float getHomingLatchVariance(const HomingTelemetry& telemetry);
 
 #endif  // HOMING_H
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef HOST_DASHBOARD_SERVER_H
+#define HOST_DASHBOARD_SERVER_H
+
+#include <stdint.h>
+#include "DashboardProtocol.h"
+
+//* ************************************************************************
+//* ************************ HOST DASHBOARD SERVER ***************************
+//* ************************************************************************
+// The dashboard server for a Linux host build (pio test -e native): the
+// same DashboardProtocol.cpp behind a POSIX TCP socket instead of
+// WebSocketsServer, so tools/dashboard_client.py or a test can talk to it
+// without the controller. It speaks just enough WebSocket for that - the
+// RFC 6455 handshake, masked client text frames up to
+// DASHBOARD_MESSAGE_SIZE, close and ping - and pushes status the way
+// DashboardServer.cpp does: full status on connect, then at most every
+// DASHBOARD_STATUS_INTERVAL_MS one message with the changed fields,
+// broadcast to every client.
+//
+// Single-threaded: updateHostDashboardServer() is polled like
+// updateDashboardServer() and never waits on a quiet client. Not built
+// for the ESP32 (see build_src_filter in platformio.ini).
+
+// Listen on 127.0.0.1 (port 0 picks a free port). Command lines from
+// clients go to submitCommand. False if the socket cannot be opened.
+bool beginHostDashboardServer(uint16_t port, void (*submitCommand)(char* line));
+
+// Close every client and the listening socket
+void endHostDashboardServer();
+
+uint16_t getHostDashboardPort();  // Port actually bound
+
+// Status served from now on. The state name must have static storage,
+// like getStateString() names.
+void setHostDashboardStatus(const DashboardStatus& status);
+
+// Accept clients, handle their frames and push status changes
+void updateHostDashboardServer();
+
+#endif  // HOST_DASHBOARD_SERVER_H
@@ -0,0 +1,69 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ LATENCY STATISTICS ***************************
+//* ************************************************************************
+// Always-on timing histograms. Each histogram has fixed power-of-two
+// microsecond buckets, so recording a sample is a count-leading-zeros and
+// a few increments - cheap enough for the step ISR. Every histogram has a
+// single writer (one task or one ISR); readers take an unlocked copy, which
+// is fine for telemetry. reset() only raises a flag and the writer clears
+// the counts on its next sample, so resetting never races the writer.
+
+// Bucket 0 holds 0 us, bucket i holds [2^(i-1), 2^i) us, the last bucket
+// holds everything from 2^(LATENCY_BUCKETS-2) us up
+const uint8_t LATENCY_BUCKETS = 20;
+
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+
+  // Writer side (IRAM safe)
+  void record(uint32_t micros);
+
+  // Any side - clear on the writer's next sample
+  void reset() { resetPending = true; }
+
+  uint32_t count() const { return samples; }
+  uint32_t minimum() const { return samples > 0 ? minMicros : 0; }
+  uint32_t maximum() const { return maxMicros; }
+  uint32_t mean() const { return samples > 0 ? (uint32_t)(totalMicros / samples) : 0; }
+
+  // Upper bound of the bucket holding the given percentile (0-100)
+  uint32_t percentile(uint8_t percent) const;
+
+ private:
+  volatile bool resetPending;
+  uint32_t buckets[LATENCY_BUCKETS];
+  uint32_t samples;
+  uint32_t minMicros;
+  uint32_t maxMicros;
+  uint64_t totalMicros;
+};
+
+// Instrumented timings
+enum LatencyChannel {
+  LATENCY_LOOP_PERIOD,     // Motion task period, start to start
+  LATENCY_DEBOUNCE,        // Switch and signal debouncers
+  LATENCY_SERIAL,          // Queued serial commands
+  LATENCY_STEPPING,        // Motion completions, position triggers and blended moves
+  LATENCY_PICK_CYCLE,      // Pick cycle state machine
+  LATENCY_OTA,             // OTA handling on the comms task
+  LATENCY_X_STEP_ERROR,    // X step edge behind the timer schedule (step ISR)
+  LATENCY_Z_STEP_ERROR,    // Z step edge behind the timer schedule (step ISR)
+  LATENCY_TRIGGER_TO_MOTION,  // Start button / Stage 1 edge to the first axis motion of its cycle
+  LATENCY_CHANNEL_COUNT
+};
+
+LatencyHistogram& getLatencyHistogram(LatencyChannel channel);
+
+// Clear every histogram
+void resetLatencyStats();
+
+// Print count, min, percentiles and max per channel
+void reportLatencyStats();
+
+#endif  // LATENCY_STATS_H
@@ -0,0 +1,159 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ BINARY LOGGER ***************************
+//* ************************************************************************
+// Asynchronous leveled logger. A call writes one fixed-size binary record
+// (format string pointer as the message id, level, timestamp and up to
+// LOG_MAX_ARGS numeric arguments) into a lock-free ring; a background
+// drain task on the comms core formats the records and prints them. No
+// String is built and nothing waits on the UART in the calling task.
+//
+//   LOG_DEBUG("Moving X to pickup position: %ld", X_PICKUP_POS);
+//
+// Levels below LOG_MIN_LEVEL (set in platformio.ini build_flags, e.g.
+// -DLOG_MIN_LEVEL=LOG_LEVEL_INFO) compile to nothing - their arguments are
+// not even evaluated. Enabled levels are filtered again at run time
+// against setLogLevel() before any argument is packed.
+//
+// Format strings use printf conversions (%d %ld %u %lu %x %c %s %f %.Nf %%)
+// and must be string literals - only the pointer is stored. %s arguments
+// must likewise point at strings with static storage (literals, names).
+// Integers are stored as 32 bits and floating point values as float.
+
+// Log levels (macros so LOG_MIN_LEVEL can be compared by the preprocessor)
+#define LOG_LEVEL_TRACE 0
+#define LOG_LEVEL_DEBUG 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_WARN 3
+#define LOG_LEVEL_ERROR 4
+#define LOG_LEVEL_NONE 5
+
+// Build-time minimum level
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+const uint8_t LOG_MAX_ARGS = 6;
+
+// One log record as stored in the ring
+struct LogRecord {
+  int64_t timestamp;            // esp_timer_get_time() when logged (us since boot, never wraps)
+  const char* format;           // Message id (format string literal)
+  uint8_t level;
+  uint8_t argCount;
+  uintptr_t args[LOG_MAX_ARGS];  // Raw argument words
+};
+
+// Logger counters since boot
+struct LoggerStats {
+  uint32_t written;   // Records accepted
+  uint32_t dropped;   // Records lost because a ring was full
+  uint32_t highWater;  // Largest ring fill level seen by the drain task
+};
+
+// Argument packing - one machine word per argument
+inline uintptr_t logArg(int value) { return (uintptr_t)(int32_t)value; }
+inline uintptr_t logArg(unsigned int value) { return (uintptr_t)(uint32_t)value; }
+inline uintptr_t logArg(long value) { return (uintptr_t)(int32_t)value; }
+inline uintptr_t logArg(unsigned long value) { return (uintptr_t)(uint32_t)value; }
+inline uintptr_t logArg(long long value) { return (uintptr_t)(int32_t)value; }
+inline uintptr_t logArg(unsigned long long value) { return (uintptr_t)(uint32_t)value; }
+inline uintptr_t logArg(bool value) { return value ? 1 : 0; }
+inline uintptr_t logArg(char value) { return (uintptr_t)(uint8_t)value; }
+inline uintptr_t logArg(const char* value) { return (uintptr_t)value; }
+inline uintptr_t logArg(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+inline uintptr_t logArg(double value) { return logArg((float)value); }
+
+// Run-time minimum level (only levels compiled in can be enabled)
+extern volatile uint8_t runtimeLogLevel;
+void setLogLevel(uint8_t level);
+uint8_t getLogLevel();
+const char* getLogLevelName(uint8_t level);
+bool parseLogLevel(const char* name, uint8_t* level);
+
+// Store one record (use the LOG_* macros instead)
+void logWrite(uint8_t level, const char* format, const uintptr_t* args, uint8_t argCount);
+
+// Log a message: format string literal plus numeric or static string arguments
+template <typename... Args>
+inline void logAt(uint8_t level, const char* format, Args... args) {
+  static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "log calls take at most LOG_MAX_ARGS arguments");
+  if (level < runtimeLogLevel) return;
+  const uintptr_t packed[sizeof...(Args) + 1] = {logArg(args)..., 0};
+  logWrite(level, format, packed, sizeof...(Args));
+}
+
+// Leveled log macros - disabled levels compile to nothing
+#if LOG_MIN_LEVEL <= LOG_LEVEL_TRACE
+#define LOG_TRACE(...) logAt(LOG_LEVEL_TRACE, __VA_ARGS__)
+#else
+#define LOG_TRACE(...) do {} while (0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) logAt(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) do {} while (0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(...) logAt(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) do {} while (0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(...) logAt(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) do {} while (0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) logAt(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) do {} while (0)
+#endif
+
+// Suppressing log channel for polling waits. Call hit() on every poll while
+// the condition holds and clear() once it is gone: the first hit is logged,
+// repeats are only counted, and a summary with the count and duration is
+// logged every LOG_THROTTLE_SUMMARY_MS and when the condition clears.
+// Nothing is tracked while the level is filtered out, so code that acts on
+// the condition keeps its own flag. message must be a string literal.
+class LogThrottle {
+ public:
+  LogThrottle(uint8_t level, const char* message);
+
+  // Condition present (call on every poll)
+  void hit();
+
+  // Condition gone - logs the summary if anything was suppressed
+  void clear();
+
+ private:
+  uint8_t level;
+  const char* message;
+  bool active;
+  uint32_t count;              // Polls since the condition appeared
+  unsigned long startTime;     // millis() at the first hit
+  unsigned long lastSummary;   // millis() at the last periodic summary
+};
+
+// Start the drain task (called from startTasks()). Before this, records are
+// formatted and printed immediately by the caller.
+void startLogDrain();
+
+// Format a record into text (returns the text length)
+size_t formatLogRecord(const LogRecord& record, char* buffer, size_t size);
+
+LoggerStats getLoggerStats();
+
+#endif  // LOGGER_H
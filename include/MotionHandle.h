@@ -0,0 +1,54 @@
+#ifndef MOTION_HANDLE_H
+#define MOTION_HANDLE_H
+
+#include <Arduino.h>
+#include "StepperAxis.h"
+
+//* ************************************************************************
+//* ************************ MOTION HANDLES ***************************
+//* ************************************************************************
+// Non-blocking motion API. moveAxisTo() starts a move and returns a handle
+// the state machines poll (a future); an optional completion callback runs
+// from updateMotion() in loop context once the axis has stopped. Replaces
+// runToPosition() and the old moveToPosition() helper, so the main loop
+// keeps running at full rate during every move.
+
+// Completion callback (runs in loop context, never in the ISR)
+typedef void (*MotionCallback)(void* context);
+
+class MotionHandle {
+ public:
+  MotionHandle() : axis(nullptr), sequence(0), target(0) {}
+
+  // No move issued (or handle reset)
+  bool isIdle() const { return axis == nullptr; }
+
+  // Move issued and still in progress
+  bool isPending() const { return axis != nullptr && !axis->isMoveComplete(sequence); }
+
+  // Move issued and finished. A move replaced by a later moveTo() on the
+  // same axis finishes together with the move that replaced it.
+  bool isDone() const { return axis != nullptr && axis->isMoveComplete(sequence); }
+
+  // Forget the move so the handle can be reused for the next one
+  void reset() { axis = nullptr; }
+
+  long targetPosition() const { return target; }
+
+ private:
+  friend MotionHandle moveAxisTo(StepperAxis& axis, long target,
+                                 MotionCallback onComplete, void* context);
+
+  StepperAxis* axis;
+  uint32_t sequence;
+  long target;
+};
+
+// Start a move toward an absolute target and return its handle
+MotionHandle moveAxisTo(StepperAxis& axis, long target,
+                        MotionCallback onComplete = nullptr, void* context = nullptr);
+
+// Fire completion callbacks for finished moves (call once per loop)
+void updateMotion();
+
+#endif  // MOTION_HANDLE_H
@@ -0,0 +1,46 @@
+#ifndef MOTION_PROFILE_H
+#define MOTION_PROFILE_H
+
+#include <stdint.h>
+#include "Config/Config.h"
+
+//* ************************************************************************
+//* ************************ MOTION PROFILES ***************************
+//* ************************************************************************
+// Step interval tables for planned moves. A move is split into a symmetric
+// acceleration ramp, an optional cruise and the mirrored deceleration ramp.
+// The build functions turn the acceleration half into a table of step
+// intervals that the step ISR plays forward and then backward, so the ISR
+// only does table lookups. Ramps can be jerk-limited (S-curve) or constant
+// acceleration (trapezoid). Float math here runs in task context only. No
+// hardware dependencies, so it also builds on the host.
+
+// Limits for one axis
+struct ProfileLimits {
+  float maxSpeed;      // Steps per second
+  float acceleration;  // Steps per second^2
+  float jerk;          // Steps per second^3 (S-curve only)
+};
+
+// Largest acceleration ramp (in steps) an axis can hold in its table
+#define MAX_PROFILE_RAMP_STEPS 4096
+
+// Build the acceleration-ramp step intervals (1 us ticks) for a move of
+// `distance` steps. Returns the number of ramp intervals written, or -1 if
+// the ramp does not fit in `capacity`. cruiseInterval receives the cruise
+// interval in fixed point ticks (STEP_RAMP_FRACTION_BITS fractional bits).
+int buildSCurveRamp(const ProfileLimits& limits, long distance,
+                    uint16_t* intervals, int capacity, uint32_t* cruiseInterval);
+
+// Same as buildSCurveRamp() for a constant-acceleration (trapezoid) ramp
+int buildTrapezoidRamp(const ProfileLimits& limits, long distance,
+                       uint16_t* intervals, int capacity, uint32_t* cruiseInterval);
+
+// Build the ramp for either profile type
+int buildProfileRamp(const ProfileLimits& limits, MotionProfileType type, long distance,
+                     uint16_t* intervals, int capacity, uint32_t* cruiseInterval);
+
+// Ideal duration of a move in seconds for the given profile type
+float estimateMoveTime(const ProfileLimits& limits, MotionProfileType type, long distance);
+
+#endif  // MOTION_PROFILE_H
@@ -5,19 +5,19 @@
 #include "../src/Config/Config.h"
 #include "../src/Config/Pins_Definitions.h"
 
-// Forward declarations
-class AccelStepper;
-
 // Function declarations for pick cycle operations
 void initializePickCycle();
 void updatePickCycle();
 PickCycleState getCurrentState();
 void setCurrentState(PickCycleState newState);
 void triggerPickCycleFromWeb();
+void requestHoming();
+void emergencyStopPickCycle();
+bool isPickCycleIdle();  // Homed and waiting for a trigger
+uint8_t getPickCyclePhase();  // Main state << 4 | sub-state, for the trace store
 const char* getStateString(PickCycleState state);
 
-// Movement and utility functions
-bool moveToPosition(AccelStepper& stepper, float targetPosition);
+// Utility functions
 bool Wait(unsigned long duration, unsigned long* timer);
 
 #endif  // PICKCYCLE_H
\ No newline at end of file
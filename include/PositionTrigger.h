@@ -0,0 +1,66 @@
+#ifndef POSITION_TRIGGER_H
+#define POSITION_TRIGGER_H
+
+#include <Arduino.h>
+#include "StepperAxis.h"
+
+//* ************************************************************************
+//* ************************ POSITION TRIGGERS ***************************
+//* ************************************************************************
+// Position-compare triggers: "when axis A reaches step N moving in
+// direction D, fire action F". Triggers are checked from the step ISR on
+// every step, so they fire on the exact step regardless of loop rate. GPIO
+// actions run inside the ISR; servo, burst and stage actions touch
+// libraries that are not ISR safe, so the ISR flags them and
+// updatePositionTriggers() runs them on the next loop pass. Triggers are
+// one-shot and can be registered from any sequence file.
+
+// Action fired when the trigger position is reached
+enum TriggerAction {
+  TRIGGER_GPIO_SET,       // digitalWrite(argument, HIGH) in the step ISR
+  TRIGGER_GPIO_CLEAR,     // digitalWrite(argument, LOW) in the step ISR
+  TRIGGER_SERVO_WRITE,    // Servo to argument degrees (loop context)
+  TRIGGER_BURST_REQUEST,  // Photo capture burst request (loop context)
+  TRIGGER_STAGE_SIGNAL    // Signal Stage 2 (loop context)
+};
+
+// Direction of travel the trigger responds to
+const int8_t TRIGGER_FORWARD = 1;   // Position increasing
+const int8_t TRIGGER_REVERSE = -1;  // Position decreasing
+const int8_t TRIGGER_ANY = 0;
+
+class PositionTrigger {
+ public:
+  PositionTrigger() : slot(-1), generation(0) {}
+
+  // No trigger registered (or handle reset)
+  bool isIdle() const { return slot < 0; }
+
+  // Registered and waiting for its position
+  bool isArmed() const;
+
+  // Position reached and action carried out (deferred actions included)
+  bool hasFired() const;
+
+  // Disarm the trigger if it has not fired yet and reset the handle
+  void cancel();
+
+  // Forget the trigger (an armed trigger stays armed)
+  void reset() { slot = -1; }
+
+ private:
+  friend PositionTrigger addPositionTrigger(StepperAxis& axis, long position, int8_t direction,
+                                            TriggerAction action, int32_t argument);
+
+  int8_t slot;
+  uint16_t generation;
+};
+
+// Register a one-shot trigger. Returns an idle handle if the table is full.
+PositionTrigger addPositionTrigger(StepperAxis& axis, long position, int8_t direction,
+                                   TriggerAction action, int32_t argument = 0);
+
+// Run deferred trigger actions and recycle fired triggers (call once per loop)
+void updatePositionTriggers();
+
+#endif  // POSITION_TRIGGER_H
@@ -0,0 +1,37 @@
+#ifndef PULSE_OUTPUT_H
+#define PULSE_OUTPUT_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ PULSE OUTPUTS ***************************
+//* ************************************************************************
+// Non-blocking timed pulses. pulseOutput() drives the pin to its active
+// level and returns at once; a one-shot esp_timer (hardware timer backed)
+// drives it back to the idle level when the pulse width has elapsed, so
+// the caller's task keeps running instead of sitting in delay(). Pin,
+// width and polarity come from Config per output. Pulsing an output that
+// is already active restarts its width.
+
+// Timed outputs
+enum PulseChannel {
+  PULSE_STAGE2_SIGNAL,  // "Part ready" pulse to the Stage 2 machine
+  PULSE_CHANNEL_COUNT
+};
+
+// Create the timers and drive every output to its idle level (call from setup)
+void beginPulseOutputs();
+
+// Start a pulse of the configured width. False if no timer could end it;
+// the output is then left at its idle level.
+bool pulseOutput(PulseChannel channel);
+
+// Start a pulse of a specific width
+bool pulseOutputFor(PulseChannel channel, uint32_t widthMs);
+
+// End any pulse now and drive the output to its idle level
+void endPulseOutput(PulseChannel channel);
+
+bool isPulseActive(PulseChannel channel);
+
+#endif  // PULSE_OUTPUT_H
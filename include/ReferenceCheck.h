@@ -0,0 +1,46 @@
+#ifndef REFERENCE_CHECK_H
+#define REFERENCE_CHECK_H
+
+#include <Arduino.h>
+#include "Config/Config.h"
+
+//* ************************************************************************
+//* ************************ X REFERENCE CHECK ***************************
+//* ************************************************************************
+// Re-reference policy for the X axis. X used to be re-homed on every cycle.
+// Now the return move out of dropoff follows one of three plans:
+//   - Direct:      straight back to the pickup position
+//   - Drift check: return through the home switch with its edge latch armed.
+//                  The latched position shows how far the reference has
+//                  drifted, and drift beyond the tolerance triggers a re-home.
+//   - Re-home:     return next to the switch and run the homing routine
+//                  (every X_REHOME_INTERVAL_CYCLES cycles)
+
+enum XReturnPlan {
+  X_RETURN_DIRECT,
+  X_RETURN_DRIFT_CHECK,
+  X_RETURN_REHOME
+};
+
+// Drift check results since boot
+struct DriftTelemetry {
+  unsigned long checks;       // Drift checks completed
+  unsigned long rehomes;      // Re-homes triggered by drift or a missed switch
+  long lastDrift;             // Switch edge vs. X_HOME_POS at the last check (steps)
+  long maxAbsDrift;           // Largest drift seen (steps)
+};
+
+// Choose the plan for this cycle's return move (once per cycle) and return
+// the X target for it. Arms the switch latch for a drift check.
+long startXReturn();
+
+// Current plan (valid between startXReturn() and finishXReturn())
+XReturnPlan getXReturnPlan();
+
+// Call once the return move is done. Logs the drift for a drift check and
+// returns true if X must be re-homed before the next pickup.
+bool finishXReturn();
+
+const DriftTelemetry& getXDriftTelemetry();
+
+#endif  // REFERENCE_CHECK_H
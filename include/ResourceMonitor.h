@@ -0,0 +1,65 @@
+#ifndef RESOURCE_MONITOR_H
+#define RESOURCE_MONITOR_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ RESOURCE MONITOR ***************************
+//* ************************************************************************
+// Long-run view of heap and stack headroom. The comms task samples free
+// heap, the lowest free heap since boot, the largest free block and each
+// task's stack high-water mark every RESOURCE_SAMPLE_PERIOD_MS. Every
+// RESOURCE_HISTORY_PERIOD_MS the worst values of the interval go into a
+// small history, so days of uptime show as a trend rather than one number.
+//
+// Each sample is checked against the Config thresholds. A warning is
+// logged when a condition starts and again when it clears, so a slow leak
+// or growing fragmentation shows up well before an allocation fails or a
+// stack overflows mid-cycle.
+//
+// Free heap and the warning bits are also pushed in the dashboard status
+// (DashboardProtocol.h), so they are visible without a serial console.
+
+const uint8_t RESOURCE_HISTORY_SAMPLES = 48;  // 24 hours at the default 30 minute interval
+
+// Tasks whose stack headroom is watched
+enum ResourceTask {
+  RESOURCE_TASK_MOTION,
+  RESOURCE_TASK_COMMS,
+  RESOURCE_TASK_LOG,
+  RESOURCE_TASK_COUNT
+};
+
+// Warning bits (see getResourceWarnings())
+enum ResourceWarning {
+  RESOURCE_WARNING_LOW_HEAP = 1 << 0,       // Free heap below RESOURCE_MIN_FREE_HEAP_BYTES
+  RESOURCE_WARNING_SMALL_BLOCK = 1 << 1,    // Largest block below RESOURCE_MIN_LARGEST_BLOCK_BYTES
+  RESOURCE_WARNING_FRAGMENTED = 1 << 2,     // Fragmentation above RESOURCE_MAX_FRAGMENTATION_PERCENT
+  RESOURCE_WARNING_LOW_STACK = 1 << 3       // A task below RESOURCE_MIN_STACK_FREE_BYTES
+};
+
+// One sample (or, in the history, the worst values of one interval)
+struct ResourceSample {
+  uint32_t timestamp;                            // millis() when taken
+  uint32_t freeHeap;                             // Bytes
+  uint32_t minFreeHeap;                          // Lowest free heap since boot
+  uint32_t largestFreeBlock;                     // Largest single allocation possible
+  uint32_t stackFree[RESOURCE_TASK_COUNT];       // Stack high-water mark in bytes (0 = task not found)
+};
+
+// Comms task: take a sample when one is due (call every period)
+void updateResourceMonitor();
+
+// Latest sample; false before the first one
+bool getResourceSample(ResourceSample& sample);
+
+// Active warnings as ResourceWarning bits
+uint8_t getResourceWarnings();
+
+// Share of free heap not available as one block (0-100)
+uint8_t getFragmentationPercent(const ResourceSample& sample);
+
+// Print the latest sample, warnings, trend and history
+void reportResourceMonitor();
+
+#endif  // RESOURCE_MONITOR_H
@@ -0,0 +1,70 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+//* ************************************************************************
+//* ************************ SPSC QUEUE ***************************
+//* ************************************************************************
+// Lock-free single-producer / single-consumer ring used to hand data
+// between the motion and comms tasks. Exactly one task may push and
+// exactly one other task may pop. Neither side ever blocks or takes a
+// lock: push() fails when the ring is full and pop() fails when it is
+// empty. Capacity must be a power of two.
+
+template <typename T, uint32_t Capacity>
+class SpscQueue {
+  static_assert((Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+ public:
+  SpscQueue() : head(0), tail(0), dropped(0) {}
+
+  // Producer side - returns false (and counts a drop) when full
+  bool push(const T& item) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= Capacity) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    slots[h & (Capacity - 1)] = item;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Producer side - slot to fill in place, or nullptr when full. Call
+  // commit() once the slot is written.
+  T* reserve() {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= Capacity) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    return &slots[h & (Capacity - 1)];
+  }
+
+  void commit() { head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+  // Consumer side - returns false when empty
+  bool pop(T& item) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) {
+      return false;
+    }
+    item = slots[t & (Capacity - 1)];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Either side - approximate fill level and overflow count
+  uint32_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+  uint32_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+ private:
+  T slots[Capacity];
+  std::atomic<uint32_t> head;     // Next slot to write (producer owned)
+  std::atomic<uint32_t> tail;     // Next slot to read (consumer owned)
+  std::atomic<uint32_t> dropped;  // Pushes rejected because the ring was full
+};
+
+#endif  // SPSC_QUEUE_H
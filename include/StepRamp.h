@@ -0,0 +1,71 @@
+#ifndef STEP_RAMP_H
+#define STEP_RAMP_H
+
+#include <stdint.h>
+#include "FixedPoint.h"
+
+#if defined(ARDUINO)
+#include <esp_attr.h>
+#endif
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+//* ************************************************************************
+//* ************************ STEP RAMP ***************************
+//* ************************************************************************
+// Integer-only acceleration ramp used by the step timer interrupts.
+// stepRampNext() returns the interval until the next step in timer ticks,
+// using the same ramp equations as AccelStepper (David Austin, "Generate
+// stepper-motor speed profiles in real time") but without any float math,
+// so it is safe to call from an ISR. Nothing in here touches hardware, so
+// the ramp can also be driven from a virtual timer in a host build.
+
+// Step timer tick rate (1 MHz -> 1 microsecond per tick)
+#define STEP_TIMER_TICKS_PER_SEC 1000000UL
+
+// Intervals are kept in fixed point (8 fractional bits) so the average step
+// rate stays exact at high speed where an interval is only ~100 ticks
+#define STEP_RAMP_FRACTION_BITS 8
+
+struct StepRamp {
+  // Configuration (written from task context while holding the axis lock)
+  uint32_t c0;            // First interval from standstill (fixed point ticks)
+  uint32_t cMin;          // Interval at max speed (fixed point ticks)
+  int32_t maxRampSteps;   // Steps needed to reach max speed from standstill
+  q16_t acceleration;     // Steps/s^2, only used from task context
+
+  // Motion state (owned by the step ISR while the axis is running)
+  int32_t n;              // Ramp counter: >0 accelerating, <0 decelerating
+  uint32_t cn;            // Current interval (fixed point ticks)
+  uint32_t remainder;     // Fractional ticks carried into the next interval
+  int8_t direction;       // +1 / -1, 0 when stopped
+};
+
+// Configure ramp limits from max speed (steps/s) and acceleration
+// (steps/s^2). Called from task context only (uses 64-bit division).
+void stepRampConfigure(StepRamp& ramp, q16_t maxSpeed, q16_t acceleration);
+
+// Re-seed the ramp counter so the ramp continues from the given speed
+// (steps per second, signed). Called from task context only.
+void stepRampSetSpeed(StepRamp& ramp, q16_t speed);
+
+// Clear motion state (axis stopped)
+void stepRampReset(StepRamp& ramp);
+
+// Compute the interval before the next step given the remaining distance.
+// Returns 0 when the axis should stop. Updates ramp.direction for the step.
+uint32_t stepRampNext(StepRamp& ramp, int32_t distanceToGo);
+
+// Current speed in steps per second (unsigned, 0 when stopped)
+q16_t stepRampSpeed(const StepRamp& ramp);
+
+// Convert between a speed in steps/s and a fixed point step interval
+uint32_t stepRampIntervalForSpeed(q16_t speed);
+q16_t stepRampSpeedForInterval(uint32_t interval);
+
+// Steps needed to stop from the current speed
+int32_t stepRampStepsToStop(const StepRamp& ramp);
+
+#endif  // STEP_RAMP_H
@@ -0,0 +1,162 @@
+#ifndef STEPPER_AXIS_H
+#define STEPPER_AXIS_H
+
+#include <Arduino.h>
+#include "StepRamp.h"
+#include "MotionProfile.h"
+#include "LatencyStats.h"
+#include "EventTrace.h"
+
+//* ************************************************************************
+//* ************************ STEPPER AXIS ***************************
+//* ************************************************************************
+// Interrupt-driven replacement for AccelStepper. Each axis owns one ESP32
+// hardware timer running at 1 MHz; the timer ISR raises the step pin, drops
+// it again after the minimum pulse width and computes the next interval
+// from the integer StepRamp. Step timing no longer depends on how often
+// loop() runs. The public interface keeps the AccelStepper names used by
+// the state files (moveTo, distanceToGo, currentPosition, ...).
+
+class StepperAxis;
+
+// Called from the step ISR after every position change (must be IRAM_ATTR)
+typedef void (*StepHook)(StepperAxis* axis, long position, int8_t direction);
+
+class StepperAxis {
+ public:
+  StepperAxis(uint8_t stepPin, uint8_t dirPin, uint8_t timerIndex);
+
+  // Attach the hardware timer and configure pins (call from setup)
+  void begin();
+
+  // Motion limits (Q16.16 steps/s and steps/s^2)
+  void setMaxSpeed(q16_t speed);
+  void setAcceleration(q16_t acceleration);
+  void setMinPulseWidth(unsigned int microseconds);
+
+  // Select trapezoid or S-curve moves; jerk in steps/s^3 is used by S-curve only.
+  // On the motion task only cached moves run as S-curves (see cacheMove()).
+  void setProfile(MotionProfileType type, long jerk);
+
+  // Precompute the step intervals for a fixed move with the current limits
+  // and profile (call from setup). A later moveTo() that matches start
+  // position, target and limits plays the cached table.
+  bool cacheMove(long from, long to);
+
+  // Positioned moves (accelerated, non-blocking)
+  void moveTo(long absolute);
+  void move(long relative);
+
+  // Constant-speed run without ramp (used for homing); runs until stop().
+  // Speed in Q16.16 steps/s, sign gives direction
+  void jog(q16_t speed);
+
+  // Decelerate to a stop (immediate when jogging)
+  void stop();
+
+  // Position and status
+  long distanceToGo() const;
+  long targetPosition() const;
+  long currentPosition() const { return currentPos; }  // Inline - read from ISRs
+  void setCurrentPosition(long position);
+  q16_t speed() const;
+  bool isRunning() const { return running; }
+
+  // Move bookkeeping for MotionHandle: every moveTo() gets a sequence number,
+  // and a move is complete once the axis stops with that (or a later) move
+  uint32_t lastMoveSequence() const { return issuedMoves; }
+  bool isMoveComplete(uint32_t sequence) const {
+    return (int32_t)(completedMoves - sequence) >= 0;
+  }
+
+  // Install the per-step hook (used by the position trigger table)
+  void setStepHook(StepHook hook) { stepHook = hook; }
+
+  // Record how far each step edge lags its timer alarm
+  void setStepErrorHistogram(LatencyHistogram* histogram) { stepErrorHistogram = histogram; }
+
+  // Record motion start and end in the event trace under this axis
+  void setTraceAxis(TraceAxis axis) { traceAxis = (int8_t)axis; }
+
+  // Called from the timer trampoline - do not call directly
+  void handleTimerInterrupt();
+
+ private:
+  // Stepping modes
+  enum AxisMode {
+    AXIS_MODE_POSITION,  // Ramp toward targetPos
+    AXIS_MODE_JOG,       // Fixed interval, fixed direction
+    AXIS_MODE_PROFILE    // Play back a planned or cached interval table
+  };
+
+  // Precomputed fixed move
+  struct CachedMove {
+    long from;
+    long to;
+    MotionProfileType type;
+    q16_t maxSpeed;
+    q16_t acceleration;
+    long jerk;
+    uint16_t* intervals;
+    int32_t rampSteps;
+    uint32_t cruiseInterval;
+  };
+
+  static const uint8_t MAX_CACHED_MOVES = 8;
+
+  const CachedMove* findCachedMove(long from, long to) const;
+  ProfileLimits profileLimits() const;
+
+  bool planProfileMove(long absolute);
+  void handOffProfileLocked();
+  void startLocked();
+  uint32_t nextIntervalLocked();
+  uint32_t nextProfileIntervalLocked();
+  void applyDirectionLocked();
+  void traceMotion(TraceEventType type, long position);
+
+  // Hardware
+  uint8_t stepPin;
+  uint8_t dirPin;
+  uint8_t timerIndex;
+  hw_timer_t* timer;
+  portMUX_TYPE lock;
+  uint32_t minPulseWidth;  // Step pulse high time in timer ticks
+  StepHook stepHook;
+  LatencyHistogram* stepErrorHistogram;
+  int8_t traceAxis;        // TraceAxis, or -1 when not traced
+
+  // Shared between task and ISR (guarded by lock)
+  volatile long currentPos;
+  volatile long targetPos;
+  volatile bool running;
+  volatile bool stepPinHigh;
+  volatile uint32_t issuedMoves;
+  volatile uint32_t completedMoves;
+  AxisMode mode;
+  StepRamp ramp;
+  int8_t pinDirection;     // Direction currently on the DIR pin
+  int8_t jogDirection;
+  uint32_t jogInterval;    // Fixed point ticks
+  uint32_t jogRemainder;
+  q16_t maxSpeed;
+  q16_t acceleration;
+
+  // Table playback: the acceleration half of the move is stored once and
+  // read backwards for the deceleration half
+  MotionProfileType profileType;
+  long jerk;
+  uint16_t planTable[MAX_PROFILE_RAMP_STEPS];  // S-curve ramp planned at moveTo() off the motion task
+  CachedMove cachedMoves[MAX_CACHED_MOVES];
+  uint8_t cachedMoveCount;
+  const uint16_t* profileTable;  // Ramp intervals in ticks (planTable or a cached move)
+  int32_t profileRampSteps;  // Entries used in profileTable
+  int32_t profileSteps;      // Total steps in the move
+  int32_t profileStep;       // Steps issued so far
+  int8_t profileDirection;
+  uint32_t profileCruise;    // Fixed point ticks
+  uint32_t profileRemainder;
+  uint32_t profileInterval;  // Last interval issued, for handing off to the ramp
+};
+
+#endif  // STEPPER_AXIS_H
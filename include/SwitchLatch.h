@@ -0,0 +1,57 @@
+#ifndef SWITCH_LATCH_H
+#define SWITCH_LATCH_H
+
+#include <Arduino.h>
+#include <Bounce2.h>
+#include "StepperAxis.h"
+
+//* ************************************************************************
+//* ************************ SWITCH LATCH ***************************
+//* ************************************************************************
+// Captures an axis position on a switch edge. A GPIO interrupt on the
+// switch pin records the axis step count the moment the switch closes, so
+// the reference does not depend on debounce time or on how quickly the
+// loop notices the switch. update() then qualifies the capture on the
+// motion task, as TriggerCapture does: the debounced switch must still
+// read HIGH HOME_SWITCH_CONFIRM_MS after the edge, or the edge is counted
+// as a glitch and the latch re-arms for the next one. The latch is
+// one-shot: arm() it before each approach and read it once isLatched()
+// turns true.
+
+class SwitchLatch {
+ public:
+  SwitchLatch();
+
+  // Attach the edge interrupt (switch active HIGH, call from setup).
+  // The debouncer is the same switch's Bounce, updated on the motion task.
+  void begin(uint8_t pin, Bounce& debounced, StepperAxis& axis);
+
+  // Confirm or reject a captured edge (motion task, after the debouncers)
+  void update();
+
+  // Clear any previous capture and wait for the next rising edge
+  void arm();
+
+  // Stop capturing edges and drop an unconfirmed capture
+  void disarm();
+
+  bool isLatched() const { return latched; }
+  bool isConfirming() const { return captured && !latched; }  // Edge seen, not yet qualified
+  long latchedPosition() const { return position; }
+  unsigned long getGlitchCount() const { return glitchCount; }  // Edges rejected since boot
+
+ private:
+  static void handleEdge(void* context);
+
+  StepperAxis* axis;
+  Bounce* debounced;
+  uint8_t pin;
+  volatile bool armed;
+  volatile bool captured;  // Edge recorded by the ISR, awaiting update()
+  volatile long position;
+  volatile unsigned long edgeMicros;
+  bool latched;  // Confirmed (motion task only)
+  unsigned long glitchCount;
+};
+
+#endif  // SWITCH_LATCH_H
@@ -0,0 +1,78 @@
+#ifndef TASK_MANAGER_H
+#define TASK_MANAGER_H
+
+#include <Arduino.h>
+#include "../src/Config/Config.h"
+
+//* ************************************************************************
+//* ************************ TASK MANAGER ***************************
+//* ************************************************************************
+// Splits the firmware into two pinned FreeRTOS tasks:
+//   - Motion task (MOTION_TASK_CORE, high priority): debouncers, motion
+//     completions, position triggers and the pick cycle state machine. The
+//     step timer and switch latch interrupts are attached from setup() on
+//     the same core.
+//   - Comms task (COMMS_TASK_CORE, the WiFi core): OTA and Serial input.
+//     The log drain task (Logger.h) runs on the same core.
+// The tasks only share data through these handoff points:
+//   - Command queue (comms -> motion): complete Serial command lines
+//   - Log rings (motion -> log drain): binary log records
+//   - Motion snapshot (motion -> comms): seqlock-protected state copy
+// All three are lock-free, so the motion task never waits on the comms core.
+// The event trace (EventTrace.h) is the one exception: the comms task takes
+// its spinlock for a few instructions to pause, clear or report it.
+
+// CPU time accounting for one task
+struct TaskStats {
+  const char* name;
+  uint32_t periodMicros;       // Scheduled period
+  uint32_t runs;               // Periods executed
+  uint64_t busyMicros;         // Total time spent working
+  uint32_t lastRunMicros;
+  uint32_t maxRunMicros;
+  uint32_t maxLatenessMicros;  // Worst wake-up delay past the scheduled start
+  uint32_t deadlineMisses;     // Periods where lateness + run time exceeded the period
+};
+
+// Motion state published once per motion period for the comms side
+struct MotionSnapshot {
+  uint32_t sequence;           // Motion periods since start
+  long xPosition;
+  long zPosition;
+  q16_t xSpeed;
+  q16_t zSpeed;
+  float servoPosition;
+  PickCycleState pickCycleState;
+  bool vacuumOn;
+  bool xHomeSwitch;            // Debounced switch readings
+  bool zHomeSwitch;
+};
+
+// Create both tasks (call once at the end of setup)
+void startTasks();
+
+// True when called from the motion task
+bool isMotionTask();
+
+// Longest command line, including the terminator
+const size_t COMMAND_LINE_LENGTH = 64;
+
+// Comms -> motion: queue a Serial command line (false if the queue is full)
+bool queueCommand(const char* command);
+
+// Any task: request an emergency stop. This sets a flag rather than
+// queueing a line, so it cannot be dropped; the motion task stops at its
+// next tick and discards commands still queued.
+void requestEmergencyStop();
+
+// Motion task: act on a stop request, then run queued commands through the
+// command table (called from TransferArm::update())
+void processQueuedCommands();
+
+// Comms side: latest consistent motion snapshot (false if none yet)
+bool readMotionSnapshot(MotionSnapshot& snapshot);
+
+// Print per-task CPU time and deadline statistics (comms task)
+void reportTaskStats();
+
+#endif  // TASK_MANAGER_H
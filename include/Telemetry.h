@@ -0,0 +1,81 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ TELEMETRY ***************************
+//* ************************************************************************
+// Binary telemetry for live position/velocity plotting. While a stream is
+// running the motion task takes a fixed-layout TelemetrySample every
+// 1000 / rate ms (up to TELEMETRY_MAX_RATE_HZ) and hands it to the comms
+// task through a lock-free queue. The comms task packs
+// TELEMETRY_BATCH_SAMPLES samples behind one TelemetryPacketHeader and
+// sends them as a single UDP datagram, or sends a partial batch once the
+// oldest sample is TELEMETRY_MAX_BATCH_MS old.
+//
+// UDP rather than the dashboard WebSocket: a lost packet costs 50 ms of
+// plot instead of stalling the stream behind a retransmit, and the JSON
+// dashboard never sees binary frames.
+//
+// Packets are little-endian. A receiver detects lost packets from gaps
+// in sequence and samples lost on the controller from dropped.
+// tools/telemetry_to_csv.py receives the stream and writes CSV.
+//
+//   telemetry                           Show stream state and counters
+//   telemetry <ip> [port] [rate Hz]     Stream to a host
+//   telemetry off                       Stop streaming
+
+const uint32_t TELEMETRY_MAGIC = 0x31544154;  // "TAT1" on the wire
+const uint8_t TELEMETRY_VERSION = 1;
+const uint16_t TELEMETRY_BATCH_SAMPLES = 25;  // Samples per full packet
+
+// Output bits in TelemetrySample::outputs
+enum TelemetryOutput {
+  TELEMETRY_OUTPUT_VACUUM = 0,
+  TELEMETRY_OUTPUT_STAGE2_SIGNAL = 1
+};
+
+// Packet header (16 bytes)
+struct TelemetryPacketHeader {
+  uint32_t magic;        // TELEMETRY_MAGIC
+  uint8_t version;       // TELEMETRY_VERSION
+  uint8_t sampleSize;    // sizeof(TelemetrySample), so old decoders can skip new fields
+  uint16_t sampleCount;  // Samples following the header
+  uint32_t sequence;     // Packet number since the stream started
+  uint32_t dropped;      // Samples lost on the controller since the stream started
+};
+
+// One sample (24 bytes)
+struct TelemetrySample {
+  uint32_t timestamp;   // micros() (wraps every 71 minutes)
+  int32_t xPosition;    // Steps
+  int32_t zPosition;    // Steps
+  int16_t xSpeed;       // Commanded speed in steps/s
+  int16_t zSpeed;       // Commanded speed in steps/s
+  int16_t servoAngle;   // Hundredths of a degree
+  uint8_t outputs;      // Bit n = TelemetryOutput n
+  uint8_t inputs;       // Debounced inputs, bit n = TraceInput n
+  uint8_t phase;        // Main state << 4 | sub-state (see getPickCyclePhase())
+  uint8_t reserved[3];
+};
+
+static_assert(sizeof(TelemetryPacketHeader) == 16, "Telemetry header layout is part of the wire format");
+static_assert(sizeof(TelemetrySample) == 24, "Telemetry sample layout is part of the wire format");
+
+// Motion task: take a sample if streaming and one is due (call every period)
+void recordTelemetrySample();
+
+// Comms task: send full or aged batches (call every period)
+void updateTelemetry();
+
+// Comms task: start streaming to a host; false if the rate is out of range
+bool startTelemetry(const IPAddress& host, uint16_t port, uint32_t rateHz);
+
+// Comms task: stop streaming
+void stopTelemetry();
+
+// Print stream state and counters
+void reportTelemetry();
+
+#endif  // TELEMETRY_H
@@ -0,0 +1,50 @@
+#ifndef TRACE_STORE_H
+#define TRACE_STORE_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ TRACE STORE ***************************
+//* ************************************************************************
+// Long-duration machine history in PSRAM. The motion task appends one
+// compact 10-byte sample (axis positions, commanded speeds, debounced
+// inputs and cycle phase) to two circular tiers:
+//   - fine:   every TRACE_STORE_FINE_PERIOD_MS (1 kHz) - the last minutes
+//   - coarse: every TRACE_STORE_COARSE_PERIOD_MS (10 Hz) - the last hours
+// Samples carry no timestamp: a tier holds exactly one sample per period
+// (a late motion task repeats the latest sample to fill the gap), so the
+// time of any sample follows from its index. The oldest samples are
+// overwritten once a tier is full.
+//
+// The comms task answers time-window queries ('history ...') from
+// whichever tier still covers the window, reading lock-free while the
+// motion task keeps writing.
+
+// One stored sample
+struct HistorySample {
+  int16_t xPosition;  // Steps
+  int16_t zPosition;  // Steps
+  int16_t xSpeed;     // Commanded speed in steps/s
+  int16_t zSpeed;     // Commanded speed in steps/s
+  uint8_t inputs;     // Debounced inputs, bit n = TraceInput n
+  uint8_t phase;      // Main state << 4 | sub-state (see getPickCyclePhase())
+};
+
+// Allocate both tiers in PSRAM (call once before the motion task starts).
+// The store stays disabled if PSRAM is missing or too small.
+bool beginTraceStore();
+
+// Motion task: record the current state if a sample is due
+void recordTraceStoreSample();
+
+// Motion task: debounced inputs, bit n = TraceInput n (shared with Telemetry.h)
+uint8_t readTraceInputs();
+
+// Print tier sizes, rates and the time span each one covers
+void reportTraceStore();
+
+// Print durationSeconds of samples as CSV, starting secondsAgo seconds
+// back, one line every stepMs (0 = every stored sample). Comms task.
+void queryTraceStore(uint32_t secondsAgo, uint32_t durationSeconds, uint32_t stepMs);
+
+#endif  // TRACE_STORE_H
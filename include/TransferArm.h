@@ -1,13 +1,14 @@
 #ifndef TRANSFER_ARM_H
 #define TRANSFER_ARM_H
 
-#include <AccelStepper.h>
 #include <Bounce2.h>
 #include <ESP32Servo.h>
 
 // Include our config files
 #include "../src/Config/Config.h"
 #include "../src/Config/Pins_Definitions.h"
+#include "StepperAxis.h"
+#include "SwitchLatch.h"
 
 //* ************************************************************************
 //* ************************ TRANSFER ARM CLASS *************************
@@ -19,10 +20,11 @@
 class TransferArm {
  private:
   // Hardware instances
-  AccelStepper xStepper;
-  AccelStepper zStepper;
+  StepperAxis xStepper;
+  StepperAxis zStepper;
   Servo gripperServo;
   float currentServoPosition;  // Track servo position since ESP32Servo doesn't have read()
+  unsigned long servoCommandTime;  // millis() when the servo was last commanded
 
   // Bounce objects for debouncing
   Bounce xHomeSwitch;
@@ -31,6 +33,10 @@ class TransferArm {
   Bounce stage1Signal;
   Bounce stopSignalStage2;
 
+  // Home switch edge capture
+  SwitchLatch xHomeLatch;
+  SwitchLatch zHomeLatch;
+
   // Private hardware configuration methods
   void configurePins();
   void configureDebouncers();
@@ -46,11 +52,13 @@ class TransferArm {
   void update();
 
   // Getter methods for accessing hardware (needed by other modules)
-  AccelStepper& getXStepper() { return xStepper; }
-  AccelStepper& getZStepper() { return zStepper; }
+  StepperAxis& getXStepper() { return xStepper; }
+  StepperAxis& getZStepper() { return zStepper; }
   Servo& getGripperServo() { return gripperServo; }
   Bounce& getXHomeSwitch() { return xHomeSwitch; }
   Bounce& getZHomeSwitch() { return zHomeSwitch; }
+  SwitchLatch& getXHomeLatch() { return xHomeLatch; }
+  SwitchLatch& getZHomeLatch() { return zHomeLatch; }
   Bounce& getStartButton() { return startButton; }
   Bounce& getStage1Signal() { return stage1Signal; }
   Bounce& getStopSignalStage2() { return stopSignalStage2; }
@@ -58,6 +66,7 @@ class TransferArm {
   // Servo control methods
   void setServoPosition(float position);
   float getServoPosition() const { return currentServoPosition; }
+  unsigned long getServoCommandTime() const { return servoCommandTime; }
 
   // Status methods
   bool isXMoving() { return xStepper.isRunning(); }
@@ -72,8 +81,6 @@ class TransferArm {
   void disableXMotor();
 
   // Communication methods
-  void handleSerialCommand(const String& command);
-  void sendSerialMessage(const String& message);
   void sendBurstRequest();
 };
 
@@ -0,0 +1,68 @@
+#ifndef TRIGGER_CAPTURE_H
+#define TRIGGER_CAPTURE_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ TRIGGER CAPTURE ***************************
+//* ************************************************************************
+// Edge-triggered pick cycle triggers. GPIO interrupts on the start button
+// and the Stage 1 signal timestamp every rising edge, so a trigger that
+// arrives while a cycle is running is queued instead of lost, and one that
+// arrives at idle is seen on the next motion period instead of after the
+// debounce interval.
+//
+//   - ISR: edges closer than TRIGGER_CONFIRM_MS to the previous edge on the
+//     same input are contact bounce and ignored; the rest go into a small
+//     lock-free queue (ISR -> motion task).
+//   - updateTriggerCapture() (motion task, every period): an edge is
+//     confirmed once the input still reads HIGH TRIGGER_CONFIRM_MS after
+//     it, which rejects noise spikes. Confirmed triggers wait in the
+//     pending queue.
+//   - takeTrigger() (idle state): oldest pending trigger. Triggers older
+//     than TRIGGER_MAX_AGE_MS are discarded rather than starting a cycle
+//     long after the part arrived.
+//
+// The time from the edge to the first axis motion of the cycle it starts
+// is recorded in the LATENCY_TRIGGER_TO_MOTION histogram.
+
+enum TriggerSource {
+  TRIGGER_SOURCE_START_BUTTON,
+  TRIGGER_SOURCE_STAGE1
+};
+
+// One captured rising edge
+struct CapturedTrigger {
+  uint32_t timestamp;  // micros() at the edge
+  uint8_t source;      // TriggerSource
+};
+
+// Trigger counters since boot
+struct TriggerCaptureStats {
+  uint32_t captured;   // Confirmed triggers
+  uint32_t bounces;    // Edges ignored as contact bounce
+  uint32_t glitches;   // Edges rejected because the input was LOW again
+  uint32_t dropped;    // Triggers lost because a queue was full
+  uint32_t expired;    // Pending triggers discarded as too old
+  uint32_t pending;    // Edges captured but not yet taken by the idle state
+};
+
+// Attach the edge interrupts (call from setup, after the pins are configured)
+void beginTriggerCapture();
+
+// Motion task: confirm captured edges (call every period)
+void updateTriggerCapture();
+
+// Motion task: take the oldest pending trigger; false if there is none
+bool takeTrigger(CapturedTrigger& trigger);
+
+// Motion task: record trigger-to-motion latency once an axis starts moving
+// for the cycle started by the last trigger taken (call every period)
+void updateTriggerLatency(bool axisMoving);
+
+// Motion task: drop every captured and pending trigger (emergency stop)
+void discardPendingTriggers();
+
+TriggerCaptureStats getTriggerCaptureStats();
+
+#endif  // TRIGGER_CAPTURE_H
@@ -1,8 +1,9 @@
 #ifndef UTILS_H
 #define UTILS_H
 
-#include <AccelStepper.h>
 #include <Arduino.h>
+#include "MotionHandle.h"
+#include "Logger.h"
 #include "../src/Config/Config.h"
 
 //* ************************************************************************
@@ -11,7 +12,6 @@
 // This file contains declarations for all utility functions used throughout the Transfer Arm system.
 
 // Movement functions
-bool moveToPosition(AccelStepper& stepper, float position);
 void activateVacuum();
 void deactivateVacuum();
 
@@ -25,21 +25,27 @@ void setServoTravel();
 void setServoDropoff();
 void setServoHome();
 
-// Axis control functions
+// Axis control functions (non-blocking - poll the returned handle)
 void setZAxisNormalSpeed();
 void setZAxisDropoffSpeed();
-void moveZToPickup();
-void moveZToUp();
-void moveZToDropoff();
-void moveXToPickup();
-void moveXToDropoff();
-void moveXToDropoffOvershoot();
-void homeXAxis();
+MotionHandle moveZToPickup();
+MotionHandle moveZToUp();
+MotionHandle moveZToDropoff();
+MotionHandle moveXToPickup();
+MotionHandle moveXToDropoff();
+MotionHandle moveXToDropoffOvershoot();
+MotionHandle moveXToHome();
+
+// Profile functions
+void cacheProductionMoves();
+void reportProfileMoveTimes();
 
 // Status functions
 bool isZAxisAtTarget();
 bool isXAxisAtTarget();
 bool isZAtSuctionStart();
+bool stage2AllowsZLowering();
+long getTransportXTarget();
 
 // State functions
 const char* getStateString(PickCycleState state);
@@ -47,7 +53,9 @@ const char* getStateString(PickCycleState state);
 // Signal functions
 void signalStage2();
 
-// Logging functions
-void smartLog(const String& message);
+// Output functions - printf to Serial through a stack buffer (Serial.printf
+// allocates for long lines); output past SERIAL_PRINTF_BUFFER is truncated
+const size_t SERIAL_PRINTF_BUFFER = 256;
+void serialPrintf(const char* format, ...) __attribute__((format(printf, 1, 2)));
 
 #endif  // UTILS_H
\ No newline at end of file
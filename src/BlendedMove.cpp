@@ -0,0 +1,140 @@
+#include "../include/BlendedMove.h"
+#include "Config/Config.h"
+#include "../include/TransferArm.h"
+#include "../include/Utils.h"
+
+//* ************************************************************************
+//* ************************ BLENDED X/Z MOVES ***************************
+//* ************************************************************************
+// Single planner instance driving both axes. Handles compare their id with
+// the active path id; a replaced path reports every phase as finished.
+
+// Active path
+static uint32_t activePathId = 0;
+static BlendPhase activePhase = BLEND_IDLE;
+static long pathXTarget = 0;
+static long pathZLift = 0;
+static long pathZFinal = 0;
+static BlendGate pathDescentGate = nullptr;
+static MotionHandle pathXMotion;
+static MotionHandle pathZMotion;
+
+// Polling wait on the descent gate (Stage 2 safety signal)
+static LogThrottle descentGateWait(LOG_LEVEL_INFO, "Blended move: waiting for descent gate before Z lowering");
+static bool descentGateWaiting = false;  // Tracked here - the throttle skips levels below the log level
+
+//* ************************************************************************
+//* ************************ PATH HANDLE ***************************
+//* ************************************************************************
+
+BlendPhase BlendedPath::phase() const {
+  if (id == 0) return BLEND_IDLE;
+  if (id != activePathId) return BLEND_DONE;  // Replaced by a newer path
+  return activePhase;
+}
+
+bool BlendedPath::isXReleased() const {
+  return phase() >= BLEND_TRAVEL;
+}
+
+bool BlendedPath::isDescending() const {
+  return phase() >= BLEND_DESCEND;
+}
+
+bool BlendedPath::isDone() const {
+  return phase() == BLEND_DONE;
+}
+
+//* ************************************************************************
+//* ************************ PLANNER ***************************
+//* ************************************************************************
+
+// Start a blended move along Z lift -> X travel -> Z final
+BlendedPath startBlendedMove(long xTarget, long zLift, long zFinal, BlendGate descentGate) {
+  activePathId++;
+  if (activePathId == 0) activePathId = 1;  // 0 is reserved for idle handles
+
+  pathXTarget = xTarget;
+  pathZLift = zLift;
+  pathZFinal = zFinal;
+  pathDescentGate = descentGate;
+  pathXMotion.reset();
+
+  LOG_DEBUG("Blended move: X -> %ld, Z lift %ld, Z final %ld", xTarget, zLift, zFinal);
+
+  //! Step 1: Z to lift height
+  pathZMotion = moveAxisTo(transferArm.getZStepper(), zLift);
+  activePhase = BLEND_LIFT;
+  descentGateWaiting = false;
+  updateBlendedMove();
+
+  BlendedPath path;
+  path.id = activePathId;
+  return path;
+}
+
+// Advance the planner
+void updateBlendedMove() {
+  StepperAxis& xAxis = transferArm.getXStepper();
+  StepperAxis& zAxis = transferArm.getZStepper();
+
+  switch (activePhase) {
+    case BLEND_LIFT:
+      // X may leave once Z is inside the clearance envelope
+      if (pathZMotion.isDone() ||
+          labs(zAxis.currentPosition() - pathZLift) <= Z_BLEND_CLEARANCE_POS) {
+        //! Step 2: X travel
+        LOG_DEBUG("Blended move: Z clear at %ld, starting X", zAxis.currentPosition());
+        pathXMotion = moveAxisTo(xAxis, pathXTarget);
+        activePhase = BLEND_TRAVEL;
+      }
+      break;
+
+    case BLEND_TRAVEL:
+      if (pathZFinal == pathZLift) {
+        // No final Z move on this path
+        if (pathXMotion.isDone() && pathZMotion.isDone()) {
+          activePhase = BLEND_DONE;
+        }
+        break;
+      }
+
+      // Z may start its final move once lifted and X is inside the blend window
+      if (!pathZMotion.isDone() ||
+          !(pathXMotion.isDone() || labs(xAxis.currentPosition() - pathXTarget) <= X_BLEND_WINDOW_POS)) {
+        break;
+      }
+      if (pathDescentGate != nullptr && !pathDescentGate()) {
+        descentGateWait.hit();
+        descentGateWaiting = true;
+      } else {
+        descentGateWait.clear();
+        descentGateWaiting = false;
+        //! Step 3: Z to final height
+        LOG_DEBUG("Blended move: X within window at %ld, starting Z", xAxis.currentPosition());
+        pathZMotion = moveAxisTo(zAxis, pathZFinal);
+        activePhase = BLEND_DESCEND;
+      }
+      break;
+
+    case BLEND_DESCEND:
+      if (pathXMotion.isDone() && pathZMotion.isDone()) {
+        activePhase = BLEND_DONE;
+      }
+      break;
+
+    case BLEND_IDLE:
+    case BLEND_DONE:
+      break;
+  }
+}
+
+// Current planner phase
+BlendPhase getBlendPhase() {
+  return activePhase;
+}
+
+// True while Z is held back only by the descent gate
+bool isWaitingForDescentGate() {
+  return activePhase == BLEND_TRAVEL && descentGateWaiting;
+}
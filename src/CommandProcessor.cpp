@@ -0,0 +1,582 @@
+#include "../include/CommandProcessor.h"
+#include "../include/TransferArm.h"
+#include "../include/PickCycle.h"
+#include "../include/TaskManager.h"
+#include "../include/Utils.h"
+#include "../include/Homing.h"
+#include "../include/ReferenceCheck.h"
+#include "../include/TriggerCapture.h"
+#include "../include/LatencyStats.h"
+#include "../include/CycleProfiler.h"
+#include "../include/EventTrace.h"
+#include "../include/TraceStore.h"
+#include "../include/HeapAudit.h"
+#include "../include/ResourceMonitor.h"
+#include "../include/Telemetry.h"
+#include "../include/ConfigSettings.h"
+#include "../include/FixedPoint.h"
+#include "Config/Config.h"
+#include <stdlib.h>
+
+//* ************************************************************************
+//* ************************ ARGUMENT PARSING ***************************
+//* ************************************************************************
+
+// Split off the next space-separated word (terminated in place); nullptr
+// once the line is used up
+static char* nextArgument(char*& cursor) {
+  while (*cursor == ' ') cursor++;
+  if (*cursor == '\0') {
+    return nullptr;
+  }
+  char* start = cursor;
+  while (*cursor != '\0' && *cursor != ' ') cursor++;
+  if (*cursor == ' ') {
+    *cursor++ = '\0';
+  }
+  return start;
+}
+
+// Whole-word number parsers; false on trailing junk
+static bool parseLong(const char* text, long& value) {
+  char* end = nullptr;
+  value = strtol(text, &end, 10);
+  return text != nullptr && end != text && *end == '\0';
+}
+
+static bool parseFloat(const char* text, float& value) {
+  char* end = nullptr;
+  value = strtof(text, &end);
+  return text != nullptr && end != text && *end == '\0';
+}
+
+// "x" or "z" -> axis, with the span the cycle itself uses as soft limits
+struct ManualAxis {
+  StepperAxis* axis;
+  const char* name;
+  long minimum;
+  long maximum;
+};
+
+static bool parseAxis(const char* text, ManualAxis& manual) {
+  if (text == nullptr) {
+    return false;
+  }
+  if (strcmp(text, "x") == 0) {
+    manual.axis = &transferArm.getXStepper();
+    manual.name = "X";
+    manual.minimum = min(min(X_HOME_POS, X_PICKUP_POS), min(X_DROPOFF_POS, X_DROPOFF_OVERSHOOT_POS));
+    manual.maximum = max(max(X_HOME_POS, X_PICKUP_POS), max(X_DROPOFF_POS, X_DROPOFF_OVERSHOOT_POS));
+    return true;
+  }
+  if (strcmp(text, "z") == 0) {
+    manual.axis = &transferArm.getZStepper();
+    manual.name = "Z";
+    manual.minimum = min(min(Z_HOME_POS, Z_UP_POS), min(Z_PICKUP_POS, Z_DROPOFF_POS));
+    manual.maximum = max(max(Z_HOME_POS, Z_UP_POS), max(Z_PICKUP_POS, Z_DROPOFF_POS));
+    return true;
+  }
+  return false;
+}
+
+// Manual outputs and moves only while homed, idle and stopped
+static bool manualControlAllowed() {
+  if (getXHomingTelemetry().homeCount == 0 || getZHomingTelemetry().homeCount == 0) {
+    LOG_WARN("Home the arm before manual control");
+    return false;
+  }
+  if (isHomingFaulted()) {
+    LOG_WARN("Homing fault - re-home before manual control");
+    return false;
+  }
+  if (!isPickCycleIdle() || transferArm.isAnyMotorMoving()) {
+    LOG_WARN("Manual control only while idle and stopped");
+    return false;
+  }
+  return true;
+}
+
+//* ************************************************************************
+//* ************************ COMMS TASK COMMANDS ***************************
+//* ************************************************************************
+
+static bool printHelp(char* args);
+
+static bool showStatus(char* args) {
+  StepperAxis& xAxis = transferArm.getXStepper();
+  StepperAxis& zAxis = transferArm.getZStepper();
+  Serial.println("Transfer Arm Status:");
+  serialPrintf("X Position: %ld\n", xAxis.currentPosition());
+  serialPrintf("Z Position: %ld\n", zAxis.currentPosition());
+  serialPrintf("Servo Position: %.2f\n", transferArm.getServoPosition());
+  serialPrintf("X Moving: %s\n", transferArm.isXMoving() ? "Yes" : "No");
+  serialPrintf("Z Moving: %s\n", transferArm.isZMoving() ? "Yes" : "No");
+  const HomingTelemetry& xHome = getXHomingTelemetry();
+  const HomingTelemetry& zHome = getZHomingTelemetry();
+  serialPrintf("X Homing: %lu runs, last %lu ms, edge error %ld steps, variance %.2f, %lu switch glitches\n",
+               (unsigned long)xHome.homeCount, (unsigned long)xHome.lastDurationMs, (long)xHome.lastLatchError,
+               getHomingLatchVariance(xHome), (unsigned long)xHome.switchGlitches);
+  serialPrintf("Z Homing: %lu runs, last %lu ms, edge error %ld steps, variance %.2f, %lu switch glitches\n",
+               (unsigned long)zHome.homeCount, (unsigned long)zHome.lastDurationMs, (long)zHome.lastLatchError,
+               getHomingLatchVariance(zHome), (unsigned long)zHome.switchGlitches);
+  if (isHomingFaulted()) {
+    serialPrintf("HOMING FAULT: X %lu, Z %lu failed homings - re-home before running\n",
+                 (unsigned long)xHome.faultCount, (unsigned long)zHome.faultCount);
+  }
+  const DriftTelemetry& drift = getXDriftTelemetry();
+  serialPrintf("X Drift: %lu checks, last %ld steps, max %ld steps, %lu drift re-homes\n",
+               (unsigned long)drift.checks, (long)drift.lastDrift, (long)drift.maxAbsDrift,
+               (unsigned long)drift.rehomes);
+  TriggerCaptureStats triggers = getTriggerCaptureStats();
+  serialPrintf("Triggers: %lu captured, %lu pending, %lu bounces, %lu glitches, %lu dropped, %lu expired\n",
+               (unsigned long)triggers.captured, (unsigned long)triggers.pending, (unsigned long)triggers.bounces,
+               (unsigned long)triggers.glitches, (unsigned long)triggers.dropped, (unsigned long)triggers.expired);
+  ResourceSample resources;
+  if (getResourceSample(resources)) {
+    serialPrintf("Memory: %lu free, largest block %lu, %u%% fragmented, warnings 0x%02x\n",
+                 (unsigned long)resources.freeHeap, (unsigned long)resources.largestFreeBlock,
+                 getFragmentationPercent(resources), getResourceWarnings());
+  }
+  return true;
+}
+
+// Raise the stop flag - it bypasses the command queue, so it is never dropped
+static bool emergencyStop(char* args) {
+  requestEmergencyStop();
+  Serial.println("Emergency stop requested");
+  return true;
+}
+
+static bool showTasks(char* args) {
+  reportTaskStats();
+  return true;
+}
+
+static bool showStats(char* args) {
+  char* action = nextArgument(args);
+  if (action == nullptr) {
+    reportLatencyStats();
+  } else if (strcmp(action, "reset") == 0) {
+    resetLatencyStats();  // Only raises flags - the writers clear their own histograms
+    Serial.println("Latency statistics cleared");
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static bool controlTrace(char* args) {
+  char* action = nextArgument(args);
+  if (action == nullptr) {
+    reportEventTrace();
+  } else if (strcmp(action, "dump") == 0) {
+    dumpEventTrace();
+  } else if (strcmp(action, "on") == 0 || strcmp(action, "off") == 0) {
+    setEventTraceEnabled(strcmp(action, "on") == 0);
+    reportEventTrace();
+  } else if (strcmp(action, "clear") == 0) {
+    clearEventTrace();
+    reportEventTrace();
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static bool showHistory(char* args) {
+  char* secondsAgo = nextArgument(args);
+  if (secondsAgo == nullptr) {
+    reportTraceStore();
+    return true;
+  }
+  char* duration = nextArgument(args);
+  char* step = nextArgument(args);
+  long secondsValue = 0, durationValue = 1, stepValue = 0;
+  if (!parseLong(secondsAgo, secondsValue) || (duration != nullptr && !parseLong(duration, durationValue)) ||
+      (step != nullptr && !parseLong(step, stepValue)) || secondsValue < 0 || durationValue < 0 || stepValue < 0) {
+    return false;
+  }
+  queryTraceStore((uint32_t)secondsValue, (uint32_t)durationValue, (uint32_t)stepValue);
+  return true;
+}
+
+static bool showMemory(char* args) {
+  reportResourceMonitor();
+  return true;
+}
+
+static bool controlTelemetry(char* args) {
+  char* address = nextArgument(args);
+  if (address == nullptr) {
+    reportTelemetry();
+    return true;
+  }
+  if (strcmp(address, "off") == 0) {
+    stopTelemetry();
+    return true;
+  }
+
+  char* portText = nextArgument(args);
+  char* rateText = nextArgument(args);
+  long port = TELEMETRY_DEFAULT_PORT, rateHz = TELEMETRY_DEFAULT_RATE_HZ;
+  IPAddress host;
+  if (!host.fromString(address) || (portText != nullptr && !parseLong(portText, port)) ||
+      (rateText != nullptr && !parseLong(rateText, rateHz)) || port <= 0 || port > 65535 || rateHz <= 0 ||
+      !startTelemetry(host, (uint16_t)port, (uint32_t)rateHz)) {
+    return false;
+  }
+  reportTelemetry();
+  return true;
+}
+
+static bool showPhases(char* args) {
+  reportCycleProfile();
+  return true;
+}
+
+static bool showProfiles(char* args) {
+  reportProfileMoveTimes();
+  return true;
+}
+
+static bool controlHeapAudit(char* args) {
+  char* action = nextArgument(args);
+  if (action == nullptr) {
+    reportHeapAudit();
+  } else if (strcmp(action, "reset") == 0) {
+    resetHeapAudit();
+    Serial.println("Heap audit cleared");
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static bool controlLogLevel(char* args) {
+  char* name = nextArgument(args);
+  if (name != nullptr) {
+    uint8_t level;
+    if (!parseLogLevel(name, &level)) {
+      serialPrintf("Unknown log level: %s\n", name);
+      return false;
+    }
+    setLogLevel(level);
+  }
+  serialPrintf("Log level: %s (compiled minimum %s)\n", getLogLevelName(getLogLevel()),
+               getLogLevelName(LOG_MIN_LEVEL));
+  return true;
+}
+
+// One setting per line: name = value units (read-only)
+static void printConfigSetting(const ConfigSetting& setting) {
+  char value[24];
+  formatConfigSetting(setting, value, sizeof(value));
+  serialPrintf("  %-22s = %s %s%s\n", setting.name, value, setting.units, setting.writable ? "" : " (read-only)");
+}
+
+static bool showConfig(char* args) {
+  char* name = nextArgument(args);
+  if (name != nullptr && strcmp(name, "get") == 0) {
+    name = nextArgument(args);
+  }
+  if (name == nullptr) {
+    Serial.println("Settings:");
+    for (uint8_t i = 0; i < getConfigSettingCount(); i++) {
+      printConfigSetting(getConfigSetting(i));
+    }
+    return true;
+  }
+  const ConfigSetting* setting = findConfigSetting(name);
+  if (setting == nullptr) {
+    serialPrintf("Unknown setting: %s\n", name);
+    return true;
+  }
+  printConfigSetting(*setting);
+  return true;
+}
+
+//* ************************************************************************
+//* ************************ MOTION TASK COMMANDS ***************************
+//* ************************************************************************
+
+static bool startHoming(char* args) {
+  requestHoming();
+  return true;
+}
+
+static bool startCycle(char* args) {
+  triggerPickCycleFromWeb();
+  return true;
+}
+
+static bool resetPhases(char* args) {
+  resetCycleProfile();
+  LOG_INFO("Cycle profile cleared");
+  return true;
+}
+
+// Move one axis to a target within the cycle's span
+static void startManualMove(const ManualAxis& manual, long target) {
+  if (target < manual.minimum || target > manual.maximum) {
+    LOG_WARN("%s target %ld outside %ld..%ld", manual.name, target, manual.minimum, manual.maximum);
+    return;
+  }
+  if (manual.axis == &transferArm.getXStepper()) {
+    transferArm.enableXMotor();  // Stays enabled until the next cycle returns to idle
+  }
+  manual.axis->moveTo(target);
+  LOG_INFO("Moving %s from %ld to %ld", manual.name, manual.axis->currentPosition(), target);
+}
+
+static bool jogAxis(char* args) {
+  ManualAxis manual;
+  long steps = 0;
+  if (!parseAxis(nextArgument(args), manual) || !parseLong(nextArgument(args), steps)) {
+    return false;
+  }
+  if (manualControlAllowed()) {
+    startManualMove(manual, manual.axis->currentPosition() + steps);
+  }
+  return true;
+}
+
+static bool moveAxis(char* args) {
+  ManualAxis manual;
+  float inches = 0;
+  if (!parseAxis(nextArgument(args), manual) || !parseFloat(nextArgument(args), inches)) {
+    return false;
+  }
+  if (manualControlAllowed()) {
+    startManualMove(manual, inchesToSteps(inches, STEPS_PER_INCH));
+  }
+  return true;
+}
+
+static bool moveServo(char* args) {
+  float degrees = 0;
+  if (!parseFloat(nextArgument(args), degrees) || degrees < 0 || degrees > 180) {
+    return false;
+  }
+  if (manualControlAllowed()) {
+    transferArm.setServoPosition(degrees);
+    LOG_INFO("Servo to %.1f degrees", degrees);
+  }
+  return true;
+}
+
+static bool controlVacuum(char* args) {
+  char* state = nextArgument(args);
+  if (state == nullptr || (strcmp(state, "on") != 0 && strcmp(state, "off") != 0)) {
+    return false;
+  }
+  if (manualControlAllowed()) {
+    bool on = (strcmp(state, "on") == 0);
+    if (on) {
+      activateVacuum();
+    } else {
+      deactivateVacuum();
+    }
+    LOG_INFO("Vacuum %s", on ? "on" : "off");  // state points into the released command line
+  }
+  return true;
+}
+
+// Log a setting's new value. The log keeps only argument pointers, so the
+// name and units come from the settings table and the value is logged as a
+// number, never as text from the command line or a stack buffer.
+static void logConfigValue(const ConfigSetting& setting) {
+  switch (setting.type) {
+    case SETTING_FLOAT:
+      LOG_INFO("%s = %.2f %s", setting.name, *(const float*)setting.value, setting.units);
+      break;
+    case SETTING_ULONG:
+      LOG_INFO("%s = %lu %s", setting.name, *(const unsigned long*)setting.value, setting.units);
+      break;
+    case SETTING_Q16:
+      LOG_INFO("%s = %ld %s", setting.name, (long)q16ToInt(*(const q16_t*)setting.value), setting.units);
+      break;
+  }
+}
+
+// Replies name only table entries: the arguments point into a command line
+// that is released before the log drain task formats the record
+static bool setConfig(char* args) {
+  char* name = nextArgument(args);
+  char* value = nextArgument(args);
+  if (name == nullptr || value == nullptr) {
+    return false;
+  }
+  ConfigSetResult result = setConfigSetting(name, value);
+  const ConfigSetting* setting = findConfigSetting(name);
+  switch (result) {
+    case CONFIG_SET_OK:
+      logConfigValue(*setting);
+      break;
+    case CONFIG_SET_UNKNOWN:
+      LOG_WARN("Unknown setting - 'config' lists them");
+      break;
+    case CONFIG_SET_READ_ONLY:
+      LOG_WARN("%s is read-only (compiled into Config.cpp)", setting->name);
+      break;
+    case CONFIG_SET_INVALID:
+      LOG_WARN("%s unchanged - value is not a number", setting->name);
+      break;
+    case CONFIG_SET_OUT_OF_RANGE:
+      LOG_WARN("%s must be %.0f..%.0f %s", setting->name, setting->minimum, setting->maximum, setting->units);
+      break;
+  }
+  return true;
+}
+
+//* ************************************************************************
+//* ************************ COMMAND TABLE ***************************
+//* ************************************************************************
+
+static const SerialCommand COMMANDS[] = {
+    {"status", COMMAND_COMMS, showStatus, "", "Show system status"},
+    {"stop", COMMAND_COMMS, emergencyStop, "", "Emergency stop: halt both axes, release the vacuum, return to idle"},
+    {"home", COMMAND_MOTION, startHoming, "", "Start homing sequence"},
+    {"cycle", COMMAND_MOTION, startCycle, "", "Trigger pick cycle"},
+    {"jog", COMMAND_MOTION, jogAxis, "<x|z> <steps>", "Move an axis by a number of steps (idle only)"},
+    {"move", COMMAND_MOTION, moveAxis, "<x|z> <inches>", "Move an axis to a position (idle only)"},
+    {"servo", COMMAND_MOTION, moveServo, "<degrees>", "Turn the servo (idle only)"},
+    {"vacuum", COMMAND_MOTION, controlVacuum, "<on|off>", "Switch the vacuum (idle only)"},
+    {"config", COMMAND_COMMS, showConfig, "[get] [name]", "Show settings"},
+    {"config set", COMMAND_MOTION, setConfig, "<name> <value>", "Change a setting until the next reboot"},
+    {"profiles", COMMAND_COMMS, showProfiles, "", "Compare trapezoid and S-curve move times"},
+    {"phases", COMMAND_COMMS, showPhases, "", "Show the per-phase cycle time breakdown"},
+    {"phases reset", COMMAND_MOTION, resetPhases, "", "Clear the per-phase cycle time breakdown"},
+    {"trace", COMMAND_COMMS, controlTrace, "[on|off|clear|dump]", "Control the event trace or stream it for tools/trace_to_chrome.py"},
+    {"history", COMMAND_COMMS, showHistory, "[seconds ago] [duration s] [step ms]", "Show the PSRAM trace store or print a time window"},
+    {"telemetry", COMMAND_COMMS, controlTelemetry, "[<ip> [port] [rate Hz] | off]", "Stream samples over UDP (telemetry_to_csv.py)"},
+    {"heap", COMMAND_COMMS, controlHeapAudit, "[reset]", "Show or clear allocations made during cycles (heap audit build)"},
+    {"mem", COMMAND_COMMS, showMemory, "", "Show heap, fragmentation and stack headroom with their history"},
+    {"tasks", COMMAND_COMMS, showTasks, "", "Show per-task CPU time and deadline misses"},
+    {"stats", COMMAND_COMMS, showStats, "[reset]", "Show or clear loop, subsystem and step timing histograms"},
+    {"log", COMMAND_COMMS, controlLogLevel, "[trace|debug|info|warn|error|none]", "Show or set the log level"},
+    {"help", COMMAND_COMMS, printHelp, "", "Show this help"},
+};
+static const uint8_t COMMAND_COUNT = sizeof(COMMANDS) / sizeof(COMMANDS[0]);
+
+static bool printHelp(char* args) {
+  Serial.println("Available commands:");
+  for (uint8_t i = 0; i < COMMAND_COUNT; i++) {
+    const SerialCommand& command = COMMANDS[i];
+    serialPrintf("  %s%s%s - %s\n", command.name, command.usage[0] != '\0' ? " " : "", command.usage, command.help);
+  }
+  return true;
+}
+
+//* ************************************************************************
+//* ************************ DISPATCH ***************************
+//* ************************************************************************
+
+// Longest command name matching the start of the line at a word boundary;
+// args points past it
+static const SerialCommand* findCommand(char* line, char*& args) {
+  const SerialCommand* found = nullptr;
+  size_t foundLength = 0;
+  for (uint8_t i = 0; i < COMMAND_COUNT; i++) {
+    size_t length = strlen(COMMANDS[i].name);
+    if (length > foundLength && strncmp(line, COMMANDS[i].name, length) == 0 &&
+        (line[length] == '\0' || line[length] == ' ')) {
+      found = &COMMANDS[i];
+      foundLength = length;
+    }
+  }
+  args = line + foundLength;
+  return found;
+}
+
+// Motion task replies go through the log ring; only the comms task
+// writes to Serial directly
+static void runCommand(const SerialCommand& command, char* args) {
+  if (command.handler(args)) {
+    return;
+  }
+  if (command.context == COMMAND_MOTION) {
+    LOG_WARN("Usage: %s %s", command.name, command.usage);
+  } else {
+    serialPrintf("Usage: %s %s\n", command.name, command.usage);
+  }
+}
+
+// Trim the ends and collapse runs of spaces and tabs to one space (in place)
+static void normalizeLine(char* line) {
+  char* out = line;
+  bool space = true;  // Drops leading blanks
+  for (char* in = line; *in != '\0'; in++) {
+    if (*in == ' ' || *in == '\t') {
+      if (!space) *out++ = ' ';
+      space = true;
+    } else {
+      *out++ = *in;
+      space = false;
+    }
+  }
+  if (out > line && out[-1] == ' ') out--;
+  *out = '\0';
+}
+
+// Run or queue one command line
+void submitCommandLine(char* line) {
+  normalizeLine(line);
+  if (line[0] == '\0') {
+    return;
+  }
+
+  char* args = nullptr;
+  const SerialCommand* command = findCommand(line, args);
+  if (command == nullptr) {
+    serialPrintf("Unknown command: %s\n", line);
+    Serial.println("Type 'help' for available commands");
+  } else if (command->context == COMMAND_COMMS) {
+    runCommand(*command, args);
+  } else if (!queueCommand(line)) {
+    serialPrintf("Command queue full, dropped: %s\n", line);
+  }
+}
+
+// Motion task: run a line queued by submitCommandLine()
+void runQueuedCommand(char* line) {
+  char* args = nullptr;
+  const SerialCommand* command = findCommand(line, args);
+  if (command != nullptr) {
+    runCommand(*command, args);
+  }
+}
+
+//* ************************************************************************
+//* ************************ LINE ASSEMBLER ***************************
+//* ************************************************************************
+
+static char lineBuffer[COMMAND_LINE_LENGTH];
+static size_t lineLength = 0;
+static bool lineOverflow = false;  // Rest of an over-long line is discarded
+
+// Read available Serial bytes and run complete lines (never blocks)
+void pollSerialCommands() {
+  int available = Serial.available();
+  while (available-- > 0) {
+    int c = Serial.read();
+    if (c < 0) {
+      break;
+    }
+    if (c == '\n' || c == '\r') {
+      if (lineOverflow) {
+        serialPrintf("Command too long (max %u characters)\n", (unsigned)(COMMAND_LINE_LENGTH - 1));
+      } else if (lineLength > 0) {
+        lineBuffer[lineLength] = '\0';
+        submitCommandLine(lineBuffer);
+      }
+      lineLength = 0;
+      lineOverflow = false;
+    } else if (c == '\b' || c == 0x7F) {
+      if (lineLength > 0) lineLength--;  // Backspace from a terminal
+    } else if (lineLength < COMMAND_LINE_LENGTH - 1) {
+      lineBuffer[lineLength++] = (char)c;
+    } else {
+      lineOverflow = true;
+    }
+  }
+}
@@ -16,8 +16,8 @@ const float STEPS_PER_MM = STEPS_PER_REV / (PULLEY_TEETH * BELT_PITCH);  // Step
 const float STEPS_PER_INCH = STEPS_PER_MM * 25.4;  // Convert to steps per inch
 
 // Positions
-const float X_HOME_POS = 0.0;  // X-axis home position (in steps)
-const float Z_HOME_POS = 0.0;  // Z-axis home position (in steps)
+const long X_HOME_POS = 0;  // X-axis home position (in steps)
+const long Z_HOME_POS = 0;  // Z-axis home position (in steps)
 
 // X-axis positions in inches from home
 const float X_PICKUP_POS_INCHES = 1.0;      // X-axis pickup position (1 inch)
@@ -31,35 +31,133 @@ const float Z_PICKUP_LOWER_INCHES = 7.0;   // Lower Z-axis by 5 inches for picku
 const float Z_SUCTION_START_INCHES = 4.0;  // Start suction when Z is 4 inches down
 const float Z_DROPOFF_LOWER_INCHES = 5.5;  // Lower Z-axis by 5.5 inches for dropoff
 
-// Converted positions to steps
-const float X_PICKUP_POS = X_PICKUP_POS_INCHES * STEPS_PER_INCH;
-const float X_DROPOFF_POS = X_DROPOFF_POS_INCHES * STEPS_PER_INCH;
-const float X_DROPOFF_OVERSHOOT_POS = X_DROPOFF_OVERSHOOT_INCHES * STEPS_PER_INCH;  // Overshoot position in steps
-const float X_SERVO_ROTATE_POS = X_SERVO_ROTATE_INCHES * STEPS_PER_INCH;  // Position to start servo rotation for dropoff
-const float X_MIDPOINT_POS = X_MIDPOINT_INCHES * STEPS_PER_INCH;  // Kept for reference
+// Converted positions in whole steps (rounded once here)
+const long X_PICKUP_POS = inchesToSteps(X_PICKUP_POS_INCHES, STEPS_PER_INCH);
+const long X_DROPOFF_POS = inchesToSteps(X_DROPOFF_POS_INCHES, STEPS_PER_INCH);
+const long X_DROPOFF_OVERSHOOT_POS = inchesToSteps(X_DROPOFF_OVERSHOOT_INCHES, STEPS_PER_INCH);  // Overshoot position in steps
+const long X_SERVO_ROTATE_POS = inchesToSteps(X_SERVO_ROTATE_INCHES, STEPS_PER_INCH);  // Position to start servo rotation for dropoff
+const long X_MIDPOINT_POS = inchesToSteps(X_MIDPOINT_INCHES, STEPS_PER_INCH);  // Kept for reference
 
-const float Z_UP_POS = 0.0;  // Z-axis fully up position
-const float Z_PICKUP_POS = Z_PICKUP_LOWER_INCHES * STEPS_PER_INCH;  // Z-axis down position for pickup
-const float Z_SUCTION_START_POS = Z_SUCTION_START_INCHES * STEPS_PER_INCH;  // Z position to start suction
-const float Z_DROPOFF_POS = Z_DROPOFF_LOWER_INCHES * STEPS_PER_INCH;  // Z-axis down position for dropoff
+const long Z_UP_POS = 0;  // Z-axis fully up position
+const long Z_PICKUP_POS = inchesToSteps(Z_PICKUP_LOWER_INCHES, STEPS_PER_INCH);  // Z-axis down position for pickup
+const long Z_SUCTION_START_POS = inchesToSteps(Z_SUCTION_START_INCHES, STEPS_PER_INCH);  // Z position to start suction
+const long Z_DROPOFF_POS = inchesToSteps(Z_DROPOFF_LOWER_INCHES, STEPS_PER_INCH);  // Z-axis down position for dropoff
 
-// Servo angles
+// Blended X/Z motion envelope
+const bool BLENDED_MOTION_ENABLED = true;    // Overlap Z lift/lower with X travel
+const float Z_BLEND_CLEARANCE_INCHES = 1.0;  // X may move once Z is within 1 inch of its lift height
+const float X_BLEND_WINDOW_INCHES = 0.5;     // Z may lower once X is within 0.5 inch of its target
+const long Z_BLEND_CLEARANCE_POS = BLENDED_MOTION_ENABLED ? inchesToSteps(Z_BLEND_CLEARANCE_INCHES, STEPS_PER_INCH) : 0;
+const long X_BLEND_WINDOW_POS = BLENDED_MOTION_ENABLED ? inchesToSteps(X_BLEND_WINDOW_INCHES, STEPS_PER_INCH) : 0;
+
+// Servo angles (boot values - 'config set' changes them until the next reboot)
 const float SERVO_HOME_POS = 90.0;    // Servo home position (in degrees)
-const float SERVO_PICKUP_POS = 10.0;  // Servo pickup position (in degrees)
-const float SERVO_TRAVEL_POS = 0.0;   // Servo position for travel after pickup (in degrees)
-const float SERVO_DROPOFF_POS = 80.0; // Servo dropoff position (90 degrees from pickup)
-
-// Timing constants
-const unsigned long PICKUP_HOLD_TIME = 300;  // Hold time at pickup position (300ms)
-const unsigned long DROPOFF_HOLD_TIME = 100; // Hold time at dropoff position (100ms)
-const unsigned long SERVO_ROTATION_WAIT_TIME = 500;  // Wait time for servo to complete rotation at overshoot position (500ms)
-
-// Stepper settings
-const float X_MAX_SPEED = 7000.0;      // Maximum speed for X-axis in steps per second
-const float X_ACCELERATION = 10000.0;   // Acceleration for X-axis in steps per second^2
-const float Z_MAX_SPEED = 10000.0;      // Maximum speed for Z-axis in steps per second
-const float Z_ACCELERATION = 10000.0;   // Acceleration for Z-axis in steps per second^2
-const float Z_DROPOFF_MAX_SPEED = Z_MAX_SPEED / 1.0;  // Same speed for now for dropoff
-const float Z_DROPOFF_ACCELERATION = Z_ACCELERATION / 1.0;  // Same acceleration for now for dropoff
-const float X_HOME_SPEED = 1000.0;      // Homing speed for X-axis in steps per second
-const float Z_HOME_SPEED = 1000.0;      // Homing speed for Z-axis in steps per second 
\ No newline at end of file
+float SERVO_PICKUP_POS = 10.0;  // Servo pickup position (in degrees)
+float SERVO_TRAVEL_POS = 0.0;   // Servo position for travel after pickup (in degrees)
+float SERVO_DROPOFF_POS = 80.0; // Servo dropoff position (90 degrees from pickup)
+
+// Timing constants (boot values - 'config set' changes them until the next reboot)
+unsigned long PICKUP_HOLD_TIME = 300;  // Hold time at pickup position (300ms)
+unsigned long DROPOFF_HOLD_TIME = 100; // Hold time at dropoff position (100ms)
+unsigned long SERVO_ROTATION_WAIT_TIME = 500;  // Wait time for servo to complete rotation at overshoot position (500ms)
+
+// Transport mode
+const TransportMode TRANSPORT_MODE = TRANSPORT_MODE_ROTATE_IN_MOTION;  // TRANSPORT_MODE_OVERSHOOT restores the overshoot-and-return leg
+
+// Stepper settings (Q16.16 fixed point)
+const q16_t X_MAX_SPEED = q16FromInt(7000);      // Maximum speed for X-axis in steps per second
+const q16_t X_ACCELERATION = q16FromInt(10000);   // Acceleration for X-axis in steps per second^2
+const q16_t Z_MAX_SPEED = q16FromInt(10000);      // Maximum speed for Z-axis in steps per second
+const q16_t Z_ACCELERATION = q16FromInt(10000);   // Acceleration for Z-axis in steps per second^2
+const q16_t Z_DROPOFF_MAX_SPEED = Z_MAX_SPEED / 1;  // Same speed for now for dropoff
+const q16_t Z_DROPOFF_ACCELERATION = Z_ACCELERATION / 1;  // Same acceleration for now for dropoff
+const q16_t X_HOME_SPEED = q16FromInt(1000);      // Homing speed for X-axis in steps per second
+const q16_t Z_HOME_SPEED = q16FromInt(1000);      // Homing speed for Z-axis in steps per second
+
+// Two-speed homing: fast approach with deceleration, back off, then a slow
+// re-touch at X_HOME_SPEED/Z_HOME_SPEED. The switch edge is latched by interrupt.
+const q16_t X_HOME_FAST_SPEED = q16FromInt(3000);  // Fast approach speed for X-axis (overtravel ~150 steps)
+const q16_t Z_HOME_FAST_SPEED = q16FromInt(2000);  // Fast approach speed for Z-axis (overtravel ~67 steps)
+const q16_t HOME_ACCELERATION = q16FromInt(30000);  // Acceleration/deceleration while homing in steps per second^2
+const float HOME_BACKOFF_INCHES = 0.25;  // Back-off distance before the slow re-touch
+const long HOME_BACKOFF_STEPS = inchesToSteps(HOME_BACKOFF_INCHES, STEPS_PER_INCH);
+const float X_HOME_SEARCH_INCHES = 26.0;  // Fast search distance for X before falling back to a slow crawl
+const float Z_HOME_SEARCH_INCHES = 10.0;  // Fast search distance for Z before falling back to a slow crawl
+const long X_HOME_SEARCH_STEPS = inchesToSteps(X_HOME_SEARCH_INCHES, STEPS_PER_INCH);
+const long Z_HOME_SEARCH_STEPS = inchesToSteps(Z_HOME_SEARCH_INCHES, STEPS_PER_INCH);
+const uint32_t HOME_SWITCH_CONFIRM_MS = 5;  // Latched edge must still read HIGH (debounced) 5 ms later
+
+// Q16.16 holds up to 32767 steps/s (or steps/s^2). A larger value overflows
+// in q16FromInt() and fails these checks at compile time.
+static_assert(q16IsValidRate(X_MAX_SPEED), "X_MAX_SPEED outside the Q16.16 range");
+static_assert(q16IsValidRate(X_ACCELERATION), "X_ACCELERATION outside the Q16.16 range");
+static_assert(q16IsValidRate(Z_MAX_SPEED), "Z_MAX_SPEED outside the Q16.16 range");
+static_assert(q16IsValidRate(Z_ACCELERATION), "Z_ACCELERATION outside the Q16.16 range");
+static_assert(q16IsValidRate(Z_DROPOFF_MAX_SPEED), "Z_DROPOFF_MAX_SPEED outside the Q16.16 range");
+static_assert(q16IsValidRate(Z_DROPOFF_ACCELERATION), "Z_DROPOFF_ACCELERATION outside the Q16.16 range");
+static_assert(q16IsValidRate(X_HOME_SPEED), "X_HOME_SPEED outside the Q16.16 range");
+static_assert(q16IsValidRate(Z_HOME_SPEED), "Z_HOME_SPEED outside the Q16.16 range");
+static_assert(q16IsValidRate(X_HOME_FAST_SPEED), "X_HOME_FAST_SPEED outside the Q16.16 range");
+static_assert(q16IsValidRate(Z_HOME_FAST_SPEED), "Z_HOME_FAST_SPEED outside the Q16.16 range");
+static_assert(q16IsValidRate(HOME_ACCELERATION), "HOME_ACCELERATION outside the Q16.16 range");
+
+// X re-reference policy (X_REHOME_INTERVAL_CYCLES = 1 restores homing every cycle)
+const unsigned long X_REHOME_INTERVAL_CYCLES = 50;      // Re-home X every 50 cycles
+const unsigned long X_DRIFT_CHECK_INTERVAL_CYCLES = 1;  // Check X drift at the home switch every cycle
+const long X_DRIFT_TOLERANCE_STEPS = 5;                 // Re-home if the switch edge moves more than 5 steps (0.02")
+const float X_DRIFT_CHECK_OVERTRAVEL_INCHES = 0.1;      // Drift check travels 0.1" past the switch edge
+const long X_DRIFT_CHECK_OVERTRAVEL_STEPS = inchesToSteps(X_DRIFT_CHECK_OVERTRAVEL_INCHES, STEPS_PER_INCH);
+
+// Task layout - the WiFi stack runs on core 0, so motion gets core 1
+const int MOTION_TASK_CORE = 1;                 // Same core as the step timer interrupts
+const int COMMS_TASK_CORE = 0;                  // Shares core 0 with the WiFi stack
+const unsigned int MOTION_TASK_PRIORITY = 20;   // Above everything except the system tasks
+const unsigned int COMMS_TASK_PRIORITY = 1;     // Same as the Arduino loop task
+const uint32_t MOTION_TASK_STACK_SIZE = 8192;   // Motion task stack in bytes
+const uint32_t COMMS_TASK_STACK_SIZE = 8192;    // Comms task stack in bytes (OTA needs headroom)
+const uint32_t MOTION_TASK_PERIOD_MS = 1;       // Motion task runs every tick (1 ms)
+const uint32_t COMMS_TASK_PERIOD_MS = 2;        // Comms task runs every 2 ms
+const unsigned int LOG_TASK_PRIORITY = 1;       // Shares time with the comms task
+const uint32_t LOG_TASK_STACK_SIZE = 4096;      // Log drain task stack in bytes
+const uint32_t LOG_DRAIN_IDLE_MS = 5;           // Check the log rings every 5 ms when idle
+const unsigned long LOG_THROTTLE_SUMMARY_MS = 5000;  // Repeated wait logs summarised every 5 seconds
+
+// Pulse outputs - ended by a timer, the cycle keeps running during the pulse
+const uint32_t STAGE2_SIGNAL_PULSE_MS = 100;      // Stage 2 signal pulse width
+const bool STAGE2_SIGNAL_ACTIVE_HIGH = true;     // Stage 2 signal is active high
+
+// Trigger capture - edges are confirmed well inside the old 10 ms debounce
+const uint32_t TRIGGER_CONFIRM_MS = 5;       // Edge must still read HIGH 5 ms later
+const uint32_t TRIGGER_MAX_AGE_MS = 30000;   // A trigger waiting 30 s for idle is stale
+
+// PSRAM trace store - 10-byte samples, about 4.4 minutes at 1 kHz and 2.9 hours at 10 Hz
+const uint32_t TRACE_STORE_FINE_PERIOD_MS = 1;          // 1 kHz (one sample per motion period)
+const uint32_t TRACE_STORE_COARSE_PERIOD_MS = 100;      // 10 Hz
+const uint32_t TRACE_STORE_FINE_BYTES = 2560UL * 1024;  // 2.5 MB of the 4 MB PSRAM
+const uint32_t TRACE_STORE_COARSE_BYTES = 1024UL * 1024;  // 1 MB
+
+// Dashboard WebSocket server
+const uint16_t DASHBOARD_PORT = 81;                  // Fixed in data/index.html
+const uint32_t DASHBOARD_STATUS_INTERVAL_MS = 100;   // Status pushed at most 10 times a second
+
+// Binary telemetry - 25 samples per UDP packet keeps 500 Hz at 20 packets/s
+const uint16_t TELEMETRY_DEFAULT_PORT = 5005;
+const uint32_t TELEMETRY_DEFAULT_RATE_HZ = 500;   // Every other motion period
+const uint32_t TELEMETRY_MAX_RATE_HZ = 500;
+const uint32_t TELEMETRY_MAX_BATCH_MS = 50;       // Plot lags the machine by at most 50 ms
+
+// Resource monitor - warnings leave room to finish the cycle and log before anything fails
+const uint32_t RESOURCE_SAMPLE_PERIOD_MS = 1000;            // Sample once a second
+const uint32_t RESOURCE_HISTORY_PERIOD_MS = 30UL * 60000;   // One history entry per 30 minutes
+const uint32_t RESOURCE_MIN_FREE_HEAP_BYTES = 32768;        // 32 KB free heap
+const uint32_t RESOURCE_MIN_LARGEST_BLOCK_BYTES = 16384;    // 16 KB in one block (WiFi/OTA buffers)
+const uint8_t RESOURCE_MAX_FRAGMENTATION_PERCENT = 75;      // Largest block under a quarter of free heap
+const uint32_t RESOURCE_MIN_STACK_FREE_BYTES = 1024;        // 1 KB left on any task stack
+
+// Motion profile shape per axis (PROFILE_SCURVE allows higher acceleration without
+// the jolt at the start and end of each ramp). S-curves apply to the production
+// moves cached at boot; uncached moves on the motion task keep the trapezoid ramp.
+const MotionProfileType X_MOTION_PROFILE = PROFILE_TRAPEZOID;  // Profile used for X-axis moves
+const MotionProfileType Z_MOTION_PROFILE = PROFILE_TRAPEZOID;  // Profile used for Z-axis moves
+const long X_JERK = 100000;         // Jerk limit for X-axis in steps per second^3 (too large for Q16.16)
+const long Z_JERK = 100000;         // Jerk limit for Z-axis in steps per second^3 (too large for Q16.16)
@@ -20,4 +20,8 @@ const int Z_STEP_PIN = 19;          // Z-axis stepper motor step pin
 const int Z_DIR_PIN = 18;           // Z-axis stepper motor direction pin
 const int SERVO_PIN = 26;           // Servo control pin
 const int SOLENOID_RELAY_PIN = 33;  // Solenoid relay control pin
-const int STAGE2_SIGNAL_PIN = 25;   // Signal output to Stage 2 machine (active high) 
\ No newline at end of file
+const int STAGE2_SIGNAL_PIN = 25;   // Signal output to Stage 2 machine (active high)
+
+// Hardware timers
+const int X_STEP_TIMER = 0;        // Hardware timer driving X-axis step pulses
+const int Z_STEP_TIMER = 1;        // Hardware timer driving Z-axis step pulses 
\ No newline at end of file
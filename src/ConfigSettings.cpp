@@ -0,0 +1,100 @@
+#include "../include/ConfigSettings.h"
+#include "../include/FixedPoint.h"
+#include "Config/Config.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//* ************************************************************************
+//* ************************ CONFIG SETTINGS ***************************
+//* ************************************************************************
+
+static const ConfigSetting CONFIG_SETTINGS[] = {
+    {"xPickupPosInches", SETTING_FLOAT, &X_PICKUP_POS_INCHES, false, 0, 0, "in"},
+    {"xDropoffPosInches", SETTING_FLOAT, &X_DROPOFF_POS_INCHES, false, 0, 0, "in"},
+    {"zPickupLowerInches", SETTING_FLOAT, &Z_PICKUP_LOWER_INCHES, false, 0, 0, "in"},
+    {"zDropoffLowerInches", SETTING_FLOAT, &Z_DROPOFF_LOWER_INCHES, false, 0, 0, "in"},
+    {"xMaxSpeed", SETTING_Q16, &X_MAX_SPEED, false, 0, 0, "steps/s"},
+    {"xAcceleration", SETTING_Q16, &X_ACCELERATION, false, 0, 0, "steps/s^2"},
+    {"zMaxSpeed", SETTING_Q16, &Z_MAX_SPEED, false, 0, 0, "steps/s"},
+    {"zAcceleration", SETTING_Q16, &Z_ACCELERATION, false, 0, 0, "steps/s^2"},
+    {"servoPickupPos", SETTING_FLOAT, &SERVO_PICKUP_POS, true, 0, 180, "deg"},
+    {"servoTravelPos", SETTING_FLOAT, &SERVO_TRAVEL_POS, true, 0, 180, "deg"},
+    {"servoDropoffPos", SETTING_FLOAT, &SERVO_DROPOFF_POS, true, 0, 180, "deg"},
+    {"pickupHoldTime", SETTING_ULONG, &PICKUP_HOLD_TIME, true, 0, 5000, "ms"},
+    {"dropoffHoldTime", SETTING_ULONG, &DROPOFF_HOLD_TIME, true, 0, 5000, "ms"},
+    {"servoRotationWaitTime", SETTING_ULONG, &SERVO_ROTATION_WAIT_TIME, true, 0, 5000, "ms"},
+};
+static const uint8_t CONFIG_SETTING_COUNT = sizeof(CONFIG_SETTINGS) / sizeof(CONFIG_SETTINGS[0]);
+
+uint8_t getConfigSettingCount() {
+  return CONFIG_SETTING_COUNT;
+}
+
+const ConfigSetting& getConfigSetting(uint8_t index) {
+  return CONFIG_SETTINGS[index];
+}
+
+const ConfigSetting* findConfigSetting(const char* name) {
+  for (uint8_t i = 0; i < CONFIG_SETTING_COUNT; i++) {
+    if (strcmp(CONFIG_SETTINGS[i].name, name) == 0) {
+      return &CONFIG_SETTINGS[i];
+    }
+  }
+  return nullptr;
+}
+
+// Current value as text
+size_t formatConfigSetting(const ConfigSetting& setting, char* buffer, size_t size) {
+  int length = 0;
+  switch (setting.type) {
+    case SETTING_FLOAT:
+      length = snprintf(buffer, size, "%.2f", *(const float*)setting.value);
+      break;
+    case SETTING_ULONG:
+      length = snprintf(buffer, size, "%lu", *(const unsigned long*)setting.value);
+      break;
+    case SETTING_Q16:
+      length = snprintf(buffer, size, "%ld", (long)q16ToInt(*(const q16_t*)setting.value));
+      break;
+  }
+  if (length < 0) {
+    return 0;
+  }
+  return ((size_t)length < size) ? (size_t)length : size - 1;
+}
+
+// Parse and store a new value (motion task)
+ConfigSetResult setConfigSetting(const char* name, const char* text) {
+  const ConfigSetting* setting = findConfigSetting(name);
+  if (setting == nullptr) {
+    return CONFIG_SET_UNKNOWN;
+  }
+  if (!setting->writable) {
+    return CONFIG_SET_READ_ONLY;
+  }
+
+  char* end = nullptr;
+  float value = strtof(text, &end);
+  if (end == text || *end != '\0') {
+    return CONFIG_SET_INVALID;
+  }
+  if (value < setting->minimum || value > setting->maximum) {
+    return CONFIG_SET_OUT_OF_RANGE;
+  }
+
+  // Writable entries point at non-const Config variables
+  switch (setting->type) {
+    case SETTING_FLOAT:
+      *(float*)setting->value = value;
+      break;
+    case SETTING_ULONG:
+      *(unsigned long*)setting->value = (unsigned long)lroundf(value);
+      break;
+    case SETTING_Q16:
+      *(q16_t*)setting->value = q16FromFloat(value);
+      break;
+  }
+  return CONFIG_SET_OK;
+}
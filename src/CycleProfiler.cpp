@@ -0,0 +1,230 @@
+#include "../include/CycleProfiler.h"
+#include "../include/Utils.h"
+
+//* ************************************************************************
+//* ************************ CYCLE PROFILER ***************************
+//* ************************************************************************
+
+// Profiled sub-states in cycle order
+struct CyclePhase {
+  CycleSequence sequence;
+  uint8_t state;
+  const char* name;
+};
+
+static const CyclePhase CYCLE_PHASES[] = {
+    {CYCLE_SEQUENCE_PICKUP, PICKUP_MOVE_TO_PICKUP_POS, "move to pickup"},
+    {CYCLE_SEQUENCE_PICKUP, PICKUP_LOWER_Z_FOR_PICKUP, "lower Z for pickup"},
+    {CYCLE_SEQUENCE_PICKUP, PICKUP_WAIT_AT_PICKUP_POS, "wait at pickup"},
+    {CYCLE_SEQUENCE_PICKUP, PICKUP_RAISE_Z_WITH_OBJECT, "raise Z with object"},
+    {CYCLE_SEQUENCE_TRANSPORT, TRANSPORT_ROTATE_SERVO_TO_TRAVEL, "rotate servo to travel"},
+    {CYCLE_SEQUENCE_TRANSPORT, TRANSPORT_MOVE_TO_OVERSHOOT, "move to overshoot"},
+    {CYCLE_SEQUENCE_TRANSPORT, TRANSPORT_ROTATE_SERVO_IN_MOTION, "rotate servo in motion"},
+    {CYCLE_SEQUENCE_TRANSPORT, TRANSPORT_WAIT_FOR_SERVO_ROTATION, "wait for servo"},
+    {CYCLE_SEQUENCE_TRANSPORT, TRANSPORT_RETURN_TO_DROPOFF_POS, "return to dropoff"},
+    {CYCLE_SEQUENCE_DROPOFF, DROPOFF_LOWER_Z_FOR_DROPOFF, "lower Z for dropoff"},
+    {CYCLE_SEQUENCE_DROPOFF, DROPOFF_RELEASE_OBJECT_STATE, "release object"},
+    {CYCLE_SEQUENCE_DROPOFF, DROPOFF_WAIT_AFTER_RELEASE, "wait after release"},
+    {CYCLE_SEQUENCE_DROPOFF, DROPOFF_RAISE_Z_AFTER_DROPOFF, "raise Z after dropoff"},
+    {CYCLE_SEQUENCE_COMPLETION, COMPLETION_SIGNAL_STAGE2_STATE, "signal Stage 2"},
+    {CYCLE_SEQUENCE_COMPLETION, COMPLETION_RETURN_TO_PICKUP_PRE_HOME, "return X"},
+    {CYCLE_SEQUENCE_COMPLETION, COMPLETION_HOME_X_AXIS_STATE, "home X"},
+    {CYCLE_SEQUENCE_COMPLETION, COMPLETION_FINAL_MOVE_TO_PICKUP_POS, "final move to pickup"},
+};
+
+const uint8_t CYCLE_PHASE_COUNT = sizeof(CYCLE_PHASES) / sizeof(CYCLE_PHASES[0]);
+
+static const char* const CYCLE_SEQUENCE_NAMES[] = {"none", "pickup", "transport", "dropoff", "completion"};
+
+// One completed cycle (microseconds)
+struct CycleSample {
+  uint32_t phaseMicros[CYCLE_PHASE_COUNT];
+  uint32_t stage2WaitMicros;
+  uint32_t totalMicros;
+  uint32_t startMicros;  // micros() at pickup entry, for measured throughput
+};
+
+// Rolling window of completed cycles
+static CycleSample cycleWindow[CYCLE_PROFILE_WINDOW];
+static uint8_t windowCount = 0;
+static uint8_t windowNext = 0;
+static uint32_t cyclesProfiled = 0;
+
+// Cycle in progress
+static CycleSample currentCycle;
+static bool cycleActive = false;
+static CycleSequence lastSequence = CYCLE_SEQUENCE_NONE;
+static uint8_t lastSubState = 0;
+static int8_t currentPhase = -1;
+static uint32_t phaseStart = 0;
+static bool stage2WaitActive = false;
+static uint32_t stage2WaitStart = 0;
+
+// Index into CYCLE_PHASES, or -1 for untimed states (e.g. *_COMPLETE)
+static int8_t findPhase(CycleSequence sequence, uint8_t subState) {
+  for (uint8_t i = 0; i < CYCLE_PHASE_COUNT; i++) {
+    if (CYCLE_PHASES[i].sequence == sequence && CYCLE_PHASES[i].state == subState) {
+      return (int8_t)i;
+    }
+  }
+  return -1;
+}
+
+// Close the open phase and any Stage 2 wait at the given time
+static void closeOpenIntervals(uint32_t now) {
+  if (currentPhase >= 0) {
+    currentCycle.phaseMicros[currentPhase] += now - phaseStart;
+  }
+  if (stage2WaitActive) {
+    currentCycle.stage2WaitMicros += now - stage2WaitStart;
+    stage2WaitStart = now;
+  }
+}
+
+//* ************************************************************************
+//* ************************ RECORDING ***************************
+//* ************************************************************************
+
+// Report the current sequence and sub-state (called once per update)
+void profileCycleState(CycleSequence sequence, uint8_t subState, bool stage2Waiting) {
+  uint32_t now = micros();
+
+  // Stage 2 hold time overlaps the sub-state it happens in
+  if (cycleActive && stage2Waiting != stage2WaitActive) {
+    if (stage2Waiting) {
+      stage2WaitStart = now;
+    } else {
+      currentCycle.stage2WaitMicros += now - stage2WaitStart;
+    }
+    stage2WaitActive = stage2Waiting;
+  }
+
+  if (sequence == lastSequence && subState == lastSubState) {
+    return;
+  }
+  CycleSequence previousSequence = lastSequence;
+  lastSequence = sequence;
+  lastSubState = subState;
+
+  if (cycleActive) {
+    closeOpenIntervals(now);
+  }
+
+  // Back to idle or homing: keep the cycle only if it reached completion
+  if (sequence == CYCLE_SEQUENCE_NONE) {
+    if (cycleActive && previousSequence == CYCLE_SEQUENCE_COMPLETION) {
+      currentCycle.totalMicros = now - currentCycle.startMicros;
+      cycleWindow[windowNext] = currentCycle;
+      windowNext = (windowNext + 1) % CYCLE_PROFILE_WINDOW;
+      if (windowCount < CYCLE_PROFILE_WINDOW) windowCount++;
+      cyclesProfiled++;
+    }
+    cycleActive = false;
+    stage2WaitActive = false;
+    currentPhase = -1;
+    return;
+  }
+
+  // A cycle starts when the pickup sequence is entered from idle
+  if (!cycleActive) {
+    if (sequence != CYCLE_SEQUENCE_PICKUP) return;
+    memset(&currentCycle, 0, sizeof(currentCycle));
+    currentCycle.startMicros = now;
+    cycleActive = true;
+    stage2WaitActive = stage2Waiting;
+    stage2WaitStart = now;
+  }
+
+  currentPhase = findPhase(sequence, subState);
+  phaseStart = now;
+}
+
+// Empty the window
+void resetCycleProfile() {
+  windowCount = 0;
+  windowNext = 0;
+}
+
+//* ************************************************************************
+//* ************************ REPORTING ***************************
+//* ************************************************************************
+
+// Sort a small array in place
+static void sortSamples(uint32_t* values, uint8_t count) {
+  for (uint8_t i = 1; i < count; i++) {
+    uint32_t value = values[i];
+    int16_t j = i - 1;
+    while (j >= 0 && values[j] > value) {
+      values[j + 1] = values[j];
+      j--;
+    }
+    values[j + 1] = value;
+  }
+}
+
+// Nearest-rank percentile of sorted values
+static uint32_t percentileOf(const uint32_t* sorted, uint8_t count, uint8_t percent) {
+  uint16_t rank = (uint16_t)(((uint32_t)count * percent + 99) / 100);
+  if (rank < 1) rank = 1;
+  return sorted[rank - 1];
+}
+
+// Print one row from the samples in values (sorted in place)
+static void reportRow(const char* name, uint32_t* values, uint8_t count) {
+  sortSamples(values, count);
+  serialPrintf("  %-26s %9.1f %9.1f %9.1f %9.1f\n", name, percentileOf(values, count, 50) / 1000.0f,
+               percentileOf(values, count, 95) / 1000.0f, percentileOf(values, count, 99) / 1000.0f,
+               values[count - 1] / 1000.0f);
+}
+
+// Print the breakdown for the cycles in the window
+void reportCycleProfile() {
+  if (windowCount == 0) {
+    Serial.println("No completed cycles profiled yet");
+    return;
+  }
+
+  uint32_t values[CYCLE_PROFILE_WINDOW];
+  serialPrintf("Cycle profile, last %u of %lu cycles (ms):      p50       p95       p99       max\n",
+               windowCount, (unsigned long)cyclesProfiled);
+
+  CycleSequence sequence = CYCLE_SEQUENCE_NONE;
+  for (uint8_t phase = 0; phase < CYCLE_PHASE_COUNT; phase++) {
+    // Sequence total before its first sub-state
+    if (CYCLE_PHASES[phase].sequence != sequence) {
+      sequence = CYCLE_PHASES[phase].sequence;
+      for (uint8_t i = 0; i < windowCount; i++) {
+        values[i] = 0;
+        for (uint8_t p = 0; p < CYCLE_PHASE_COUNT; p++) {
+          if (CYCLE_PHASES[p].sequence == sequence) values[i] += cycleWindow[i].phaseMicros[p];
+        }
+      }
+      reportRow(CYCLE_SEQUENCE_NAMES[sequence], values, windowCount);
+    }
+
+    for (uint8_t i = 0; i < windowCount; i++) values[i] = cycleWindow[i].phaseMicros[phase];
+    char name[32];
+    snprintf(name, sizeof(name), "  %s", CYCLE_PHASES[phase].name);
+    reportRow(name, values, windowCount);
+  }
+
+  for (uint8_t i = 0; i < windowCount; i++) values[i] = cycleWindow[i].stage2WaitMicros;
+  reportRow("Stage 2 wait (overlaps)", values, windowCount);
+
+  for (uint8_t i = 0; i < windowCount; i++) values[i] = cycleWindow[i].totalMicros;
+  reportRow("cycle total", values, windowCount);
+  uint32_t medianMicros = percentileOf(values, windowCount, 50);
+
+  // Throughput at the median cycle time, and measured start to start (includes idle time)
+  float medianPartsPerHour = (medianMicros > 0) ? 3600.0e6f / medianMicros : 0.0f;
+  serialPrintf("Parts/hour: %.0f at median cycle time", medianPartsPerHour);
+  if (windowCount >= 2) {
+    uint8_t newest = (windowNext + CYCLE_PROFILE_WINDOW - 1) % CYCLE_PROFILE_WINDOW;
+    uint8_t oldest = (windowCount < CYCLE_PROFILE_WINDOW) ? 0 : windowNext;
+    uint32_t span = cycleWindow[newest].startMicros - cycleWindow[oldest].startMicros;
+    if (span > 0) {
+      serialPrintf(", %.0f measured start to start", 3600.0e6f * (windowCount - 1) / span);
+    }
+  }
+  Serial.println();
+}
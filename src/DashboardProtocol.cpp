@@ -0,0 +1,248 @@
+#include "../include/DashboardProtocol.h"
+#include "../include/ConfigSettings.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//* ************************************************************************
+//* ************************ MESSAGE FORMATTING ***************************
+//* ************************************************************************
+
+// Append to a message buffer; returns the new length (clamped to the buffer)
+static size_t appendMessage(char* buffer, size_t size, size_t length, const char* format, ...)
+    __attribute__((format(printf, 4, 5)));
+static size_t appendMessage(char* buffer, size_t size, size_t length, const char* format, ...) {
+  if (length >= size - 1) {
+    return length;
+  }
+  va_list args;
+  va_start(args, format);
+  int written = vsnprintf(buffer + length, size - length, format, args);
+  va_end(args);
+  if (written < 0) {
+    return length;
+  }
+  length += (size_t)written;
+  return (length < size) ? length : size - 1;
+}
+
+static const char* jsonBool(bool value) {
+  return value ? "true" : "false";
+}
+
+// Fields that differ between two statuses
+uint16_t changedDashboardFields(const DashboardStatus& before, const DashboardStatus& after) {
+  uint16_t fields = 0;
+  if (strcmp(before.state, after.state) != 0) fields |= FIELD_STATE;
+  if (before.xPos != after.xPos) fields |= FIELD_X_POS;
+  if (before.zPos != after.zPos) fields |= FIELD_Z_POS;
+  if (before.servoPos != after.servoPos) fields |= FIELD_SERVO_POS;
+  if (before.vacuum != after.vacuum) fields |= FIELD_VACUUM;
+  if (before.xHome != after.xHome) fields |= FIELD_X_HOME;
+  if (before.zHome != after.zHome) fields |= FIELD_Z_HOME;
+  if (before.freeHeapKb != after.freeHeapKb) fields |= FIELD_FREE_HEAP;
+  if (before.resourceWarnings != after.resourceWarnings) fields |= FIELD_RESOURCE_WARNINGS;
+  return fields;
+}
+
+// Status message holding the given fields
+size_t formatDashboardStatus(char* buffer, size_t size, const DashboardStatus& status, uint16_t fields) {
+  size_t length = appendMessage(buffer, size, 0, "{\"type\":\"status\"");
+  if (fields & FIELD_STATE) length = appendMessage(buffer, size, length, ",\"state\":\"%s\"", status.state);
+  if (fields & FIELD_X_POS) length = appendMessage(buffer, size, length, ",\"xPos\":%ld", status.xPos);
+  if (fields & FIELD_Z_POS) length = appendMessage(buffer, size, length, ",\"zPos\":%ld", status.zPos);
+  if (fields & FIELD_SERVO_POS) length = appendMessage(buffer, size, length, ",\"servoPos\":%.1f", status.servoPos);
+  if (fields & FIELD_VACUUM) length = appendMessage(buffer, size, length, ",\"vacuum\":%s", jsonBool(status.vacuum));
+  if (fields & FIELD_X_HOME) length = appendMessage(buffer, size, length, ",\"xHome\":%s", jsonBool(status.xHome));
+  if (fields & FIELD_Z_HOME) length = appendMessage(buffer, size, length, ",\"zHome\":%s", jsonBool(status.zHome));
+  if (fields & FIELD_FREE_HEAP) length = appendMessage(buffer, size, length, ",\"freeHeapKb\":%u", (unsigned)status.freeHeapKb);
+  if (fields & FIELD_RESOURCE_WARNINGS) {
+    length = appendMessage(buffer, size, length, ",\"resourceWarnings\":%u", (unsigned)status.resourceWarnings);
+  }
+  return appendMessage(buffer, size, length, "}");
+}
+
+// Push message for a new status, recorded as sent
+size_t formatDashboardPush(DashboardPushState& push, const DashboardStatus& status, char* buffer, size_t size) {
+  uint16_t fields = push.haveLastSent ? changedDashboardFields(push.lastSent, status) : (uint16_t)FIELD_ALL;
+  if (fields == 0) {
+    return 0;
+  }
+  push.lastSent = status;
+  push.haveLastSent = true;
+  return formatDashboardStatus(buffer, size, status, fields);
+}
+
+// Settings table, named as the dashboard's settings form expects
+size_t formatDashboardConfig(char* buffer, size_t size) {
+  size_t length = appendMessage(buffer, size, 0, "{\"type\":\"config\",\"config\":{");
+  for (uint8_t i = 0; i < getConfigSettingCount(); i++) {
+    const ConfigSetting& setting = getConfigSetting(i);
+    char value[24];
+    formatConfigSetting(setting, value, sizeof(value));
+    length = appendMessage(buffer, size, length, "%s\"%s\":%s", i > 0 ? "," : "", setting.name, value);
+  }
+  return appendMessage(buffer, size, length, "}}");
+}
+
+//* ************************************************************************
+//* ************************ SENDING ***************************
+//* ************************************************************************
+
+void sendDashboardLog(const DashboardTransport& transport, uint8_t client, const char* format, ...) {
+  char text[128];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(text, sizeof(text), format, args);
+  va_end(args);
+
+  char message[192];
+  size_t length = appendMessage(message, sizeof(message), 0, "{\"type\":\"log\",\"message\":\"%s\"}", text);
+  transport.sendText(client, message, length);
+}
+
+void sendDashboardStatus(const DashboardTransport& transport, uint8_t client) {
+  DashboardStatus status;
+  if (!transport.readStatus(status)) {
+    return;
+  }
+  char message[DASHBOARD_MESSAGE_SIZE];
+  size_t length = formatDashboardStatus(message, sizeof(message), status, FIELD_ALL);
+  transport.sendText(client, message, length);
+}
+
+void sendDashboardConfig(const DashboardTransport& transport, uint8_t client) {
+  char message[DASHBOARD_MESSAGE_SIZE];
+  size_t length = formatDashboardConfig(message, sizeof(message));
+  transport.sendText(client, message, length);
+}
+
+//* ************************************************************************
+//* ************************ COMMANDS ***************************
+//* ************************************************************************
+
+// Text following "key": in a flat JSON object (nullptr if absent)
+static const char* findJsonValue(const char* text, const char* key) {
+  char pattern[32];
+  snprintf(pattern, sizeof(pattern), "\"%s\"", key);
+  const char* cursor = strstr(text, pattern);
+  if (cursor == nullptr) {
+    return nullptr;
+  }
+  cursor += strlen(pattern);
+  while (*cursor == ' ' || *cursor == ':') cursor++;
+  return cursor;
+}
+
+// Copy the string value of "key" from a flat JSON object. Escaped strings
+// are not needed by the dashboard protocol and end the value.
+static bool readJsonString(const char* text, const char* key, char* value, size_t size) {
+  const char* cursor = findJsonValue(text, key);
+  if (cursor == nullptr || *cursor != '"') {
+    return false;
+  }
+  cursor++;
+  size_t length = 0;
+  while (cursor[length] != '\0' && cursor[length] != '"' && cursor[length] != '\\' && length < size - 1) {
+    value[length] = cursor[length];
+    length++;
+  }
+  value[length] = '\0';
+  return true;
+}
+
+static bool readJsonNumber(const char* text, const char* key, float& value) {
+  const char* cursor = findJsonValue(text, key);
+  if (cursor == nullptr) {
+    return false;
+  }
+  char* end = nullptr;
+  value = strtof(cursor, &end);
+  return end != cursor;
+}
+
+static bool readJsonBool(const char* text, const char* key, bool& value) {
+  const char* cursor = findJsonValue(text, key);
+  if (cursor == nullptr || (strncmp(cursor, "true", 4) != 0 && strncmp(cursor, "false", 5) != 0)) {
+    return false;
+  }
+  value = (cursor[0] == 't');
+  return true;
+}
+
+// Run a console command line and tell the client. Replies and errors go to
+// Serial like any other console command.
+static void submitDashboardCommand(const DashboardTransport& transport, uint8_t client, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+static void submitDashboardCommand(const DashboardTransport& transport, uint8_t client, const char* format, ...) {
+  char line[DASHBOARD_COMMAND_LENGTH];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+
+  sendDashboardLog(transport, client, "Sent '%s'", line);
+  transport.submitCommand(line);
+}
+
+// manualControl actions map onto the console's manual commands
+static void handleManualControl(const DashboardTransport& transport, uint8_t client, const char* text) {
+  char action[24] = "";
+  readJsonString(text, "action", action, sizeof(action));
+  float number = 0;
+  bool state = false;
+  if (strcmp(action, "home") == 0) {
+    submitDashboardCommand(transport, client, "home");
+  } else if (strcmp(action, "pickCycle") == 0) {
+    submitDashboardCommand(transport, client, "cycle");
+  } else if (strcmp(action, "moveX") == 0 && readJsonNumber(text, "target", number)) {
+    submitDashboardCommand(transport, client, "move x %.3f", number);
+  } else if (strcmp(action, "moveZ") == 0 && readJsonNumber(text, "target", number)) {
+    submitDashboardCommand(transport, client, "move z %.3f", number);
+  } else if (strcmp(action, "servo") == 0 && readJsonNumber(text, "angle", number)) {
+    submitDashboardCommand(transport, client, "servo %.1f", number);
+  } else if (strcmp(action, "vacuum") == 0 && readJsonBool(text, "state", state)) {
+    submitDashboardCommand(transport, client, "vacuum %s", state ? "on" : "off");
+  } else {
+    sendDashboardLog(transport, client, "Manual control '%s' not understood", action);
+  }
+}
+
+// Each recognised key becomes a 'config set'; read-only keys are reported
+static void handleSetConfig(const DashboardTransport& transport, uint8_t client, const char* text) {
+  for (uint8_t i = 0; i < getConfigSettingCount(); i++) {
+    const ConfigSetting& setting = getConfigSetting(i);
+    float value = 0;
+    if (!readJsonNumber(text, setting.name, value)) {
+      continue;
+    }
+    if (setting.writable) {
+      submitDashboardCommand(transport, client, "config set %s %.2f", setting.name, value);
+    } else {
+      sendDashboardLog(transport, client, "%s is compiled in (Config.cpp) and cannot be changed here", setting.name);
+    }
+  }
+}
+
+void handleDashboardMessage(const DashboardTransport& transport, uint8_t client, const char* text) {
+  char command[24];
+  if (!readJsonString(text, "command", command, sizeof(command))) {
+    sendDashboardLog(transport, client, "Malformed message");
+    return;
+  }
+
+  if (strcmp(command, "getStatus") == 0) {
+    sendDashboardStatus(transport, client);
+  } else if (strcmp(command, "getConfig") == 0) {
+    sendDashboardConfig(transport, client);
+  } else if (strcmp(command, "emergencyStop") == 0) {
+    submitDashboardCommand(transport, client, "stop");
+  } else if (strcmp(command, "manualControl") == 0) {
+    handleManualControl(transport, client, text);
+  } else if (strcmp(command, "setConfig") == 0) {
+    handleSetConfig(transport, client, text);
+  } else {
+    sendDashboardLog(transport, client, "Unknown command '%s'", command);
+  }
+}
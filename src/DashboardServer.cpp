@@ -0,0 +1,122 @@
+#include "../include/DashboardServer.h"
+#include "../include/DashboardProtocol.h"
+#include "../include/TaskManager.h"
+#include "../include/PickCycle.h"
+#include "../include/ResourceMonitor.h"
+#include "../include/CommandProcessor.h"
+#include "../include/Utils.h"
+#include "Config/Config.h"
+#include <WebSocketsServer.h>
+
+//* ************************************************************************
+//* ************************ DASHBOARD SERVER ***************************
+//* ************************************************************************
+
+static_assert(DASHBOARD_COMMAND_LENGTH == COMMAND_LINE_LENGTH, "dashboard and console lines differ in length");
+
+static WebSocketsServer webSocket(DASHBOARD_PORT);
+static bool serverStarted = false;
+static DashboardPushState pushState = {};
+static uint32_t lastPushMs = 0;
+
+//* ************************************************************************
+//* ************************ TRANSPORT ***************************
+//* ************************************************************************
+
+static void sendWebSocketText(uint8_t client, const char* text, size_t length) {
+  webSocket.sendTXT(client, text, length);
+}
+
+// Current status from the motion snapshot and the resource monitor
+static bool readStatus(DashboardStatus& status) {
+  MotionSnapshot snapshot;
+  if (!readMotionSnapshot(snapshot)) {
+    return false;
+  }
+  status.state = getStateString(snapshot.pickCycleState);
+  status.xPos = snapshot.xPosition;
+  status.zPos = snapshot.zPosition;
+  status.servoPos = snapshot.servoPosition;
+  status.vacuum = snapshot.vacuumOn;
+  status.xHome = snapshot.xHomeSwitch;
+  status.zHome = snapshot.zHomeSwitch;
+
+  ResourceSample sample;
+  status.freeHeapKb = getResourceSample(sample) ? (uint16_t)(sample.freeHeap / 1024) : 0;
+  status.resourceWarnings = getResourceWarnings();
+  return true;
+}
+
+static const DashboardTransport webSocketTransport = {sendWebSocketText, submitCommandLine, readStatus};
+
+//* ************************************************************************
+//* ************************ EVENTS ***************************
+//* ************************************************************************
+
+static void handleWebSocketEvent(uint8_t client, WStype_t type, uint8_t* payload, size_t length) {
+  switch (type) {
+    case WStype_CONNECTED:
+      LOG_INFO("Dashboard client %u connected", client);
+      sendDashboardStatus(webSocketTransport, client);
+      sendDashboardConfig(webSocketTransport, client);
+      break;
+
+    case WStype_DISCONNECTED:
+      LOG_INFO("Dashboard client %u disconnected", client);
+      break;
+
+    case WStype_TEXT: {
+      if (length >= DASHBOARD_MESSAGE_SIZE) {
+        sendDashboardLog(webSocketTransport, client, "Message too long");
+        break;
+      }
+      char text[DASHBOARD_MESSAGE_SIZE];
+      memcpy(text, payload, length);
+      text[length] = '\0';
+      handleDashboardMessage(webSocketTransport, client, text);
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+//* ************************************************************************
+//* ************************ SERVER ***************************
+//* ************************************************************************
+
+// Start listening (comms task, after WiFi is connected)
+void beginDashboardServer() {
+  webSocket.begin();
+  webSocket.onEvent(handleWebSocketEvent);
+  serverStarted = true;
+  LOG_INFO("Dashboard WebSocket server on port %u", DASHBOARD_PORT);
+}
+
+// Serve clients, then broadcast one delta message if the status changed
+void updateDashboardServer() {
+  if (!serverStarted) {
+    return;
+  }
+  webSocket.loop();
+
+  uint32_t now = millis();
+  if (now - lastPushMs < DASHBOARD_STATUS_INTERVAL_MS) {
+    return;
+  }
+  lastPushMs = now;
+  if (webSocket.connectedClients() == 0) {
+    return;
+  }
+
+  DashboardStatus status;
+  if (!readStatus(status)) {
+    return;
+  }
+  char message[DASHBOARD_MESSAGE_SIZE];
+  size_t length = formatDashboardPush(pushState, status, message, sizeof(message));
+  if (length > 0) {
+    webSocket.broadcastTXT(message, length);
+  }
+}
@@ -0,0 +1,113 @@
+#include "../include/EventTrace.h"
+#include "../include/Utils.h"
+#include "Config/Pins_Definitions.h"
+
+//* ************************************************************************
+//* ************************ EVENT TRACE ***************************
+//* ************************************************************************
+
+static TraceEvent traceBuffer[TRACE_BUFFER_EVENTS];
+static uint16_t traceNext = 0;       // Slot for the next event
+static uint16_t traceCount = 0;      // Events held (up to TRACE_BUFFER_EVENTS)
+static uint32_t traceOverwritten = 0;  // Oldest events replaced since the last clear
+static volatile bool traceEnabled = true;
+static portMUX_TYPE traceLock = portMUX_INITIALIZER_UNLOCKED;
+
+//* ************************************************************************
+//* ************************ RECORDING ***************************
+//* ************************************************************************
+
+// Record one event (task or ISR context)
+void IRAM_ATTR traceEvent(TraceEventType type, uint8_t track, int32_t value) {
+  if (!traceEnabled) {
+    return;
+  }
+
+  uint32_t now = micros();
+  portENTER_CRITICAL_SAFE(&traceLock);
+  if (traceEnabled) {
+    TraceEvent& event = traceBuffer[traceNext];
+    event.timestamp = now;
+    event.type = (uint8_t)type;
+    event.track = track;
+    event.reserved = 0;
+    event.value = value;
+    traceNext = (traceNext + 1) % TRACE_BUFFER_EVENTS;
+    if (traceCount < TRACE_BUFFER_EVENTS) {
+      traceCount++;
+    } else {
+      traceOverwritten++;
+    }
+  }
+  portEXIT_CRITICAL_SAFE(&traceLock);
+}
+
+// Write an output pin and record the change (task or ISR context)
+void IRAM_ATTR traceDigitalWrite(uint8_t pin, uint8_t level) {
+  digitalWrite(pin, level);
+  traceEvent(TRACE_OUTPUT, pin, level);
+}
+
+// Enable or pause recording
+void setEventTraceEnabled(bool enabled) {
+  portENTER_CRITICAL(&traceLock);
+  traceEnabled = enabled;
+  portEXIT_CRITICAL(&traceLock);
+}
+
+bool isEventTraceEnabled() {
+  return traceEnabled;
+}
+
+// Discard all recorded events
+void clearEventTrace() {
+  portENTER_CRITICAL(&traceLock);
+  traceNext = 0;
+  traceCount = 0;
+  traceOverwritten = 0;
+  portEXIT_CRITICAL(&traceLock);
+}
+
+//* ************************************************************************
+//* ************************ REPORTING ***************************
+//* ************************************************************************
+
+// Print buffer fill and recording state
+void reportEventTrace() {
+  portENTER_CRITICAL(&traceLock);
+  uint16_t count = traceCount;
+  uint32_t overwritten = traceOverwritten;
+  portEXIT_CRITICAL(&traceLock);
+
+  serialPrintf("Event trace: %s, %u of %u events, %lu overwritten\n", traceEnabled ? "recording" : "paused",
+               count, TRACE_BUFFER_EVENTS, (unsigned long)overwritten);
+}
+
+// Stream the ring over Serial, oldest first. Recording is paused while the
+// buffer is read and resumed afterwards if it was on. Line format:
+//   # comment / header lines
+//   O,<pin>,<name>                           Output pin names
+//   E,<micros>,<type>,<track>,<value>        One TraceEvent
+void dumpEventTrace() {
+  portENTER_CRITICAL(&traceLock);
+  bool wasEnabled = traceEnabled;
+  traceEnabled = false;
+  uint16_t count = traceCount;
+  uint16_t first = (traceNext + TRACE_BUFFER_EVENTS - traceCount) % TRACE_BUFFER_EVENTS;
+  uint32_t overwritten = traceOverwritten;
+  portEXIT_CRITICAL(&traceLock);
+
+  Serial.println("# trace begin");
+  serialPrintf("# events %u overwritten %lu now %lu\n", count, (unsigned long)overwritten,
+               (unsigned long)micros());
+  serialPrintf("O,%d,vacuum\n", SOLENOID_RELAY_PIN);
+  serialPrintf("O,%d,stage2 signal\n", STAGE2_SIGNAL_PIN);
+  for (uint16_t i = 0; i < count; i++) {
+    const TraceEvent& event = traceBuffer[(first + i) % TRACE_BUFFER_EVENTS];
+    serialPrintf("E,%lu,%u,%u,%ld\n", (unsigned long)event.timestamp, event.type, event.track,
+                 (long)event.value);
+  }
+  Serial.println("# trace end");
+
+  setEventTraceEnabled(wasEnabled);
+}
@@ -0,0 +1,135 @@
+#include "../include/HeapAudit.h"
+#include "../include/TaskManager.h"
+#include "../include/Utils.h"
+
+//* ************************************************************************
+//* ************************ HEAP AUDIT ***************************
+//* ************************************************************************
+
+#ifdef HEAP_AUDIT
+
+#include <atomic>
+
+// One call site that allocated during a cycle
+struct HeapAuditCaller {
+  void* address;  // Return address into the allocating function
+  uint32_t count;
+  bool motionTask;
+};
+
+static volatile bool cycleActive = false;
+static std::atomic<uint32_t> motionAllocations(0);
+static std::atomic<uint32_t> motionBytes(0);
+static std::atomic<uint32_t> otherAllocations(0);
+static std::atomic<uint32_t> otherBytes(0);
+static HeapAuditCaller callers[HEAP_AUDIT_CALLERS];
+static uint8_t callerCount = 0;
+static uint32_t callersMissed = 0;  // Allocations from call sites past the table
+static portMUX_TYPE callerLock = portMUX_INITIALIZER_UNLOCKED;
+
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+}
+
+// Count one allocation if a cycle is running. Must not allocate itself.
+static void recordAllocation(size_t size, void* caller) {
+  if (!cycleActive) {
+    return;
+  }
+
+  bool motionTask = isMotionTask();
+  if (motionTask) {
+    motionAllocations.fetch_add(1, std::memory_order_relaxed);
+    motionBytes.fetch_add(size, std::memory_order_relaxed);
+  } else {
+    otherAllocations.fetch_add(1, std::memory_order_relaxed);
+    otherBytes.fetch_add(size, std::memory_order_relaxed);
+  }
+
+  portENTER_CRITICAL_SAFE(&callerLock);
+  uint8_t i = 0;
+  while (i < callerCount && callers[i].address != caller) {
+    i++;
+  }
+  if (i < callerCount) {
+    callers[i].count++;
+  } else if (callerCount < HEAP_AUDIT_CALLERS) {
+    callers[callerCount] = {caller, 1, motionTask};
+    callerCount++;
+  } else {
+    callersMissed++;
+  }
+  portEXIT_CRITICAL_SAFE(&callerLock);
+}
+
+extern "C" {
+void* __wrap_malloc(size_t size) {
+  recordAllocation(size, __builtin_return_address(0));
+  return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+  recordAllocation(count * size, __builtin_return_address(0));
+  return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* pointer, size_t size) {
+  recordAllocation(size, __builtin_return_address(0));
+  return __real_realloc(pointer, size);
+}
+}
+
+void setHeapAuditCycleActive(bool active) {
+  cycleActive = active;
+}
+
+// Print allocation counts and call sites seen during cycles
+void reportHeapAudit() {
+  HeapAuditCaller snapshot[HEAP_AUDIT_CALLERS];
+  portENTER_CRITICAL(&callerLock);
+  uint8_t count = callerCount;
+  uint32_t missed = callersMissed;
+  for (uint8_t i = 0; i < count; i++) {
+    snapshot[i] = callers[i];
+  }
+  portEXIT_CRITICAL(&callerLock);
+
+  serialPrintf("Heap audit (during cycles): motion task %lu allocations / %lu bytes, other tasks %lu / %lu\n",
+               (unsigned long)motionAllocations.load(), (unsigned long)motionBytes.load(),
+               (unsigned long)otherAllocations.load(), (unsigned long)otherBytes.load());
+  for (uint8_t i = 0; i < count; i++) {
+    serialPrintf("  0x%08lx x%lu (%s)\n", (unsigned long)(uintptr_t)snapshot[i].address,
+                 (unsigned long)snapshot[i].count, snapshot[i].motionTask ? "motion" : "other");
+  }
+  if (missed > 0) {
+    serialPrintf("  %lu more from call sites not listed\n", (unsigned long)missed);
+  }
+}
+
+// Clear counts and call sites
+void resetHeapAudit() {
+  motionAllocations = 0;
+  motionBytes = 0;
+  otherAllocations = 0;
+  otherBytes = 0;
+  portENTER_CRITICAL(&callerLock);
+  callerCount = 0;
+  callersMissed = 0;
+  portEXIT_CRITICAL(&callerLock);
+}
+
+#else  // HEAP_AUDIT
+
+void setHeapAuditCycleActive(bool active) {
+  (void)active;
+}
+
+void reportHeapAudit() {
+  Serial.println("Heap audit not compiled in - build the freenove_esp32_wrover_heap_audit environment");
+}
+
+void resetHeapAudit() {}
+
+#endif  // HEAP_AUDIT
@@ -0,0 +1,77 @@
+#include "../include/LatencyStats.h"
+#include "../include/Utils.h"
+
+//* ************************************************************************
+//* ************************ LATENCY STATISTICS ***************************
+//* ************************************************************************
+
+static LatencyHistogram latencyHistograms[LATENCY_CHANNEL_COUNT];
+
+static const char* const LATENCY_CHANNEL_NAMES[LATENCY_CHANNEL_COUNT] = {
+    "loop period", "debounce", "serial", "stepping", "pick cycle", "ota", "X step error", "Z step error",
+    "trigger->move"};
+
+LatencyHistogram::LatencyHistogram()
+    : resetPending(false), samples(0), minMicros(UINT32_MAX), maxMicros(0), totalMicros(0) {
+  memset(buckets, 0, sizeof(buckets));
+}
+
+// Add one sample (writer side)
+void IRAM_ATTR LatencyHistogram::record(uint32_t micros) {
+  if (resetPending) {
+    for (uint8_t i = 0; i < LATENCY_BUCKETS; i++) buckets[i] = 0;
+    samples = 0;
+    minMicros = UINT32_MAX;
+    maxMicros = 0;
+    totalMicros = 0;
+    resetPending = false;
+  }
+
+  uint8_t bucket = (micros == 0) ? 0 : (uint8_t)(32 - __builtin_clz(micros));
+  if (bucket >= LATENCY_BUCKETS) bucket = LATENCY_BUCKETS - 1;
+  buckets[bucket]++;
+  samples++;
+  totalMicros += micros;
+  if (micros < minMicros) minMicros = micros;
+  if (micros > maxMicros) maxMicros = micros;
+}
+
+// Upper bound of the bucket holding the given percentile
+uint32_t LatencyHistogram::percentile(uint8_t percent) const {
+  if (samples == 0) return 0;
+  uint32_t target = (uint32_t)(((uint64_t)samples * percent + 99) / 100);
+  uint32_t cumulative = 0;
+  for (uint8_t i = 0; i < LATENCY_BUCKETS; i++) {
+    cumulative += buckets[i];
+    if (cumulative >= target) {
+      if (i == LATENCY_BUCKETS - 1) return maxMicros;  // Open-ended last bucket
+      uint32_t upper = (i == 0) ? 0 : (1UL << i) - 1;
+      return (upper < maxMicros) ? upper : maxMicros;
+    }
+  }
+  return maxMicros;
+}
+
+LatencyHistogram& getLatencyHistogram(LatencyChannel channel) {
+  return latencyHistograms[channel];
+}
+
+// Clear every histogram
+void resetLatencyStats() {
+  for (uint8_t i = 0; i < LATENCY_CHANNEL_COUNT; i++) {
+    latencyHistograms[i].reset();
+  }
+}
+
+// Print count, min, percentiles and max per channel (all in microseconds)
+void reportLatencyStats() {
+  Serial.println("Latency (us):        count     min     p50     p95     p99     max    mean");
+  for (uint8_t i = 0; i < LATENCY_CHANNEL_COUNT; i++) {
+    const LatencyHistogram& histogram = latencyHistograms[i];
+    serialPrintf("  %-14s %10lu %7lu %7lu %7lu %7lu %7lu %7lu\n", LATENCY_CHANNEL_NAMES[i],
+                 (unsigned long)histogram.count(), (unsigned long)histogram.minimum(),
+                 (unsigned long)histogram.percentile(50), (unsigned long)histogram.percentile(95),
+                 (unsigned long)histogram.percentile(99), (unsigned long)histogram.maximum(),
+                 (unsigned long)histogram.mean());
+  }
+}
@@ -0,0 +1,284 @@
+#include "../include/Logger.h"
+#include "../include/SpscQueue.h"
+#include "../include/TaskManager.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+
+//* ************************************************************************
+//* ************************ BINARY LOGGER ***************************
+//* ************************************************************************
+// Two rings feed the drain task:
+//   - Motion ring: written only by the motion task, completely lock-free
+//   - Shared ring: every other task (comms, OTA callbacks, timers); writers
+//     serialise on a spinlock held for a few word writes
+// The drain task merges both rings in timestamp order.
+
+const size_t LOG_TEXT_LENGTH = 160;  // Longest formatted line
+
+static SpscQueue<LogRecord, 256> motionRing;
+static SpscQueue<LogRecord, 64> sharedRing;
+static portMUX_TYPE sharedRingLock = portMUX_INITIALIZER_UNLOCKED;
+static std::atomic<uint32_t> recordsWritten(0);
+static uint32_t ringHighWater = 0;  // Drain task only
+static volatile bool drainRunning = false;
+volatile uint8_t runtimeLogLevel = LOG_MIN_LEVEL;
+
+static const char* const LOG_LEVEL_NAMES[] = {"trace", "debug", "info", "warn", "error", "none"};
+static const char LOG_LEVEL_TAGS[] = {'T', 'D', 'I', 'W', 'E'};
+
+//* ************************************************************************
+//* ************************ LEVELS ***************************
+//* ************************************************************************
+
+// Set the run-time level (clamped to the build-time minimum)
+void setLogLevel(uint8_t level) {
+  if (level < LOG_MIN_LEVEL) level = LOG_MIN_LEVEL;
+  if (level > LOG_LEVEL_NONE) level = LOG_LEVEL_NONE;
+  runtimeLogLevel = level;
+}
+
+uint8_t getLogLevel() {
+  return runtimeLogLevel;
+}
+
+const char* getLogLevelName(uint8_t level) {
+  return (level <= LOG_LEVEL_NONE) ? LOG_LEVEL_NAMES[level] : "unknown";
+}
+
+// Level from its name ("debug", "info", ...)
+bool parseLogLevel(const char* name, uint8_t* level) {
+  for (uint8_t i = 0; i <= LOG_LEVEL_NONE; i++) {
+    if (strcmp(name, LOG_LEVEL_NAMES[i]) == 0) {
+      *level = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+//* ************************************************************************
+//* ************************ FORMATTING ***************************
+//* ************************************************************************
+
+// Format a record into text (returns the text length)
+size_t formatLogRecord(const LogRecord& record, char* buffer, size_t size) {
+  size_t length = 0;
+  uint8_t argIndex = 0;
+  const char* p = record.format;
+
+  while (*p != '\0' && length + 1 < size) {
+    if (*p != '%') {
+      buffer[length++] = *p++;
+      continue;
+    }
+
+    // Copy flags, width and precision; drop length modifiers (every argument is one word)
+    char spec[16];
+    size_t specLength = 0;
+    spec[specLength++] = *p++;
+    while (*p != '\0' && strchr("-+ #0123456789.", *p) != nullptr && specLength < sizeof(spec) - 2) {
+      spec[specLength++] = *p++;
+    }
+    while (*p == 'l' || *p == 'h' || *p == 'z') p++;
+    char conversion = *p;
+    if (conversion == '\0') break;
+    p++;
+    if (conversion == '%') {
+      buffer[length++] = '%';
+      continue;
+    }
+    spec[specLength++] = conversion;
+    spec[specLength] = '\0';
+
+    uintptr_t arg = (argIndex < record.argCount) ? record.args[argIndex++] : 0;
+    char* out = buffer + length;
+    size_t room = size - length;
+    int written = 0;
+    switch (conversion) {
+      case 'd':
+      case 'i':
+        written = snprintf(out, room, spec, (int)(int32_t)arg);
+        break;
+      case 'u':
+      case 'x':
+      case 'X':
+        written = snprintf(out, room, spec, (unsigned int)(uint32_t)arg);
+        break;
+      case 'c':
+        written = snprintf(out, room, spec, (int)arg);
+        break;
+      case 's':
+        written = snprintf(out, room, spec, arg != 0 ? (const char*)arg : "(null)");
+        break;
+      case 'f':
+      case 'e':
+      case 'g': {
+        uint32_t bits = (uint32_t)arg;
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        written = snprintf(out, room, spec, (double)value);
+        break;
+      }
+      default:
+        written = snprintf(out, room, "%s", spec);  // Unknown conversion - print it as is
+        break;
+    }
+    if (written > 0) {
+      length += ((size_t)written < room) ? (size_t)written : room - 1;
+    }
+  }
+
+  buffer[length] = '\0';
+  return length;
+}
+
+// Print a record with its timestamp and level tag
+static void printLogRecord(const LogRecord& record) {
+  char text[LOG_TEXT_LENGTH];
+  formatLogRecord(record, text, sizeof(text));
+  char stamp[24];  // Room for uptimes past 27.7 hours (6+ digit seconds)
+  snprintf(stamp, sizeof(stamp), "[%5lu.%03lu] %c ", (unsigned long)(record.timestamp / 1000000),
+           (unsigned long)((record.timestamp / 1000) % 1000),
+           (record.level < LOG_LEVEL_NONE) ? LOG_LEVEL_TAGS[record.level] : '?');
+  Serial.print(stamp);
+  Serial.println(text);
+}
+
+//* ************************************************************************
+//* ************************ WRITING ***************************
+//* ************************************************************************
+
+static void fillRecord(LogRecord& record, uint8_t level, const char* format, const uintptr_t* args,
+                       uint8_t argCount) {
+  record.format = format;
+  record.timestamp = esp_timer_get_time();
+  record.level = level;
+  record.argCount = argCount;
+  for (uint8_t i = 0; i < argCount; i++) {
+    record.args[i] = args[i];
+  }
+}
+
+// Store one record (use the LOG_* macros instead)
+void logWrite(uint8_t level, const char* format, const uintptr_t* args, uint8_t argCount) {
+  // Until the drain task runs (setup), print straight away
+  if (!drainRunning) {
+    LogRecord record;
+    fillRecord(record, level, format, args, argCount);
+    printLogRecord(record);
+    return;
+  }
+
+  if (isMotionTask()) {
+    LogRecord* record = motionRing.reserve();
+    if (record == nullptr) return;  // Counted as dropped by the ring
+    fillRecord(*record, level, format, args, argCount);
+    motionRing.commit();
+  } else {
+    portENTER_CRITICAL(&sharedRingLock);
+    LogRecord* record = sharedRing.reserve();
+    if (record != nullptr) {
+      fillRecord(*record, level, format, args, argCount);
+      sharedRing.commit();
+    }
+    portEXIT_CRITICAL(&sharedRingLock);
+    if (record == nullptr) return;
+  }
+  recordsWritten.fetch_add(1, std::memory_order_relaxed);
+}
+
+//* ************************************************************************
+//* ************************ THROTTLED CHANNEL ***************************
+//* ************************************************************************
+
+LogThrottle::LogThrottle(uint8_t level, const char* message)
+    : level(level), message(message), active(false), count(0), startTime(0), lastSummary(0) {}
+
+// Condition present - log the first poll, then only periodic summaries
+void LogThrottle::hit() {
+  if (level < runtimeLogLevel) return;
+  unsigned long now = millis();
+
+  if (!active) {
+    active = true;
+    count = 1;
+    startTime = now;
+    lastSummary = now;
+    logAt(level, "%s", message);
+    return;
+  }
+
+  count++;
+  if (now - lastSummary >= LOG_THROTTLE_SUMMARY_MS) {
+    lastSummary = now;
+    logAt(level, "%s (still waiting: %lu polls over %lu ms)", message, count, now - startTime);
+  }
+}
+
+// Condition gone - summarise what was suppressed
+void LogThrottle::clear() {
+  if (!active) return;
+  active = false;
+  if (count > 1) {
+    logAt(level, "%s - cleared after %lu polls over %lu ms", message, count, millis() - startTime);
+  }
+}
+
+//* ************************************************************************
+//* ************************ DRAIN TASK ***************************
+//* ************************************************************************
+
+static uint32_t droppedRecords() {
+  return motionRing.droppedCount() + sharedRing.droppedCount();
+}
+
+// Format and print records from both rings, oldest first
+static void logDrainTask(void* parameter) {
+  LogRecord motionRecord;
+  LogRecord sharedRecord;
+  bool haveMotion = false;
+  bool haveShared = false;
+  uint32_t reportedDrops = 0;
+
+  for (;;) {
+    uint32_t fill = motionRing.size() + sharedRing.size();
+    if (fill > ringHighWater) ringHighWater = fill;
+
+    if (!haveMotion) haveMotion = motionRing.pop(motionRecord);
+    if (!haveShared) haveShared = sharedRing.pop(sharedRecord);
+
+    if (haveMotion && (!haveShared || motionRecord.timestamp <= sharedRecord.timestamp)) {
+      printLogRecord(motionRecord);
+      haveMotion = false;
+    } else if (haveShared) {
+      printLogRecord(sharedRecord);
+      haveShared = false;
+    } else {
+      // Rings empty - report overflow since the last report, then sleep
+      uint32_t dropped = droppedRecords();
+      if (dropped != reportedDrops) {
+        char notice[48];
+        snprintf(notice, sizeof(notice), "Logger: %lu records dropped", (unsigned long)(dropped - reportedDrops));
+        Serial.println(notice);
+        reportedDrops = dropped;
+      }
+      vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_IDLE_MS));
+    }
+  }
+}
+
+// Start the drain task
+void startLogDrain() {
+  drainRunning = true;
+  xTaskCreatePinnedToCore(logDrainTask, "log", LOG_TASK_STACK_SIZE, nullptr, LOG_TASK_PRIORITY, nullptr,
+                          COMMS_TASK_CORE);
+}
+
+LoggerStats getLoggerStats() {
+  LoggerStats stats;
+  stats.written = recordsWritten.load(std::memory_order_relaxed);
+  stats.dropped = droppedRecords();
+  stats.highWater = ringHighWater;
+  return stats;
+}
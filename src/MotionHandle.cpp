@@ -0,0 +1,56 @@
+#include "../include/MotionHandle.h"
+#include "../include/Utils.h"
+
+//* ************************************************************************
+//* ************************ MOTION HANDLES ***************************
+//* ************************************************************************
+// Move issue and completion callback dispatch. Callbacks are kept in a small
+// fixed table so no allocation happens per move.
+
+// Maximum number of moves with a completion callback in flight at once
+static const int MAX_MOTION_CALLBACKS = 8;
+
+struct PendingCallback {
+  MotionHandle handle;
+  MotionCallback callback;
+  void* context;
+};
+
+static PendingCallback pendingCallbacks[MAX_MOTION_CALLBACKS];
+
+// Start a move toward an absolute target and return its handle
+MotionHandle moveAxisTo(StepperAxis& axis, long target,
+                        MotionCallback onComplete, void* context) {
+  MotionHandle handle;
+  axis.moveTo(target);
+  handle.axis = &axis;
+  handle.sequence = axis.lastMoveSequence();
+  handle.target = target;
+
+  if (onComplete != nullptr) {
+    for (int i = 0; i < MAX_MOTION_CALLBACKS; i++) {
+      if (pendingCallbacks[i].callback == nullptr) {
+        pendingCallbacks[i].handle = handle;
+        pendingCallbacks[i].callback = onComplete;
+        pendingCallbacks[i].context = context;
+        return handle;
+      }
+    }
+    LOG_ERROR("Motion callback table full - completion callback dropped");
+  }
+  return handle;
+}
+
+// Fire completion callbacks for finished moves
+void updateMotion() {
+  for (int i = 0; i < MAX_MOTION_CALLBACKS; i++) {
+    PendingCallback& entry = pendingCallbacks[i];
+    if (entry.callback != nullptr && entry.handle.isDone()) {
+      MotionCallback callback = entry.callback;
+      void* context = entry.context;
+      entry.callback = nullptr;
+      entry.handle.reset();
+      callback(context);
+    }
+  }
+}
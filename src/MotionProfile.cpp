@@ -0,0 +1,230 @@
+#include "../include/MotionProfile.h"
+#include "../include/StepRamp.h"
+#include <math.h>
+
+//* ************************************************************************
+//* ************************ MOTION PROFILES ***************************
+//* ************************************************************************
+// S-curve ramp generation. The acceleration half of a move has up to three
+// phases: jerk up to peak acceleration, constant acceleration, jerk down to
+// zero acceleration at peak speed. Step times are found by inverting the
+// position function with Newton's method.
+
+// Shape of one acceleration ramp
+struct SCurveShape {
+  float peakSpeed;   // Speed reached at the end of the ramp
+  float peakAccel;   // Highest acceleration used
+  float jerkTime;    // Duration of each jerk phase
+  float constTime;   // Duration of the constant acceleration phase
+  float jerk;
+};
+
+// Ramp shape that reaches `speed` within the acceleration and jerk limits
+static SCurveShape shapeForSpeed(const ProfileLimits& limits, float speed) {
+  SCurveShape shape;
+  shape.peakSpeed = speed;
+  shape.jerk = limits.jerk;
+
+  float accel = limits.acceleration;
+  if (speed * limits.jerk >= accel * accel) {
+    // Peak acceleration is reached and held
+    shape.jerkTime = accel / limits.jerk;
+    shape.constTime = (speed - accel * accel / limits.jerk) / accel;
+    shape.peakAccel = accel;
+  } else {
+    // Speed is reached before the acceleration limit
+    shape.jerkTime = sqrtf(speed / limits.jerk);
+    shape.constTime = 0.0f;
+    shape.peakAccel = limits.jerk * shape.jerkTime;
+  }
+  return shape;
+}
+
+// Total ramp duration
+static float rampTime(const SCurveShape& shape) {
+  return 2.0f * shape.jerkTime + shape.constTime;
+}
+
+// Distance covered by the ramp (the profile is symmetric, so the average
+// speed over the ramp is half the peak speed)
+static float rampDistance(const SCurveShape& shape) {
+  return shape.peakSpeed * rampTime(shape) / 2.0f;
+}
+
+// Ramp shape for a move: full speed if the move is long enough, otherwise the
+// highest peak speed whose accel + decel ramps fit the distance
+static SCurveShape shapeForMove(const ProfileLimits& limits, float distance) {
+  SCurveShape shape = shapeForSpeed(limits, limits.maxSpeed);
+  if (2.0f * rampDistance(shape) <= distance) {
+    return shape;
+  }
+
+  float low = 0.0f;
+  float high = limits.maxSpeed;
+  for (int i = 0; i < 32; i++) {
+    float mid = (low + high) / 2.0f;
+    if (2.0f * rampDistance(shapeForSpeed(limits, mid)) <= distance) {
+      low = mid;
+    } else {
+      high = mid;
+    }
+  }
+  return shapeForSpeed(limits, low);
+}
+
+// Speed at time t into the ramp
+static float speedAt(const SCurveShape& s, float t) {
+  float t1 = s.jerkTime;
+  float t2 = s.jerkTime + s.constTime;
+  float v1 = s.jerk * t1 * t1 / 2.0f;
+
+  if (t <= t1) {
+    return s.jerk * t * t / 2.0f;
+  }
+  if (t <= t2) {
+    return v1 + s.peakAccel * (t - t1);
+  }
+  float v2 = v1 + s.peakAccel * s.constTime;
+  float tau = t - t2;
+  return v2 + s.peakAccel * tau - s.jerk * tau * tau / 2.0f;
+}
+
+// Position at time t into the ramp
+static float positionAt(const SCurveShape& s, float t) {
+  float t1 = s.jerkTime;
+  float t2 = s.jerkTime + s.constTime;
+  float v1 = s.jerk * t1 * t1 / 2.0f;
+  float p1 = s.jerk * t1 * t1 * t1 / 6.0f;
+
+  if (t <= t1) {
+    return s.jerk * t * t * t / 6.0f;
+  }
+  if (t <= t2) {
+    float tau = t - t1;
+    return p1 + v1 * tau + s.peakAccel * tau * tau / 2.0f;
+  }
+  float v2 = v1 + s.peakAccel * s.constTime;
+  float p2 = p1 + v1 * s.constTime + s.peakAccel * s.constTime * s.constTime / 2.0f;
+  float tau = t - t2;
+  return p2 + v2 * tau + s.peakAccel * tau * tau / 2.0f - s.jerk * tau * tau * tau / 6.0f;
+}
+
+//* ************************************************************************
+//* ************************ RAMP TABLES ***************************
+//* ************************************************************************
+
+// Build the acceleration-ramp step intervals for a move
+int buildSCurveRamp(const ProfileLimits& limits, long distance,
+                    uint16_t* intervals, int capacity, uint32_t* cruiseInterval) {
+  if (distance < 0) distance = -distance;
+  if (distance < 2 || limits.jerk <= 0.0f || limits.acceleration <= 0.0f) {
+    return -1;
+  }
+
+  // Gaps between steps; the accel and decel ramps each get at most half
+  long gaps = distance - 1;
+  SCurveShape shape = shapeForMove(limits, (float)gaps);
+  long rampSteps = (long)rampDistance(shape);
+  if (rampSteps > gaps / 2) rampSteps = gaps / 2;
+  if (rampSteps > capacity) {
+    return -1;
+  }
+
+  float previous = 0.0f;
+  float t = 0.0f;
+  for (long k = 1; k <= rampSteps; k++) {
+    // Initial guess from the current speed, or the closed form for the
+    // jerk phase when starting from rest
+    float speed = speedAt(shape, t);
+    t = (speed > 1.0f) ? t + 1.0f / speed : cbrtf(6.0f * (float)k / shape.jerk);
+
+    // Newton iterations on position(t) = k
+    for (int i = 0; i < 6; i++) {
+      float error = positionAt(shape, t) - (float)k;
+      float v = speedAt(shape, t);
+      if (v < 1e-3f || fabsf(error) < 1e-3f) break;
+      t -= error / v;
+    }
+    if (t < previous) t = previous;
+
+    float ticks = (t - previous) * STEP_TIMER_TICKS_PER_SEC + 0.5f;
+    if (ticks < 1.0f) ticks = 1.0f;
+    if (ticks > 65535.0f) ticks = 65535.0f;
+    intervals[k - 1] = (uint16_t)ticks;
+    previous = t;
+  }
+
+  float peak = (shape.peakSpeed > 1.0f) ? shape.peakSpeed : 1.0f;
+  *cruiseInterval = (uint32_t)((STEP_TIMER_TICKS_PER_SEC * (float)(1 << STEP_RAMP_FRACTION_BITS)) / peak);
+  return (int)rampSteps;
+}
+
+// Build the acceleration-ramp step intervals for a trapezoid move. Step k
+// from rest happens at t = sqrt(2k / a), so every interval is exact.
+int buildTrapezoidRamp(const ProfileLimits& limits, long distance,
+                       uint16_t* intervals, int capacity, uint32_t* cruiseInterval) {
+  if (distance < 0) distance = -distance;
+  if (distance < 2 || limits.acceleration <= 0.0f || limits.maxSpeed <= 0.0f) {
+    return -1;
+  }
+
+  long gaps = distance - 1;
+  long rampSteps = (long)(limits.maxSpeed * limits.maxSpeed / (2.0f * limits.acceleration));
+  float peakSpeed = limits.maxSpeed;
+  if (rampSteps > gaps / 2) {
+    // Triangle move - peak speed is whatever the ramp reaches
+    rampSteps = gaps / 2;
+    peakSpeed = sqrtf(2.0f * limits.acceleration * (float)(rampSteps + 1));
+  }
+  if (rampSteps > capacity) {
+    return -1;
+  }
+
+  float previous = 0.0f;
+  for (long k = 1; k <= rampSteps; k++) {
+    float t = sqrtf(2.0f * (float)k / limits.acceleration);
+    float ticks = (t - previous) * STEP_TIMER_TICKS_PER_SEC + 0.5f;
+    if (ticks < 1.0f) ticks = 1.0f;
+    if (ticks > 65535.0f) ticks = 65535.0f;
+    intervals[k - 1] = (uint16_t)ticks;
+    previous = t;
+  }
+
+  if (peakSpeed > limits.maxSpeed) peakSpeed = limits.maxSpeed;
+  *cruiseInterval = (uint32_t)((STEP_TIMER_TICKS_PER_SEC * (float)(1 << STEP_RAMP_FRACTION_BITS)) / peakSpeed);
+  return (int)rampSteps;
+}
+
+// Build the ramp for either profile type
+int buildProfileRamp(const ProfileLimits& limits, MotionProfileType type, long distance,
+                     uint16_t* intervals, int capacity, uint32_t* cruiseInterval) {
+  if (type == PROFILE_SCURVE) {
+    return buildSCurveRamp(limits, distance, intervals, capacity, cruiseInterval);
+  }
+  return buildTrapezoidRamp(limits, distance, intervals, capacity, cruiseInterval);
+}
+
+//* ************************************************************************
+//* ************************ MOVE TIME ESTIMATES ***************************
+//* ************************************************************************
+
+// Ideal duration of a move in seconds for the given profile type
+float estimateMoveTime(const ProfileLimits& limits, MotionProfileType type, long distance) {
+  float d = fabsf((float)distance);
+  if (d <= 0.0f) return 0.0f;
+
+  if (type == PROFILE_SCURVE && limits.jerk > 0.0f) {
+    SCurveShape shape = shapeForMove(limits, d);
+    float cruise = d - 2.0f * rampDistance(shape);
+    if (cruise < 0.0f) cruise = 0.0f;
+    return 2.0f * rampTime(shape) + cruise / shape.peakSpeed;
+  }
+
+  // Trapezoid: triangle if max speed is never reached
+  float v = limits.maxSpeed;
+  float a = limits.acceleration;
+  if (d >= v * v / a) {
+    return d / v + v / a;
+  }
+  return 2.0f * sqrtf(d / a);
+}
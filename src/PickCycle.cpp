@@ -3,6 +3,11 @@
 #include "Config/Pins_Definitions.h"
 #include "../include/TransferArm.h"
 #include "../include/Utils.h"
+#include "../include/BlendedMove.h"
+#include "../include/CycleProfiler.h"
+#include "../include/EventTrace.h"
+#include "../include/HeapAudit.h"
+#include "../include/TriggerCapture.h"
 
 //* ************************************************************************
 //* ************************ PICK CYCLE COORDINATOR ***************************
@@ -29,12 +34,22 @@ extern void initializeDropoffSequence();
 extern void updateDropoffSequence();
 extern DropoffSequenceState getCurrentDropoffState();
 
+extern void initializeHomingSequence();
+extern void updateHomingSequence();
+extern HomingSequenceState getCurrentHomingState();
+extern bool isHomingFaulted();
+
 extern void initializeCompletionSequence();
 extern void updateCompletionSequence();
 extern CompletionSequenceState getCurrentCompletionState();
 
+extern void emergencyStopAllSequences();
+
+extern bool stage2PickupWaiting;
+
 // Current main state
 enum MainState {
+  MAIN_HOMING,
   MAIN_IDLE,
   MAIN_PICKUP_SEQUENCE,
   MAIN_TRANSPORT_SEQUENCE,
@@ -44,23 +59,51 @@ enum MainState {
 
 MainState currentMainState = MAIN_IDLE;
 
-// Initialize the pick cycle system
+// Blended X/Z path shared by the cycle sequences. Each sequence may start a
+// path that the next one finishes, so Z lift/lower overlaps X travel.
+BlendedPath transferPath;
+
+static void startHoming();
+static void reportCurrentState();
+
+// Initialize the pick cycle system - starts with homing (automatic on startup)
 void initializePickCycle() {
-  currentMainState = MAIN_IDLE;
   initializeIdleState();
-  transferArm.disableXMotor();  // Ensure X motor starts disabled when idle
-  smartLog("Pick cycle system initialized");
+  LOG_INFO("Pick cycle system initialized");
+  startHoming();
+}
+
+// Enter the homing sequence with the X motor enabled
+static void startHoming() {
+  transferArm.enableXMotor();
+  currentMainState = MAIN_HOMING;
+  initializeHomingSequence();
 }
 
 // Update the pick cycle system
 void updatePickCycle() {
   switch (currentMainState) {
+    case MAIN_HOMING:
+      updateHomingSequence();
+      // Check if homing is complete
+      if (getCurrentHomingState() == HOMING_COMPLETE) {
+        LOG_INFO("Transitioning from homing to idle");
+        transferArm.disableXMotor();  // Ensure X motor is disabled when idle
+        currentMainState = MAIN_IDLE;
+        initializeIdleState();
+      }
+      break;
+
     case MAIN_IDLE:
       updateIdleState();
       // Check if idle state triggered a pick cycle
-      if (getCurrentIdleState() == TRIGGER_DETECTED) {
-        smartLog("Transitioning from idle to pickup sequence");
+      if (getCurrentIdleState() == TRIGGER_DETECTED && isHomingFaulted()) {
+        LOG_WARN("Homing fault - trigger ignored, re-home before starting a cycle");
+        initializeIdleState();
+      } else if (getCurrentIdleState() == TRIGGER_DETECTED) {
+        LOG_INFO("Transitioning from idle to pickup sequence");
         transferArm.enableXMotor();  // Enable X motor for pick cycle
+        transferPath.reset();
         currentMainState = MAIN_PICKUP_SEQUENCE;
         initializePickupSequence();
       }
@@ -70,7 +113,7 @@ void updatePickCycle() {
       updatePickupSequence();
       // Check if pickup sequence is complete
       if (getCurrentPickupState() == PICKUP_COMPLETE) {
-        smartLog("Transitioning from pickup to transport sequence");
+        LOG_INFO("Transitioning from pickup to transport sequence");
         currentMainState = MAIN_TRANSPORT_SEQUENCE;
         initializeTransportSequence();
       }
@@ -80,7 +123,7 @@ void updatePickCycle() {
       updateTransportSequence();
       // Check if transport sequence is complete
       if (getCurrentTransportState() == TRANSPORT_COMPLETE) {
-        smartLog("Transitioning from transport to dropoff sequence");
+        LOG_INFO("Transitioning from transport to dropoff sequence");
         currentMainState = MAIN_DROPOFF_SEQUENCE;
         initializeDropoffSequence();
       }
@@ -90,7 +133,7 @@ void updatePickCycle() {
       updateDropoffSequence();
       // Check if dropoff sequence is complete
       if (getCurrentDropoffState() == DROPOFF_COMPLETE) {
-        smartLog("Transitioning from dropoff to completion sequence");
+        LOG_INFO("Transitioning from dropoff to completion sequence");
         currentMainState = MAIN_COMPLETION_SEQUENCE;
         initializeCompletionSequence();
       }
@@ -100,18 +143,96 @@ void updatePickCycle() {
       updateCompletionSequence();
       // Check if completion sequence is complete
       if (getCurrentCompletionState() == COMPLETION_COMPLETE) {
-        smartLog("Transitioning from completion back to idle");
+        LOG_INFO("Transitioning from completion back to idle");
         transferArm.disableXMotor();  // Disable X motor when returning to idle
         currentMainState = MAIN_IDLE;
         initializeIdleState();
       }
       break;
   }
+
+  reportCurrentState();
+}
+
+// Halt wherever the cycle is: stop both axes, release the vacuum, end the
+// Stage 2 pulse and drop queued triggers, then wait in idle for the
+// operator to re-home or start a new cycle
+void emergencyStopPickCycle() {
+  emergencyStopAllSequences();
+  discardPendingTriggers();
+  transferPath.reset();
+  currentMainState = MAIN_IDLE;
+  initializeIdleState();
+}
+
+// Homed and waiting for a trigger
+bool isPickCycleIdle() {
+  return currentMainState == MAIN_IDLE;
+}
+
+// Sub-state of the active main state
+static uint8_t getCurrentSubState() {
+  switch (currentMainState) {
+    case MAIN_HOMING:
+      return getCurrentHomingState();
+    case MAIN_IDLE:
+      return getCurrentIdleState();
+    case MAIN_PICKUP_SEQUENCE:
+      return getCurrentPickupState();
+    case MAIN_TRANSPORT_SEQUENCE:
+      return getCurrentTransportState();
+    case MAIN_DROPOFF_SEQUENCE:
+      return getCurrentDropoffState();
+    case MAIN_COMPLETION_SEQUENCE:
+      return getCurrentCompletionState();
+  }
+  return 0;
+}
+
+// Report the active sequence and sub-state to the event trace and the
+// cycle profiler
+static void reportCurrentState() {
+  static int32_t lastTracedState = -1;
+
+  uint8_t subState = getCurrentSubState();
+  int32_t tracedState = ((int32_t)currentMainState << 8) | subState;
+  if (tracedState != lastTracedState) {
+    lastTracedState = tracedState;
+    traceEvent(TRACE_STATE, (uint8_t)currentMainState, subState);
+  }
+
+  CycleSequence sequence = CYCLE_SEQUENCE_NONE;
+  switch (currentMainState) {
+    case MAIN_PICKUP_SEQUENCE:
+      sequence = CYCLE_SEQUENCE_PICKUP;
+      break;
+    case MAIN_TRANSPORT_SEQUENCE:
+      sequence = CYCLE_SEQUENCE_TRANSPORT;
+      break;
+    case MAIN_DROPOFF_SEQUENCE:
+      sequence = CYCLE_SEQUENCE_DROPOFF;
+      break;
+    case MAIN_COMPLETION_SEQUENCE:
+      sequence = CYCLE_SEQUENCE_COMPLETION;
+      break;
+    default:
+      break;
+  }
+  setHeapAuditCycleActive(sequence != CYCLE_SEQUENCE_NONE);
+
+  bool stage2Waiting = stage2PickupWaiting || isWaitingForDescentGate();
+  profileCycleState(sequence, subState, sequence != CYCLE_SEQUENCE_NONE && stage2Waiting);
+}
+
+// Main state and sub-state packed into one byte (main state << 4 | sub-state)
+uint8_t getPickCyclePhase() {
+  return (uint8_t)((currentMainState << 4) | (getCurrentSubState() & 0x0F));
 }
 
 // Get current state (for compatibility with old interface)
 PickCycleState getCurrentState() {
   switch (currentMainState) {
+    case MAIN_HOMING:
     case MAIN_IDLE:
       return IDLE;
     case MAIN_PICKUP_SEQUENCE:
@@ -137,17 +258,29 @@ void setCurrentState(PickCycleState newState) {
       initializeIdleState();
       break;
     default:
-      smartLog("State change not implemented for: " + String(getStateString(newState)));
+      LOG_WARN("State change not implemented for: %s", getStateString(newState));
       break;
   }
 }
 
 // Trigger pick cycle from web interface
 void triggerPickCycleFromWeb() {
-  if (currentMainState == MAIN_IDLE) {
-    smartLog("Pick cycle triggered from web interface");
+  if (isHomingFaulted()) {
+    LOG_WARN("Homing fault - re-home before starting a cycle");
+  } else if (currentMainState == MAIN_IDLE) {
+    LOG_INFO("Pick cycle triggered from web interface");
     setIdleState(TRIGGER_DETECTED);
   } else {
-    smartLog("Pick cycle already in progress, ignoring web trigger");
+    LOG_WARN("Pick cycle already in progress, ignoring web trigger");
+  }
+}
+
+// Request a homing sequence (only accepted while idle)
+void requestHoming() {
+  if (currentMainState == MAIN_IDLE) {
+    LOG_INFO("Homing requested");
+    startHoming();
+  } else {
+    LOG_WARN("Machine busy, ignoring homing request");
   }
 } 
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "../include/PositionTrigger.h"
+#include "../include/TransferArm.h"
+#include "../include/Utils.h"
+
+//* ************************************************************************
+//* ************************ POSITION TRIGGERS ***************************
+//* ************************************************************************
+// Trigger table shared between the step ISRs and loop context. The table
+// is small and fixed, so the per-step check is a short scan, and it is
+// skipped entirely while nothing is armed.
+
+// Maximum number of triggers registered at once
+static const int MAX_POSITION_TRIGGERS = 8;
+
+// Trigger slot lifecycle
+enum TriggerSlotState {
+  TRIGGER_SLOT_FREE,
+  TRIGGER_SLOT_ARMED,     // Waiting for the position
+  TRIGGER_SLOT_DEFERRED,  // Position reached, action waiting for the loop
+  TRIGGER_SLOT_DONE       // Action carried out, slot recycled next loop
+};
+
+struct TriggerSlot {
+  StepperAxis* axis;
+  long position;
+  int8_t direction;
+  TriggerAction action;
+  int32_t argument;
+  volatile uint8_t state;
+  uint16_t generation;
+};
+
+static TriggerSlot triggerSlots[MAX_POSITION_TRIGGERS];
+static volatile uint8_t armedTriggerCount = 0;
+static portMUX_TYPE triggerLock = portMUX_INITIALIZER_UNLOCKED;
+
+//* ************************************************************************
+//* ************************ ISR PATH ***************************
+//* ************************************************************************
+
+// Step hook - called from the step ISR after every position change
+static void IRAM_ATTR onAxisStep(StepperAxis* axis, long position, int8_t direction) {
+  if (armedTriggerCount == 0) {
+    return;
+  }
+
+  portENTER_CRITICAL_ISR(&triggerLock);
+  for (int i = 0; i < MAX_POSITION_TRIGGERS; i++) {
+    TriggerSlot& slot = triggerSlots[i];
+    if (slot.state != TRIGGER_SLOT_ARMED || slot.axis != axis || slot.position != position ||
+        (slot.direction != TRIGGER_ANY && slot.direction != direction)) {
+      continue;
+    }
+
+    if (slot.action == TRIGGER_GPIO_SET || slot.action == TRIGGER_GPIO_CLEAR) {
+      traceDigitalWrite(slot.argument, slot.action == TRIGGER_GPIO_SET ? HIGH : LOW);
+      slot.state = TRIGGER_SLOT_DONE;
+    } else {
+      slot.state = TRIGGER_SLOT_DEFERRED;
+    }
+    armedTriggerCount--;
+  }
+  portEXIT_CRITICAL_ISR(&triggerLock);
+}
+
+//* ************************************************************************
+//* ************************ REGISTRATION ***************************
+//* ************************************************************************
+
+// Register a one-shot trigger
+PositionTrigger addPositionTrigger(StepperAxis& axis, long position, int8_t direction,
+                                   TriggerAction action, int32_t argument) {
+  PositionTrigger handle;
+  axis.setStepHook(onAxisStep);
+
+  portENTER_CRITICAL(&triggerLock);
+  for (int i = 0; i < MAX_POSITION_TRIGGERS; i++) {
+    TriggerSlot& slot = triggerSlots[i];
+    if (slot.state == TRIGGER_SLOT_FREE) {
+      slot.axis = &axis;
+      slot.position = position;
+      slot.direction = direction;
+      slot.action = action;
+      slot.argument = argument;
+      slot.generation++;
+      slot.state = TRIGGER_SLOT_ARMED;
+      armedTriggerCount++;
+      handle.slot = i;
+      handle.generation = slot.generation;
+      break;
+    }
+  }
+  portEXIT_CRITICAL(&triggerLock);
+
+  if (handle.isIdle()) {
+    LOG_ERROR("Position trigger table full - trigger dropped");
+  }
+  return handle;
+}
+
+// Registered and waiting for its position
+bool PositionTrigger::isArmed() const {
+  if (slot < 0) return false;
+  const TriggerSlot& entry = triggerSlots[slot];
+  return entry.generation == generation && entry.state == TRIGGER_SLOT_ARMED;
+}
+
+// Position reached and action carried out. A freed or reused slot means
+// the trigger fired earlier (cancelled triggers reset their handle).
+bool PositionTrigger::hasFired() const {
+  if (slot < 0) return false;
+  const TriggerSlot& entry = triggerSlots[slot];
+  return entry.generation != generation ||
+         (entry.state != TRIGGER_SLOT_ARMED && entry.state != TRIGGER_SLOT_DEFERRED);
+}
+
+// Disarm the trigger if it has not fired yet and reset the handle
+void PositionTrigger::cancel() {
+  if (slot >= 0) {
+    portENTER_CRITICAL(&triggerLock);
+    TriggerSlot& entry = triggerSlots[slot];
+    if (entry.generation == generation && entry.state == TRIGGER_SLOT_ARMED) {
+      entry.state = TRIGGER_SLOT_FREE;
+      armedTriggerCount--;
+    }
+    portEXIT_CRITICAL(&triggerLock);
+  }
+  reset();
+}
+
+//* ************************************************************************
+//* ************************ LOOP CONTEXT ***************************
+//* ************************************************************************
+
+// Run deferred trigger actions and recycle fired triggers
+void updatePositionTriggers() {
+  for (int i = 0; i < MAX_POSITION_TRIGGERS; i++) {
+    TriggerSlot& slot = triggerSlots[i];
+    switch (slot.state) {
+      case TRIGGER_SLOT_DEFERRED:
+        if (slot.action == TRIGGER_SERVO_WRITE) {
+          transferArm.setServoPosition((float)slot.argument);
+        } else if (slot.action == TRIGGER_BURST_REQUEST) {
+          transferArm.sendBurstRequest();
+        } else if (slot.action == TRIGGER_STAGE_SIGNAL) {
+          signalStage2();
+        }
+        slot.state = TRIGGER_SLOT_DONE;
+        break;
+
+      case TRIGGER_SLOT_DONE:
+        // Handles still see the trigger as fired through the generation
+        slot.state = TRIGGER_SLOT_FREE;
+        break;
+
+      default:
+        break;
+    }
+  }
+}
@@ -0,0 +1,128 @@
+#include "../include/PulseOutput.h"
+#include "../include/EventTrace.h"
+#include "../include/Utils.h"
+#include "Config/Config.h"
+#include "Config/Pins_Definitions.h"
+#include <esp_timer.h>
+
+//* ************************************************************************
+//* ************************ PULSE OUTPUTS ***************************
+//* ************************************************************************
+
+struct PulseOutput {
+  const char* name;
+  uint8_t pin;
+  uint8_t activeLevel;
+  uint32_t widthMs;
+  esp_timer_handle_t timer;
+  volatile bool active;
+  int64_t endMicros;  // esp_timer_get_time() when the pulse is due to end
+};
+
+static PulseOutput pulseOutputs[PULSE_CHANNEL_COUNT];
+static portMUX_TYPE pulseLock = portMUX_INITIALIZER_UNLOCKED;  // Caller task vs esp_timer task
+
+// A timer restarted just as it fired may still deliver the old expiry; it
+// only ends the pulse once the current end time is (almost) reached
+static const int64_t PULSE_END_SLACK_MICROS = 50;
+
+static uint8_t idleLevel(const PulseOutput& output) {
+  return output.activeLevel == HIGH ? LOW : HIGH;
+}
+
+// Timer callback (esp_timer task) - end the pulse
+static void handlePulseEnd(void* context) {
+  PulseOutput& output = *(PulseOutput*)context;
+  portENTER_CRITICAL(&pulseLock);
+  if (output.active && esp_timer_get_time() - output.endMicros >= -PULSE_END_SLACK_MICROS) {
+    traceDigitalWrite(output.pin, idleLevel(output));
+    output.active = false;
+  }
+  portEXIT_CRITICAL(&pulseLock);
+}
+
+// Fill one table entry and create its timer
+static void configurePulseOutput(PulseChannel channel, const char* name, int pin, uint8_t activeLevel,
+                                 uint32_t widthMs) {
+  PulseOutput& output = pulseOutputs[channel];
+  output.name = name;
+  output.pin = (uint8_t)pin;
+  output.activeLevel = activeLevel;
+  output.widthMs = widthMs;
+  output.active = false;
+  output.endMicros = 0;
+
+  pinMode(output.pin, OUTPUT);
+  traceDigitalWrite(output.pin, idleLevel(output));
+
+  esp_timer_create_args_t timerArgs = {};
+  timerArgs.callback = handlePulseEnd;
+  timerArgs.arg = &output;
+  timerArgs.dispatch_method = ESP_TIMER_TASK;
+  timerArgs.name = name;
+  if (esp_timer_create(&timerArgs, &output.timer) != ESP_OK) {
+    output.timer = nullptr;
+    LOG_ERROR("Pulse output %s: timer unavailable", name);
+  }
+}
+
+// Create the timers and drive every output to its idle level
+void beginPulseOutputs() {
+  configurePulseOutput(PULSE_STAGE2_SIGNAL, "stage2 pulse", STAGE2_SIGNAL_PIN,
+                       STAGE2_SIGNAL_ACTIVE_HIGH ? HIGH : LOW, STAGE2_SIGNAL_PULSE_MS);
+  LOG_INFO("Pulse outputs configured");
+}
+
+//* ************************************************************************
+//* ************************ CONTROL ***************************
+//* ************************************************************************
+
+// Start a pulse of the configured width
+bool pulseOutput(PulseChannel channel) {
+  return pulseOutputFor(channel, pulseOutputs[channel].widthMs);
+}
+
+// Start a pulse of a specific width
+bool pulseOutputFor(PulseChannel channel, uint32_t widthMs) {
+  PulseOutput& output = pulseOutputs[channel];
+  if (output.timer == nullptr) {
+    return false;
+  }
+
+  esp_timer_stop(output.timer);  // Restart if already running (fails harmlessly when idle)
+  portENTER_CRITICAL(&pulseLock);
+  output.endMicros = esp_timer_get_time() + (int64_t)widthMs * 1000;
+  output.active = true;
+  traceDigitalWrite(output.pin, output.activeLevel);
+  portEXIT_CRITICAL(&pulseLock);
+  if (esp_timer_start_once(output.timer, (uint64_t)widthMs * 1000) == ESP_OK) {
+    return true;
+  }
+
+  // Nothing would end the pulse - do not leave the output stuck active
+  portENTER_CRITICAL(&pulseLock);
+  output.active = false;
+  traceDigitalWrite(output.pin, idleLevel(output));
+  portEXIT_CRITICAL(&pulseLock);
+  LOG_ERROR("Pulse output %s: timer start failed", output.name);
+  return false;
+}
+
+// End any pulse now and drive the output to its idle level
+void endPulseOutput(PulseChannel channel) {
+  PulseOutput& output = pulseOutputs[channel];
+  if (output.name == nullptr) {
+    return;  // Not configured yet
+  }
+  if (output.timer != nullptr) {
+    esp_timer_stop(output.timer);
+  }
+  portENTER_CRITICAL(&pulseLock);
+  output.active = false;
+  traceDigitalWrite(output.pin, idleLevel(output));
+  portEXIT_CRITICAL(&pulseLock);
+}
+
+bool isPulseActive(PulseChannel channel) {
+  return pulseOutputs[channel].active;
+}
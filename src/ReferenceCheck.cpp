@@ -0,0 +1,97 @@
+#include "../include/ReferenceCheck.h"
+#include "../include/TransferArm.h"
+#include "../include/Homing.h"
+#include "../include/Utils.h"
+
+//* ************************************************************************
+//* ************************ X REFERENCE CHECK ***************************
+//* ************************************************************************
+
+// Policy state
+static bool returnPlanned = false;
+static XReturnPlan returnPlan = X_RETURN_DIRECT;
+static unsigned long cyclesSinceHome = 0;
+static unsigned long cycleCount = 0;
+static unsigned long lastHomeCount = 0;
+static DriftTelemetry driftTelemetry = {0, 0, 0, 0};
+
+// Choose the plan for this cycle's return move and return its X target
+long startXReturn() {
+  if (!returnPlanned) {
+    // Any homing since the last cycle restarts the count
+    unsigned long homeCount = getXHomingTelemetry().homeCount;
+    if (homeCount != lastHomeCount) {
+      lastHomeCount = homeCount;
+      cyclesSinceHome = 0;
+    }
+    cyclesSinceHome++;
+    cycleCount++;
+
+    if (X_REHOME_INTERVAL_CYCLES > 0 && cyclesSinceHome >= X_REHOME_INTERVAL_CYCLES) {
+      returnPlan = X_RETURN_REHOME;
+    } else if (X_DRIFT_CHECK_INTERVAL_CYCLES > 0 && cycleCount % X_DRIFT_CHECK_INTERVAL_CYCLES == 0) {
+      returnPlan = X_RETURN_DRIFT_CHECK;
+      transferArm.getXHomeLatch().arm();
+    } else {
+      returnPlan = X_RETURN_DIRECT;
+    }
+    returnPlanned = true;
+  }
+
+  switch (returnPlan) {
+    case X_RETURN_REHOME:
+      return X_HOME_POS + HOME_BACKOFF_STEPS;  // Homing re-touches from here
+    case X_RETURN_DRIFT_CHECK:
+      return X_HOME_POS - X_DRIFT_CHECK_OVERTRAVEL_STEPS;  // Just past the switch edge
+    default:
+      return X_PICKUP_POS;
+  }
+}
+
+// Current plan
+XReturnPlan getXReturnPlan() {
+  return returnPlan;
+}
+
+// Evaluate the return move; true if X must be re-homed
+bool finishXReturn() {
+  returnPlanned = false;
+  SwitchLatch& latch = transferArm.getXHomeLatch();
+
+  switch (returnPlan) {
+    case X_RETURN_REHOME:
+      LOG_INFO("X re-home due after %lu cycles", cyclesSinceHome);
+      return true;
+
+    case X_RETURN_DRIFT_CHECK: {
+      if (!latch.isLatched()) {
+        latch.disarm();
+        driftTelemetry.rehomes++;
+        LOG_WARN("X drift check: home switch not seen, re-homing");
+        return true;
+      }
+
+      long drift = latch.latchedPosition() - X_HOME_POS;
+      driftTelemetry.checks++;
+      driftTelemetry.lastDrift = drift;
+      if (labs(drift) > driftTelemetry.maxAbsDrift) {
+        driftTelemetry.maxAbsDrift = labs(drift);
+      }
+
+      bool outOfTolerance = labs(drift) > X_DRIFT_TOLERANCE_STEPS;
+      LOG_INFO("X drift check: switch edge at %ld steps, drift %ld steps (tolerance %ld)%s",
+               latch.latchedPosition(), drift, X_DRIFT_TOLERANCE_STEPS, outOfTolerance ? " - re-homing" : "");
+      if (outOfTolerance) {
+        driftTelemetry.rehomes++;
+      }
+      return outOfTolerance;
+    }
+
+    default:
+      return false;
+  }
+}
+
+const DriftTelemetry& getXDriftTelemetry() {
+  return driftTelemetry;
+}
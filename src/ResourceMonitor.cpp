@@ -0,0 +1,214 @@
+#include "../include/ResourceMonitor.h"
+#include "../include/Utils.h"
+#include "Config/Config.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+//* ************************************************************************
+//* ************************ RESOURCE MONITOR ***************************
+//* ************************************************************************
+
+static const char* const RESOURCE_TASK_NAMES[RESOURCE_TASK_COUNT] = {"motion", "comms", "log"};
+
+static ResourceSample latestSample;
+static bool haveSample = false;
+static uint8_t activeWarnings = 0;
+static portMUX_TYPE sampleLock = portMUX_INITIALIZER_UNLOCKED;  // Comms task writes, motion task reads
+
+// Worst values of the current history interval, then the history ring
+static ResourceSample intervalWorst;
+static bool intervalStarted = false;
+static ResourceSample history[RESOURCE_HISTORY_SAMPLES];
+static uint8_t historyNext = 0;
+static uint8_t historyCount = 0;
+
+static uint32_t lastSampleMs = 0;
+
+// Read heap and stack headroom now
+static ResourceSample takeSample() {
+  ResourceSample sample;
+  sample.timestamp = millis();
+  sample.freeHeap = ESP.getFreeHeap();
+  sample.minFreeHeap = ESP.getMinFreeHeap();
+  sample.largestFreeBlock = ESP.getMaxAllocHeap();
+  for (uint8_t i = 0; i < RESOURCE_TASK_COUNT; i++) {
+    TaskHandle_t handle = xTaskGetHandle(RESOURCE_TASK_NAMES[i]);
+    sample.stackFree[i] = (handle != nullptr) ? uxTaskGetStackHighWaterMark(handle) : 0;
+  }
+  return sample;
+}
+
+uint8_t getFragmentationPercent(const ResourceSample& sample) {
+  if (sample.freeHeap == 0) {
+    return 100;
+  }
+  return (uint8_t)(100 - (uint64_t)sample.largestFreeBlock * 100 / sample.freeHeap);
+}
+
+// Warning bits for one sample
+static uint8_t checkThresholds(const ResourceSample& sample) {
+  uint8_t warnings = 0;
+  if (sample.freeHeap < RESOURCE_MIN_FREE_HEAP_BYTES) warnings |= RESOURCE_WARNING_LOW_HEAP;
+  if (sample.largestFreeBlock < RESOURCE_MIN_LARGEST_BLOCK_BYTES) warnings |= RESOURCE_WARNING_SMALL_BLOCK;
+  if (getFragmentationPercent(sample) > RESOURCE_MAX_FRAGMENTATION_PERCENT) warnings |= RESOURCE_WARNING_FRAGMENTED;
+  for (uint8_t i = 0; i < RESOURCE_TASK_COUNT; i++) {
+    if (sample.stackFree[i] != 0 && sample.stackFree[i] < RESOURCE_MIN_STACK_FREE_BYTES) {
+      warnings |= RESOURCE_WARNING_LOW_STACK;
+    }
+  }
+  return warnings;
+}
+
+// Log warnings that started or cleared since the last sample
+static void logWarningChanges(uint8_t previous, uint8_t current, const ResourceSample& sample) {
+  uint8_t started = current & ~previous;
+  uint8_t cleared = previous & ~current;
+  if (started & RESOURCE_WARNING_LOW_HEAP) {
+    LOG_WARN("Free heap low: %lu bytes (warning below %lu)", (unsigned long)sample.freeHeap,
+             (unsigned long)RESOURCE_MIN_FREE_HEAP_BYTES);
+  }
+  if (started & RESOURCE_WARNING_SMALL_BLOCK) {
+    LOG_WARN("Largest free block small: %lu bytes (warning below %lu)", (unsigned long)sample.largestFreeBlock,
+             (unsigned long)RESOURCE_MIN_LARGEST_BLOCK_BYTES);
+  }
+  if (started & RESOURCE_WARNING_FRAGMENTED) {
+    LOG_WARN("Heap fragmented: %u%% of free heap unusable as one block", getFragmentationPercent(sample));
+  }
+  if (started & RESOURCE_WARNING_LOW_STACK) {
+    for (uint8_t i = 0; i < RESOURCE_TASK_COUNT; i++) {
+      if (sample.stackFree[i] != 0 && sample.stackFree[i] < RESOURCE_MIN_STACK_FREE_BYTES) {
+        LOG_WARN("Task %s stack low: %lu bytes free", RESOURCE_TASK_NAMES[i], (unsigned long)sample.stackFree[i]);
+      }
+    }
+  }
+  if (cleared != 0) {
+    LOG_INFO("Resource warnings cleared (0x%02x)", cleared);
+  }
+}
+
+// Fold a sample into the worst values of the current history interval
+static void accumulateInterval(const ResourceSample& sample) {
+  if (!intervalStarted) {
+    intervalWorst = sample;
+    intervalStarted = true;
+    return;
+  }
+  intervalWorst.timestamp = sample.timestamp;
+  intervalWorst.minFreeHeap = sample.minFreeHeap;
+  if (sample.freeHeap < intervalWorst.freeHeap) intervalWorst.freeHeap = sample.freeHeap;
+  if (sample.largestFreeBlock < intervalWorst.largestFreeBlock) {
+    intervalWorst.largestFreeBlock = sample.largestFreeBlock;
+  }
+  for (uint8_t i = 0; i < RESOURCE_TASK_COUNT; i++) {
+    if (sample.stackFree[i] < intervalWorst.stackFree[i]) intervalWorst.stackFree[i] = sample.stackFree[i];
+  }
+}
+
+// Comms task: take a sample when one is due
+void updateResourceMonitor() {
+  uint32_t now = millis();
+  if (haveSample && now - lastSampleMs < RESOURCE_SAMPLE_PERIOD_MS) {
+    return;
+  }
+  lastSampleMs = now;
+
+  ResourceSample sample = takeSample();
+  uint8_t warnings = checkThresholds(sample);
+  logWarningChanges(activeWarnings, warnings, sample);
+
+  portENTER_CRITICAL(&sampleLock);
+  latestSample = sample;
+  activeWarnings = warnings;
+  haveSample = true;
+  portEXIT_CRITICAL(&sampleLock);
+
+  accumulateInterval(sample);
+  if (historyCount == 0 || now - history[(historyNext + RESOURCE_HISTORY_SAMPLES - 1) % RESOURCE_HISTORY_SAMPLES]
+                                         .timestamp >= RESOURCE_HISTORY_PERIOD_MS) {
+    portENTER_CRITICAL(&sampleLock);
+    history[historyNext] = intervalWorst;
+    historyNext = (historyNext + 1) % RESOURCE_HISTORY_SAMPLES;
+    if (historyCount < RESOURCE_HISTORY_SAMPLES) historyCount++;
+    portEXIT_CRITICAL(&sampleLock);
+    intervalStarted = false;
+  }
+}
+
+bool getResourceSample(ResourceSample& sample) {
+  portENTER_CRITICAL(&sampleLock);
+  sample = latestSample;
+  bool valid = haveSample;
+  portEXIT_CRITICAL(&sampleLock);
+  return valid;
+}
+
+uint8_t getResourceWarnings() {
+  return activeWarnings;
+}
+
+//* ************************************************************************
+//* ************************ REPORTING ***************************
+//* ************************************************************************
+
+// Change per hour between two history entries
+static long perHour(uint32_t from, uint32_t to, uint32_t elapsedMs) {
+  if (elapsedMs == 0) {
+    return 0;
+  }
+  return (long)(((int64_t)to - (int64_t)from) * 3600000LL / (int64_t)elapsedMs);
+}
+
+// Print the latest sample, warnings, trend and history
+void reportResourceMonitor() {
+  ResourceSample sample;
+  if (!getResourceSample(sample)) {
+    Serial.println("Resource monitor: no sample yet");
+    return;
+  }
+
+  serialPrintf("Heap: %lu free, %lu lowest since boot, largest block %lu (%u%% fragmented)\n",
+               (unsigned long)sample.freeHeap, (unsigned long)sample.minFreeHeap,
+               (unsigned long)sample.largestFreeBlock, getFragmentationPercent(sample));
+  Serial.print("Stack free:");
+  for (uint8_t i = 0; i < RESOURCE_TASK_COUNT; i++) {
+    serialPrintf(" %s %lu", RESOURCE_TASK_NAMES[i], (unsigned long)sample.stackFree[i]);
+  }
+  Serial.println(" bytes");
+
+  uint8_t warnings = getResourceWarnings();
+  serialPrintf("Warnings: %s%s%s%s%s\n", warnings == 0 ? "none" : "",
+               (warnings & RESOURCE_WARNING_LOW_HEAP) ? "low-heap " : "",
+               (warnings & RESOURCE_WARNING_SMALL_BLOCK) ? "small-block " : "",
+               (warnings & RESOURCE_WARNING_FRAGMENTED) ? "fragmented " : "",
+               (warnings & RESOURCE_WARNING_LOW_STACK) ? "low-stack" : "");
+
+  // Copy the history so printing does not hold the lock
+  ResourceSample entries[RESOURCE_HISTORY_SAMPLES];
+  portENTER_CRITICAL(&sampleLock);
+  uint8_t count = historyCount;
+  uint8_t first = (historyNext + RESOURCE_HISTORY_SAMPLES - historyCount) % RESOURCE_HISTORY_SAMPLES;
+  for (uint8_t i = 0; i < count; i++) {
+    entries[i] = history[(first + i) % RESOURCE_HISTORY_SAMPLES];
+  }
+  portEXIT_CRITICAL(&sampleLock);
+
+  if (count >= 2) {
+    const ResourceSample& oldest = entries[0];
+    const ResourceSample& newest = entries[count - 1];
+    uint32_t elapsed = newest.timestamp - oldest.timestamp;
+    serialPrintf("Trend over %.1f h: free heap %+ld bytes/h, largest block %+ld bytes/h\n", elapsed / 3600000.0f,
+                 perHour(oldest.freeHeap, newest.freeHeap, elapsed),
+                 perHour(oldest.largestFreeBlock, newest.largestFreeBlock, elapsed));
+  }
+
+  serialPrintf("History (worst per %lu min):\n", (unsigned long)(RESOURCE_HISTORY_PERIOD_MS / 60000));
+  Serial.println("  uptime_min   free_heap  largest_blk  frag%  motion_stk  comms_stk  log_stk");
+  for (uint8_t i = 0; i < count; i++) {
+    const ResourceSample& entry = entries[i];
+    serialPrintf("  %10lu %11lu %12lu %6u %11lu %10lu %8lu\n", (unsigned long)(entry.timestamp / 60000),
+                 (unsigned long)entry.freeHeap, (unsigned long)entry.largestFreeBlock,
+                 getFragmentationPercent(entry), (unsigned long)entry.stackFree[RESOURCE_TASK_MOTION],
+                 (unsigned long)entry.stackFree[RESOURCE_TASK_COMMS],
+                 (unsigned long)entry.stackFree[RESOURCE_TASK_LOG]);
+  }
+}
@@ -2,6 +2,7 @@
 #include "../../Config/Pins_Definitions.h"
 #include "../../../include/TransferArm.h"
 #include "../../../include/Utils.h"
+#include "../../../include/TriggerCapture.h"
 
 //* ************************************************************************
 //* ************************ IDLE FUNCTIONS ***************************
@@ -10,9 +11,12 @@
 
 // Check if pick cycle should be triggered
 bool checkPickCycleTrigger() {
-  // Check start button or Stage 1 signal
-  if (transferArm.getStartButton().read() == HIGH ||
-      transferArm.getStage1Signal().read() == HIGH) {
+  // Start button or Stage 1 edge captured by interrupt (including ones that
+  // arrived while the previous cycle was running)
+  CapturedTrigger trigger;
+  if (takeTrigger(trigger)) {
+    LOG_DEBUG("Trigger from %s, %lu us ago", trigger.source == TRIGGER_SOURCE_STAGE1 ? "Stage 1" : "start button",
+              (unsigned long)(micros() - trigger.timestamp));
     return true;
   }
   return false;
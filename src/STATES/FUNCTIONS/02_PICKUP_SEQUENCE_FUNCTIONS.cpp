@@ -2,10 +2,14 @@
 #include "../../Config/Pins_Definitions.h"
 #include "../../../include/TransferArm.h"
 #include "../../../include/Utils.h"
+#include "../../../include/PositionTrigger.h"
 
 // External variable to track vacuum activation
 extern bool vacuumActivatedDuringDescent;
 
+// Step-accurate vacuum trigger for the current descent
+PositionTrigger vacuumTrigger;
+
 //* ************************************************************************
 //* ************************ PICKUP SEQUENCE FUNCTIONS ***************************
 //* ************************************************************************
@@ -16,23 +20,49 @@ void setupZAxisForPickup() {
   // Initialize Z-axis to normal speed and acceleration
   transferArm.getZStepper().setMaxSpeed(Z_MAX_SPEED);
   transferArm.getZStepper().setAcceleration(Z_ACCELERATION);
-  smartLog("Z-axis configured for pickup operations");
-  delay(100);
+  LOG_DEBUG("Z-axis configured for pickup operations");
+}
+
+// Arm the vacuum to switch on from the step ISR when Z passes the suction
+// start position on the way down (call before starting the descent)
+void armVacuumDuringDescent() {
+  vacuumTrigger.cancel();
+  if (transferArm.getZStepper().currentPosition() >= Z_SUCTION_START_POS) {
+    // Already below the suction start position - switch on now
+    traceDigitalWrite(SOLENOID_RELAY_PIN, HIGH);
+    vacuumActivatedDuringDescent = true;
+    LOG_DEBUG("Vacuum activated before descent at Z: %ld", transferArm.getZStepper().currentPosition());
+    return;
+  }
+  vacuumTrigger = addPositionTrigger(transferArm.getZStepper(), Z_SUCTION_START_POS,
+                                     TRIGGER_FORWARD, TRIGGER_GPIO_SET, SOLENOID_RELAY_PIN);
+  if (vacuumTrigger.isIdle()) {
+    LOG_WARN("Vacuum trigger unavailable - vacuum will switch on at the bottom");
+  }
 }
 
-// Activate vacuum during Z descent when reaching the suction start position
-void activateVacuumDuringDescent() {
-  if (!vacuumActivatedDuringDescent &&
-      transferArm.getZStepper().currentPosition() >= Z_SUCTION_START_POS) {
-    digitalWrite(SOLENOID_RELAY_PIN, HIGH);
+// Track the vacuum trigger during Z descent. Called once the descent is
+// complete with descentComplete set, so the vacuum is on even if the
+// trigger could not be used.
+void activateVacuumDuringDescent(bool descentComplete) {
+  if (vacuumActivatedDuringDescent) {
+    return;
+  }
+  if (vacuumTrigger.hasFired()) {
+    vacuumTrigger.reset();
+    vacuumActivatedDuringDescent = true;
+    LOG_DEBUG("Vacuum activated during descent at Z: %ld", Z_SUCTION_START_POS);
+  } else if (descentComplete) {
+    vacuumTrigger.cancel();
+    traceDigitalWrite(SOLENOID_RELAY_PIN, HIGH);
     vacuumActivatedDuringDescent = true;
-    smartLog("Vacuum activated during descent at Z: " +
-             String(transferArm.getZStepper().currentPosition()));
+    LOG_DEBUG("Vacuum activated at end of descent");
   }
 }
 
 // Reset pickup sequence variables
 void resetPickupSequence() {
+  vacuumTrigger.cancel();
   vacuumActivatedDuringDescent = false;
-  smartLog("Pickup sequence variables reset");
+  LOG_DEBUG("Pickup sequence variables reset");
 } 
\ No newline at end of file
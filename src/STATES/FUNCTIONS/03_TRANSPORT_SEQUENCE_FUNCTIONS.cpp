@@ -11,34 +11,16 @@
 // Set servo to travel position with logging
 void setServoToTravelPosition() {
   transferArm.setServoPosition(SERVO_TRAVEL_POS);
-  smartLog("Servo set to travel position: " + String(SERVO_TRAVEL_POS));
+  LOG_DEBUG("Servo set to travel position: %.2f", SERVO_TRAVEL_POS);
 }
 
 // Set servo to dropoff position with logging
 void setServoToDropoffPosition() {
   transferArm.setServoPosition(SERVO_DROPOFF_POS);
-  smartLog("Servo set to dropoff position: " + String(SERVO_DROPOFF_POS));
-}
-
-// Move to overshoot position - BLOCKING
-bool moveToOvershootPosition() {
-  transferArm.getXStepper().moveTo(X_DROPOFF_OVERSHOOT_POS);
-  smartLog("Moving X to overshoot position: " + String(X_DROPOFF_OVERSHOOT_POS));
-  transferArm.getXStepper().runToPosition();  // Blocking call
-  smartLog("X reached overshoot position");
-  return true;
-}
-
-// Move to final dropoff position - BLOCKING
-bool moveToDropoffPosition() {
-  transferArm.getXStepper().moveTo(X_DROPOFF_POS);
-  smartLog("Moving X to dropoff position: " + String(X_DROPOFF_POS));
-  transferArm.getXStepper().runToPosition();  // Blocking call
-  smartLog("X reached dropoff position");
-  return true;
+  LOG_DEBUG("Servo set to dropoff position: %.2f", SERVO_DROPOFF_POS);
 }
 
 // Get current X position for debugging
-float getCurrentXPosition() {
+long getCurrentXPosition() {
   return transferArm.getXStepper().currentPosition();
 } 
\ No newline at end of file
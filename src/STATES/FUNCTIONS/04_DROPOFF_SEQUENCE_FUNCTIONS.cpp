@@ -12,28 +12,27 @@
 void setupZAxisForDropoff() {
   transferArm.getZStepper().setMaxSpeed(Z_DROPOFF_MAX_SPEED);
   transferArm.getZStepper().setAcceleration(Z_DROPOFF_ACCELERATION);
-  smartLog("Z-axis configured for slower dropoff movement");
-  smartLog("Max Speed: " + String(Z_DROPOFF_MAX_SPEED) + 
-           ", Acceleration: " + String(Z_DROPOFF_ACCELERATION));
+  LOG_DEBUG("Z-axis configured for slower dropoff movement");
+  LOG_DEBUG("Max Speed: %.2f, Acceleration: %.2f", q16ToFloat(Z_DROPOFF_MAX_SPEED),
+           q16ToFloat(Z_DROPOFF_ACCELERATION));
 }
 
 // Release the object by turning off vacuum
 void releaseObject() {
-  digitalWrite(SOLENOID_RELAY_PIN, LOW);
-  smartLog("Vacuum solenoid turned OFF - object released");
+  traceDigitalWrite(SOLENOID_RELAY_PIN, LOW);
+  LOG_DEBUG("Vacuum solenoid turned OFF - object released");
 }
 
 // Restore Z-axis to normal speed and acceleration for upward movement
 void restoreZAxisToNormalSpeed() {
   transferArm.getZStepper().setMaxSpeed(Z_MAX_SPEED);
   transferArm.getZStepper().setAcceleration(Z_ACCELERATION);
-  smartLog("Z-axis speed restored to normal for upward movement");
-  smartLog("Max Speed: " + String(Z_MAX_SPEED) + 
-           ", Acceleration: " + String(Z_ACCELERATION));
+  LOG_DEBUG("Z-axis speed restored to normal for upward movement");
+  LOG_DEBUG("Max Speed: %.2f, Acceleration: %.2f", q16ToFloat(Z_MAX_SPEED), q16ToFloat(Z_ACCELERATION));
 }
 
 // Get current Z position for debugging
-float getCurrentZPosition() {
+long getCurrentZPosition() {
   return transferArm.getZStepper().currentPosition();
 }
 
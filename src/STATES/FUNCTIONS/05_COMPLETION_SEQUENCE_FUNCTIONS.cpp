@@ -2,6 +2,7 @@
 #include "../../Config/Pins_Definitions.h"
 #include "../../../include/TransferArm.h"
 #include "../../../include/Utils.h"
+#include "../../../include/PulseOutput.h"
 
 //* ************************************************************************
 //* ************************ COMPLETION SEQUENCE FUNCTIONS ***************************
@@ -10,38 +11,27 @@
 
 // Setup Stage 2 signal pin
 void setupStage2Signal() {
-  pinMode(STAGE2_SIGNAL_PIN, OUTPUT);
-  digitalWrite(STAGE2_SIGNAL_PIN, LOW);  // Initialize as LOW
-  smartLog("Stage 2 signal pin configured as output, initialized LOW");
+  endPulseOutput(PULSE_STAGE2_SIGNAL);  // Idle level, no pulse left running
+  LOG_DEBUG("Stage 2 signal output at idle level");
 }
 
 // Reset servo to pickup position
 void resetServoToPickupPosition() {
   transferArm.setServoPosition(SERVO_PICKUP_POS);
-  smartLog("Servo reset to pickup position: " + String(SERVO_PICKUP_POS));
-}
-
-// Move to pickup position with logging - BLOCKING
-bool moveToPickupPosition() {
-  transferArm.getXStepper().moveTo(X_PICKUP_POS);
-  smartLog("Moving X to pickup position: " + String(X_PICKUP_POS));
-  transferArm.getXStepper().runToPosition();  // Blocking call
-  smartLog("X reached pickup position");
-  return true;  // Movement is guaranteed complete
+  LOG_DEBUG("Servo reset to pickup position: %.2f", SERVO_PICKUP_POS);
 }
 
 // Check if at pickup position
 bool isAtPickupPosition() {
-  float currentPos = transferArm.getXStepper().currentPosition();
-  float tolerance = 1.0;  // Allow 1 unit tolerance
-  return abs(currentPos - X_PICKUP_POS) <= tolerance;
+  long currentPos = transferArm.getXStepper().currentPosition();
+  long tolerance = 1;  // Allow 1 step tolerance
+  return labs(currentPos - X_PICKUP_POS) <= tolerance;
 }
 
-// Get completion sequence status for debugging
-String getCompletionStatusString() {
-  String status = "Completion Status - ";
-  status += "X Position: " + String(transferArm.getXStepper().currentPosition());
-  status += ", Target: " + String(X_PICKUP_POS);
-  status += ", Servo: " + String(transferArm.getServoPosition());
-  return status;
+// Format the completion sequence status for debugging (returns the text length)
+size_t formatCompletionStatus(char* buffer, size_t size) {
+  int length = snprintf(buffer, size, "Completion Status - X Position: %ld, Target: %ld, Servo: %.2f",
+                        transferArm.getXStepper().currentPosition(), X_PICKUP_POS,
+                        transferArm.getServoPosition());
+  return (length > 0) ? (size_t)length : 0;
 } 
\ No newline at end of file
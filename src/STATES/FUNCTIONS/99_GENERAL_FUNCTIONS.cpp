@@ -2,12 +2,13 @@
 #include "../../Config/Pins_Definitions.h"
 #include "../../../include/TransferArm.h"
 #include "../../../include/Utils.h"
+#include "../../../include/PulseOutput.h"
 
 //* ************************************************************************
 //* ************************ GENERAL FUNCTIONS ***************************
 //* ************************************************************************
 // General utility functions used across multiple state sequences
-// Note: moveToPosition and Wait functions are implemented in Utils.cpp
+// Note: movement helpers and the Wait function are implemented in Utils.cpp
 
 // Get state string for debugging (placeholder - specific implementations in each state)
 const char* getStateString(int state) {
@@ -23,16 +24,15 @@ const char* getStateString(int state) {
 
 // Initialize all state sequences
 void initializeAllStateSequences() {
-  // Initialize Stage 2 signal pin
-  pinMode(STAGE2_SIGNAL_PIN, OUTPUT);
-  digitalWrite(STAGE2_SIGNAL_PIN, LOW);
+  // Stage 2 signal output at its idle level
+  endPulseOutput(PULSE_STAGE2_SIGNAL);
   
-  smartLog("All state sequences initialized");
+  LOG_DEBUG("All state sequences initialized");
 }
 
 // Reset all sequence timers and flags
 void resetAllSequenceVariables() {
-  smartLog("All sequence variables reset");
+  LOG_DEBUG("All sequence variables reset");
 }
 
 // Emergency stop function for all sequences
@@ -42,10 +42,10 @@ void emergencyStopAllSequences() {
   transferArm.getZStepper().stop();
   
   // Turn off vacuum
-  digitalWrite(SOLENOID_RELAY_PIN, LOW);
+  traceDigitalWrite(SOLENOID_RELAY_PIN, LOW);
   
-  // Turn off Stage 2 signal
-  digitalWrite(STAGE2_SIGNAL_PIN, LOW);
+  // Turn off Stage 2 signal (ends a pulse in progress)
+  endPulseOutput(PULSE_STAGE2_SIGNAL);
   
-  smartLog("EMERGENCY STOP - All sequences halted");
+  LOG_ERROR("EMERGENCY STOP - All sequences halted");
 } 
\ No newline at end of file
@@ -2,7 +2,7 @@
 #include "../../Config/Pins_Definitions.h"
 #include "../../../include/TransferArm.h"
 #include "../../../include/Utils.h"
-#include <AccelStepper.h>
+#include "../../../include/Homing.h"
 #include <Arduino.h>
 #include <Bounce2.h>
 
@@ -10,100 +10,273 @@
 //* ************************ HOMING FUNCTIONS ***************************
 //* ************************************************************************
 // This file contains all the individual functions needed for the homing sequence.
-// Each axis has its own dedicated homing function with proper limit switch handling.
+// Both axes home the same way:
+//   1. Fast approach with deceleration. An axis that is already referenced
+//      heads for a point just off the switch; otherwise it searches toward
+//      the switch and decelerates once the switch edge is latched.
+//   2. Back off until the switch opens again.
+//   3. Slow re-touch; the step count at the switch edge becomes home.
+// If the switch never releases during back-off the axis finishes with a
+// homing fault instead. The fault latches until that axis homes again, and
+// cycles, triggers and manual moves are refused while it is set.
+// The switch edge is captured by a GPIO interrupt (SwitchLatch), so the
+// reference does not depend on debounce time or loop rate. The latch only
+// reports the edge once the debounced switch has stayed closed for
+// HOME_SWITCH_CONFIRM_MS, so a noise spike re-arms it instead of ending
+// the approach or setting home at the wrong step. Homing is
+// non-blocking: start*() begins the move and update*() is polled from the
+// homing state machine until it returns true.
 
-// Home the Z axis
-void homeZAxis() {
-  smartLog("Homing Z axis...");
+// Progress of a single axis homing move
+enum AxisHomingPhase {
+  AXIS_HOMING_FAST_APPROACH,
+  AXIS_HOMING_BACK_OFF,
+  AXIS_HOMING_RETOUCH,
+  AXIS_HOMING_DONE
+};
 
-  // Move towards home switch
-  transferArm.getZStepper().setSpeed(-Z_HOME_SPEED);  // Slow speed in negative direction
+// Back-off moves allowed before giving up on the switch opening
+const int HOME_BACKOFF_MAX_ATTEMPTS = 4;
 
-  // Keep stepping until home switch is triggered (active HIGH)
-  while (transferArm.getZHomeSwitch().read() == LOW) {
-    transferArm.getZStepper().runSpeed();
-    transferArm.getZHomeSwitch().update();
-    yield();  // Allow ESP32 to handle background tasks
-  }
+// Homing state for one axis
+struct AxisHoming {
+  const char* name;
+  StepperAxis* axis;
+  Bounce* homeSwitch;
+  SwitchLatch* latch;
+  q16_t fastSpeed;
+  q16_t slowSpeed;
+  q16_t maxSpeed;       // Limits restored after homing
+  q16_t acceleration;
+  long searchSteps;
+  long homePos;
+
+  AxisHomingPhase phase;
+  bool referenced;      // Homed at least once since boot
+  bool faulted;         // Last homing failed; cleared by a successful one
+  bool stopping;        // stop() issued after the fast approach latched
+  int backoffAttempts;
+  unsigned long startTime;
+  HomingTelemetry telemetry;
+};
+
+AxisHoming xHoming = {"X"};
+AxisHoming zHoming = {"Z"};
 
-  // Stop the motor
-  transferArm.getZStepper().stop();
+//* ************************************************************************
+//* ************************ COMMON ***************************
+//* ************************************************************************
 
-  // Set current position as home
-  transferArm.getZStepper().setCurrentPosition(Z_HOME_POS);
+// Bind the axis hardware and limits (done on every start so the state
+// does not depend on static initialization order)
+static void bindAxisHoming(AxisHoming& homing, StepperAxis& axis, Bounce& homeSwitch,
+                           SwitchLatch& latch, q16_t fastSpeed, q16_t slowSpeed,
+                           q16_t maxSpeed, q16_t acceleration, long searchSteps, long homePos) {
+  homing.axis = &axis;
+  homing.homeSwitch = &homeSwitch;
+  homing.latch = &latch;
+  homing.fastSpeed = fastSpeed;
+  homing.slowSpeed = slowSpeed;
+  homing.maxSpeed = maxSpeed;
+  homing.acceleration = acceleration;
+  homing.searchSteps = searchSteps;
+  homing.homePos = homePos;
+}
 
-  smartLog("Z axis homed");
+// Move away from the switch so the re-touch sees a fresh edge
+static void beginBackOff(AxisHoming& homing, long from) {
+  homing.axis->setMaxSpeed(homing.fastSpeed);
+  homing.axis->moveTo(from + HOME_BACKOFF_STEPS);  // Positive direction (away from home)
+  homing.phase = AXIS_HOMING_BACK_OFF;
 }
 
-// Home the X axis  
-void homeXAxis() {
-  smartLog("Homing X axis...");
-  smartLog("Initial home switch state: " + String(transferArm.getXHomeSwitch().read() ? "HIGH" : "LOW"));
-
-  // Check if X home switch is already activated
-  transferArm.getXHomeSwitch().update();
-  if (transferArm.getXHomeSwitch().read() == HIGH) {
-    smartLog("X home switch already triggered. Setting position as home.");
-    transferArm.getXStepper().stop();
-    transferArm.getXStepper().setCurrentPosition(X_HOME_POS);
-
-    // Move away from the switch a small amount to prevent future issues
-    smartLog("Moving away from the switch slightly...");
-    transferArm.getXStepper().setSpeed(X_HOME_SPEED);  // Positive direction (away from home)
-
-    // Step until switch is released or max steps reached
-    float safetyCounter = 0.0;
-    transferArm.getXHomeSwitch().update();
-    while (transferArm.getXHomeSwitch().read() == HIGH && safetyCounter < 200.0) {
-      transferArm.getXStepper().runSpeed();
-      transferArm.getXHomeSwitch().update();
-      safetyCounter += 1.0;
-      yield();
-    }
-
-    // Stop and set position to a small positive value
-    transferArm.getXStepper().stop();
-    transferArm.getXStepper().setCurrentPosition(50.0);  // Small offset from home
-    smartLog("Backed off from switch by " + String(safetyCounter) + " steps");
-
-    smartLog("X axis homed");
+// Creep back onto the switch at slow speed
+static void beginRetouch(AxisHoming& homing) {
+  homing.latch->arm();
+  homing.axis->jog(-homing.slowSpeed);  // Slow speed in negative direction
+  homing.phase = AXIS_HOMING_RETOUCH;
+}
+
+// Start homing an axis
+static void startAxisHoming(AxisHoming& homing) {
+  LOG_INFO("Homing %s axis...", homing.name);
+  homing.startTime = millis();
+  homing.stopping = false;
+  homing.backoffAttempts = 0;
+  homing.axis->setMaxSpeed(homing.fastSpeed);
+  homing.axis->setAcceleration(HOME_ACCELERATION);
+
+  // Check if the home switch is already activated
+  if (homing.homeSwitch->read() == HIGH) {
+    LOG_WARN("%s home switch already triggered, backing off", homing.name);
+    homing.latch->disarm();
+    beginBackOff(homing, homing.axis->currentPosition());
     return;
   }
 
-  // Move towards home switch
-  transferArm.getXStepper().setSpeed(-X_HOME_SPEED);  // Slow speed in negative direction
+  // Fast approach: straight to just off the switch if the reference is
+  // known, otherwise search toward the switch
+  long current = homing.axis->currentPosition();
+  long approach = homing.homePos + HOME_BACKOFF_STEPS;
+  long target = (homing.referenced && current >= approach) ? approach : current - homing.searchSteps;
+  homing.latch->arm();
+  homing.axis->moveTo(target);
+  homing.phase = AXIS_HOMING_FAST_APPROACH;
+}
+
+// Set the reference from the latched switch edge and record telemetry
+static void finishAxisHoming(AxisHoming& homing) {
+  long edge = homing.latch->latchedPosition();
+  HomingTelemetry& telemetry = homing.telemetry;
+
+  // Where the previous reference put the switch edge (drift since the last home)
+  if (homing.referenced) {
+    long error = edge - homing.homePos;
+    telemetry.lastLatchError = error;
+    telemetry.latchSamples++;
+    float delta = (float)error - telemetry.latchMean;
+    telemetry.latchMean += delta / (float)telemetry.latchSamples;
+    telemetry.latchM2 += delta * ((float)error - telemetry.latchMean);
+  }
+
+  // The switch edge becomes home; the axis has crept slightly past it
+  homing.axis->setCurrentPosition(homing.axis->currentPosition() - edge + homing.homePos);
+  homing.axis->setMaxSpeed(homing.maxSpeed);
+  homing.axis->setAcceleration(homing.acceleration);
 
-  // Keep stepping until home switch is triggered (active HIGH)
-  while (transferArm.getXHomeSwitch().read() == LOW) {
-    transferArm.getXStepper().runSpeed();
-    transferArm.getXHomeSwitch().update();
-    yield();  // Allow ESP32 to handle background tasks
+  homing.referenced = true;
+  homing.faulted = false;
+  homing.phase = AXIS_HOMING_DONE;
+  telemetry.homeCount++;
+  telemetry.lastDurationMs = millis() - homing.startTime;
+
+  if (telemetry.latchSamples > 0) {
+    LOG_INFO("%s axis homed in %lu ms, switch edge error %ld steps", homing.name, telemetry.lastDurationMs,
+             telemetry.lastLatchError);
+  } else {
+    LOG_INFO("%s axis homed in %lu ms", homing.name, telemetry.lastDurationMs);
   }
+}
 
-  // Stop the motor
-  transferArm.getXStepper().stop();
+// Returns true once the axis has finished homing (check isHomingFaulted())
+static bool updateAxisHoming(AxisHoming& homing) {
+  switch (homing.phase) {
+    case AXIS_HOMING_FAST_APPROACH:
+      if (homing.latch->isLatched()) {
+        // Switch edge reached at speed - decelerate, then back off
+        if (!homing.stopping) {
+          homing.axis->stop();
+          homing.stopping = true;
+        }
+        if (!homing.axis->isRunning()) {
+          beginBackOff(homing, homing.latch->latchedPosition());
+        }
+      } else if (!homing.axis->isRunning()) {
+        // Approach finished without touching the switch - find it slowly
+        if (!homing.referenced) {
+          LOG_WARN("%s home switch not found at speed, continuing slowly", homing.name);
+        }
+        homing.latch->disarm();
+        beginRetouch(homing);
+      }
+      break;
 
-  // Set current position as home
-  transferArm.getXStepper().setCurrentPosition(X_HOME_POS);
+    case AXIS_HOMING_BACK_OFF:
+      if (homing.axis->isRunning()) {
+        break;
+      }
+      if (homing.homeSwitch->read() == HIGH) {
+        if (++homing.backoffAttempts >= HOME_BACKOFF_MAX_ATTEMPTS) {
+          LOG_ERROR("%s home switch did not release - homing fault, check switch and re-home", homing.name);
+          homing.axis->setMaxSpeed(homing.maxSpeed);
+          homing.axis->setAcceleration(homing.acceleration);
+          homing.faulted = true;
+          homing.telemetry.faultCount++;
+          homing.phase = AXIS_HOMING_DONE;
+          break;
+        }
+        beginBackOff(homing, homing.axis->currentPosition());
+        break;
+      }
+      beginRetouch(homing);
+      break;
 
-  // Move away from the switch a small amount
-  smartLog("Moving away from the switch slightly...");
-  transferArm.getXStepper().setSpeed(X_HOME_SPEED);  // Positive direction (away from home)
+    case AXIS_HOMING_RETOUCH:
+      // Wait until the switch edge is latched (active HIGH)
+      if (homing.latch->isLatched()) {
+        // Stop the motor and set the switch edge as home
+        homing.axis->stop();
+        if (!homing.axis->isRunning()) {
+          finishAxisHoming(homing);
+        }
+      }
+      break;
 
-  // Step until switch is released or max steps reached
-  float safetyCounter = 0.0;
-  transferArm.getXHomeSwitch().update();
-  while (transferArm.getXHomeSwitch().read() == HIGH && safetyCounter < 200.0) {
-    transferArm.getXStepper().runSpeed();
-    transferArm.getXHomeSwitch().update();
-    safetyCounter += 1.0;
-    yield();
+    case AXIS_HOMING_DONE:
+      break;
   }
+  return homing.phase == AXIS_HOMING_DONE;
+}
 
-  // Stop and set position to a small positive value
-  transferArm.getXStepper().stop();
-  transferArm.getXStepper().setCurrentPosition(50.0);  // Small offset from home
-  smartLog("Backed off from switch by " + String(safetyCounter) + " steps");
+//* ************************************************************************
+//* ************************ Z AXIS ***************************
+//* ************************************************************************
 
-  smartLog("X axis homed");
-}
\ No newline at end of file
+// Start homing the Z axis
+void startHomeZAxis() {
+  bindAxisHoming(zHoming, transferArm.getZStepper(), transferArm.getZHomeSwitch(),
+                 transferArm.getZHomeLatch(), Z_HOME_FAST_SPEED, Z_HOME_SPEED,
+                 Z_MAX_SPEED, Z_ACCELERATION, Z_HOME_SEARCH_STEPS, Z_HOME_POS);
+  startAxisHoming(zHoming);
+}
+
+// Returns true once the Z axis is homed
+bool updateHomeZAxis() {
+  return updateAxisHoming(zHoming);
+}
+
+//* ************************************************************************
+//* ************************ X AXIS ***************************
+//* ************************************************************************
+
+// Start homing the X axis
+void startHomeXAxis() {
+  bindAxisHoming(xHoming, transferArm.getXStepper(), transferArm.getXHomeSwitch(),
+                 transferArm.getXHomeLatch(), X_HOME_FAST_SPEED, X_HOME_SPEED,
+                 X_MAX_SPEED, X_ACCELERATION, X_HOME_SEARCH_STEPS, X_HOME_POS);
+  startAxisHoming(xHoming);
+}
+
+// Returns true once the X axis is homed
+bool updateHomeXAxis() {
+  return updateAxisHoming(xHoming);
+}
+
+//* ************************************************************************
+//* ************************ FAULT ***************************
+//* ************************************************************************
+
+// True while either axis' last homing failed
+bool isHomingFaulted() {
+  return xHoming.faulted || zHoming.faulted;
+}
+
+//* ************************************************************************
+//* ************************ TELEMETRY ***************************
+//* ************************************************************************
+
+const HomingTelemetry& getXHomingTelemetry() {
+  xHoming.telemetry.switchGlitches = transferArm.getXHomeLatch().getGlitchCount();
+  return xHoming.telemetry;
+}
+
+const HomingTelemetry& getZHomingTelemetry() {
+  zHoming.telemetry.switchGlitches = transferArm.getZHomeLatch().getGlitchCount();
+  return zHoming.telemetry;
+}
+
+// Sample variance of the switch edge error in steps^2
+float getHomingLatchVariance(const HomingTelemetry& telemetry) {
+  if (telemetry.latchSamples < 2) return 0.0f;
+  return telemetry.latchM2 / (float)(telemetry.latchSamples - 1);
+}
@@ -22,7 +22,7 @@ unsigned long idleStateTimer = 0;
 void initializeIdleState() {
   currentIdleState = IDLE_WAIT;
   idleStateTimer = 0;
-  smartLog("Idle state initialized - ready for pick cycle trigger");
+  LOG_DEBUG("Idle state initialized - ready for pick cycle trigger");
 }
 
 // Update the idle state machine
@@ -31,7 +31,7 @@ void updateIdleState() {
     case IDLE_WAIT:
       // Check for pick cycle trigger
       if (checkPickCycleTrigger()) {
-        smartLog("Pick Cycle Triggered from idle state");
+        LOG_INFO("Pick Cycle Triggered from idle state");
         currentIdleState = TRIGGER_DETECTED;
         idleStateTimer = 0;
       }
@@ -39,7 +39,7 @@ void updateIdleState() {
       
     case TRIGGER_DETECTED:
       // Transition to pickup sequence will be handled by main state machine
-      smartLog("Transitioning to pickup sequence");
+      LOG_DEBUG("Transitioning to pickup sequence");
       currentIdleState = IDLE_WAIT;  // Reset for next cycle
       break;
   }
@@ -2,14 +2,15 @@
 #include "../../Config/Pins_Definitions.h"
 #include "../../../include/TransferArm.h"
 #include "../../../include/Utils.h"
+#include "../../../include/BlendedMove.h"
 
 // Forward declarations for functions defined in 02_PICKUP_SEQUENCE_FUNCTIONS.cpp
 void initializePickupSequence();
 void updatePickupSequence();
-bool moveToPosition(AccelStepper& stepper, float targetPosition);
 bool Wait(unsigned long duration, unsigned long* timer);
 void setupZAxisForPickup();
-void activateVacuumDuringDescent();
+void armVacuumDuringDescent();
+void activateVacuumDuringDescent(bool descentComplete);
 
 //* ************************************************************************
 //* ************************ PICKUP SEQUENCE ***************************
@@ -25,35 +26,43 @@ void activateVacuumDuringDescent();
 PickupSequenceState currentPickupState = PICKUP_MOVE_TO_PICKUP_POS;
 unsigned long pickupStateTimer = 0;
 bool vacuumActivatedDuringDescent = false;
+MotionHandle pickupMotion;
+extern BlendedPath transferPath;  // Defined in PickCycle.cpp
+LogThrottle stage2PickupWait(LOG_LEVEL_INFO, "Waiting for Stage 2 safety signal before Z lowering");
+bool stage2PickupWaiting = false;  // Held at pickup by Stage 2 (read by the cycle profiler)
 
 // Initialize the pickup sequence
 void initializePickupSequence() {
   currentPickupState = PICKUP_MOVE_TO_PICKUP_POS;
   pickupStateTimer = 0;
   vacuumActivatedDuringDescent = false;
+  stage2PickupWaiting = false;
+  pickupMotion.reset();
   setupZAxisForPickup();
-  smartLog("Pickup sequence initialized");
+  LOG_DEBUG("Pickup sequence initialized");
 }
 
 // Update the pickup sequence state machine
 void updatePickupSequence() {
   switch (currentPickupState) {
     case PICKUP_MOVE_TO_PICKUP_POS:
-      // Move X-axis to pickup position - BLOCKING
-      transferArm.getXStepper().moveTo(X_PICKUP_POS);
-      smartLog("Moving X to pickup position: " + String(X_PICKUP_POS));
-      transferArm.getXStepper().runToPosition();  // Blocking call
-      smartLog("X reached pickup position. Triggering photo capture...");
+      // Move X-axis to pickup position
+      if (pickupMotion.isIdle()) {
+        pickupMotion = moveXToPickup();
+      }
+      if (!pickupMotion.isDone()) {
+        break;  // Still moving
+      }
+      pickupMotion.reset();
+      LOG_DEBUG("Triggering photo capture...");
       
       // Trigger photo capture on Raspberry Pi
       transferArm.sendBurstRequest();
       
-      smartLog("Photo capture triggered. Lowering Z to pickup.");
-      smartLog("Target Z: " + String(Z_PICKUP_POS) +
-               ", Suction Start Z: " + String(Z_SUCTION_START_POS));
+      LOG_DEBUG("Photo capture triggered. Lowering Z to pickup.");
+      LOG_DEBUG("Target Z: %ld, Suction Start Z: %ld", Z_PICKUP_POS, Z_SUCTION_START_POS);
       transferArm.setServoPosition(SERVO_PICKUP_POS);
       vacuumActivatedDuringDescent = false;
-      transferArm.getZStepper().moveTo(Z_PICKUP_POS);
       //! Step 1: Lower Z-axis for Pickup
       currentPickupState = PICKUP_LOWER_Z_FOR_PICKUP;
       break;
@@ -62,14 +71,24 @@ void updatePickupSequence() {
       // Check Stage 2 safety signal before lowering Z axis
       if (!transferArm.isStage2SafeForZLowering()) {
         // Wait for Stage 2 to signal it's safe (pin goes low)
+        stage2PickupWait.hit();
+        stage2PickupWaiting = true;
         return;  // Stay in this state until safe
       }
+      stage2PickupWait.clear();
+      stage2PickupWaiting = false;
+
+      // Lower Z axis - the vacuum switches on from the step ISR at the
+      // suction start position
+      if (pickupMotion.isIdle()) {
+        armVacuumDuringDescent();
+        pickupMotion = moveZToPickup();
+      }
+      activateVacuumDuringDescent(pickupMotion.isDone());
       
-      // Lower Z axis and activate vacuum mid-way
-      activateVacuumDuringDescent();
-      
-      if (transferArm.getZStepper().distanceToGo() == 0) {
-        smartLog("Z fully lowered for pickup, waiting");
+      if (pickupMotion.isDone()) {
+        LOG_DEBUG("Z fully lowered for pickup, waiting");
+        pickupMotion.reset();
         pickupStateTimer = 0;
         //! Step 2: Wait at Pickup Position
         currentPickupState = PICKUP_WAIT_AT_PICKUP_POS;
@@ -79,24 +98,27 @@ void updatePickupSequence() {
     case PICKUP_WAIT_AT_PICKUP_POS:
       // Wait for hold time at pickup position
       if (Wait(PICKUP_HOLD_TIME, &pickupStateTimer)) {
-        smartLog("Pickup wait complete, raising Z-axis with object");
+        LOG_DEBUG("Pickup wait complete, raising Z-axis with object");
         //! Step 3: Raise Z-axis with Object
         currentPickupState = PICKUP_RAISE_Z_WITH_OBJECT;
       }
       break;
 
     case PICKUP_RAISE_Z_WITH_OBJECT:
-      // Raise Z axis with object
-      transferArm.getZStepper().moveTo(Z_UP_POS);
-      if (transferArm.getZStepper().distanceToGo() == 0) {
-        smartLog("Z-axis raised with object, pickup sequence complete");
+      // Raise Z axis with object - X leaves for the dropoff side as soon as Z
+      // is inside the clearance envelope (transport finishes the move)
+      if (transferPath.isIdle()) {
+        transferPath = startBlendedMove(getTransportXTarget(), Z_UP_POS, Z_UP_POS);
+      }
+      if (transferPath.isXReleased()) {
+        LOG_DEBUG("Z-axis clear with object, pickup sequence complete");
         currentPickupState = PICKUP_COMPLETE;
       }
       break;
       
     case PICKUP_COMPLETE:
       // Pickup sequence finished, ready to transition to transport
-      smartLog("Pickup sequence complete, ready for transport");
+      LOG_DEBUG("Pickup sequence complete, ready for transport");
       currentPickupState = PICKUP_MOVE_TO_PICKUP_POS;  // Reset for next cycle
       break;
   }
@@ -112,4 +134,5 @@ void setPickupState(PickupSequenceState newState) {
   currentPickupState = newState;
   pickupStateTimer = 0;
   vacuumActivatedDuringDescent = false;
+  pickupMotion.reset();
 } 
\ No newline at end of file
@@ -2,11 +2,12 @@
 #include "../../Config/Pins_Definitions.h"
 #include "../../../include/TransferArm.h"
 #include "../../../include/Utils.h"
+#include "../../../include/BlendedMove.h"
+#include "../../../include/PositionTrigger.h"
 
 // Forward declarations for functions defined in 03_TRANSPORT_SEQUENCE_FUNCTIONS.cpp
 void initializeTransportSequence();
 void updateTransportSequence();
-bool moveToPosition(AccelStepper& stepper, float targetPosition);
 bool Wait(unsigned long duration, unsigned long* timer);
 
 //* ************************************************************************
@@ -14,19 +15,25 @@ bool Wait(unsigned long duration, unsigned long* timer);
 //* ************************************************************************
 // This state handles transporting the object to the dropoff area including:
 // - Rotating servo to travel position
-// - Moving to dropoff overshoot position
-// - Rotating servo to dropoff position
-// - Moving back to dropoff position
+// - Moving to dropoff, rotating the servo as X passes X_SERVO_ROTATE_POS
+//   (TRANSPORT_MODE_ROTATE_IN_MOTION), or
+// - Moving to dropoff overshoot position, rotating servo to dropoff position
+//   and moving back to dropoff position (TRANSPORT_MODE_OVERSHOOT)
 
 // State variables
 TransportSequenceState currentTransportState = TRANSPORT_ROTATE_SERVO_TO_TRAVEL;
 unsigned long transportStateTimer = 0;
+bool servoRotationStarted = false;
+PositionTrigger servoRotateTrigger;
+extern BlendedPath transferPath;  // Defined in PickCycle.cpp
 
 // Initialize the transport sequence
 void initializeTransportSequence() {
   currentTransportState = TRANSPORT_ROTATE_SERVO_TO_TRAVEL;
   transportStateTimer = 0;
-  smartLog("Transport sequence initialized");
+  servoRotationStarted = false;
+  servoRotateTrigger.cancel();
+  LOG_DEBUG("Transport sequence initialized");
 }
 
 // Update the transport sequence state machine
@@ -35,44 +42,103 @@ void updateTransportSequence() {
     case TRANSPORT_ROTATE_SERVO_TO_TRAVEL:
       // Rotate servo to travel position after pickup
       transferArm.setServoPosition(SERVO_TRAVEL_POS);
-      smartLog("Servo rotated to travel position, moving to dropoff overshoot");
-      //! Step 1: Move to Dropoff Overshoot Position
-      currentTransportState = TRANSPORT_MOVE_TO_OVERSHOOT;
+      servoRotationStarted = false;
+      if (TRANSPORT_MODE == TRANSPORT_MODE_ROTATE_IN_MOTION) {
+        LOG_DEBUG("Servo rotated to travel position, moving to dropoff");
+        //! Step 1: Move to Dropoff Position, rotating servo on the way
+        currentTransportState = TRANSPORT_ROTATE_SERVO_IN_MOTION;
+      } else {
+        LOG_DEBUG("Servo rotated to travel position, moving to dropoff overshoot");
+        //! Step 1: Move to Dropoff Overshoot Position
+        currentTransportState = TRANSPORT_MOVE_TO_OVERSHOOT;
+      }
+      break;
+
+    case TRANSPORT_ROTATE_SERVO_IN_MOTION:
+      // Move X straight to dropoff. The pickup sequence normally started this
+      // move while Z was still rising.
+      if (transferPath.isIdle()) {
+        transferPath = startBlendedMove(X_DROPOFF_POS, Z_UP_POS, Z_UP_POS);
+      }
+      // The servo rotation fires on the step where X passes X_SERVO_ROTATE_POS
+      if (!servoRotationStarted && servoRotateTrigger.isIdle()) {
+        if (transferArm.getXStepper().currentPosition() >= X_SERVO_ROTATE_POS) {
+          LOG_DEBUG("X already past servo rotate position, rotating servo to dropoff position");
+          transferArm.setServoPosition(SERVO_DROPOFF_POS);
+          servoRotationStarted = true;
+        } else {
+          servoRotateTrigger = addPositionTrigger(transferArm.getXStepper(), X_SERVO_ROTATE_POS,
+                                                  TRIGGER_FORWARD, TRIGGER_SERVO_WRITE,
+                                                  (int32_t)SERVO_DROPOFF_POS);
+        }
+      }
+      if (servoRotateTrigger.hasFired()) {
+        LOG_DEBUG("X passed servo rotate position, servo rotating to dropoff position");
+        servoRotateTrigger.reset();
+        servoRotationStarted = true;
+      }
+      if (!transferPath.isDone()) {
+        break;  // Still moving
+      }
+      if (!servoRotationStarted && !servoRotateTrigger.isIdle() && !servoRotateTrigger.isArmed()) {
+        break;  // Trigger fired - the servo write runs on the next loop pass
+      }
+      transferPath.reset();
+      if (!servoRotationStarted) {
+        // Rotate position was never crossed - rotate now
+        servoRotateTrigger.cancel();
+        transferArm.setServoPosition(SERVO_DROPOFF_POS);
+        servoRotationStarted = true;
+      }
+      //! Step 2: Wait out the rest of the servo rotation
+      currentTransportState = TRANSPORT_WAIT_FOR_SERVO_ROTATION;
       break;
 
     case TRANSPORT_MOVE_TO_OVERSHOOT:
-      // Move X axis to overshoot position (4 inches past dropoff) - BLOCKING
-      transferArm.getXStepper().moveTo(X_DROPOFF_OVERSHOOT_POS);
-      smartLog("Moving X to dropoff overshoot position: " + String(X_DROPOFF_OVERSHOOT_POS));
-      transferArm.getXStepper().runToPosition();  // Blocking call
-      smartLog("X reached dropoff overshoot position, rotating servo to dropoff position");
+      // Move X axis to overshoot position (past dropoff). The pickup sequence
+      // normally started this move while Z was still rising.
+      if (transferPath.isIdle()) {
+        transferPath = startBlendedMove(X_DROPOFF_OVERSHOOT_POS, Z_UP_POS, Z_UP_POS);
+      }
+      if (!transferPath.isDone()) {
+        break;  // Still moving
+      }
+      transferPath.reset();
+      LOG_DEBUG("Rotating servo to dropoff position");
       transferArm.setServoPosition(SERVO_DROPOFF_POS);
-      transportStateTimer = 0;
+      servoRotationStarted = true;
       //! Step 2: Wait for Servo Rotation
       currentTransportState = TRANSPORT_WAIT_FOR_SERVO_ROTATION;
       break;
 
     case TRANSPORT_WAIT_FOR_SERVO_ROTATION:
-      // Wait for servo to complete rotation at overshoot position
-      if (Wait(SERVO_ROTATION_WAIT_TIME, &transportStateTimer)) {
-        smartLog("Servo rotation complete, returning to dropoff position");
-        //! Step 3: Return to Dropoff Position
+      // Wait until the servo has had SERVO_ROTATION_WAIT_TIME since it was
+      // commanded; in motion most of that time has already passed during travel
+      if (millis() - transferArm.getServoCommandTime() >= SERVO_ROTATION_WAIT_TIME) {
+        LOG_DEBUG("Servo rotation complete, moving to dropoff position");
+        //! Step 3: Return to Dropoff Position (already there when rotating in motion)
         currentTransportState = TRANSPORT_RETURN_TO_DROPOFF_POS;
       }
       break;
 
     case TRANSPORT_RETURN_TO_DROPOFF_POS:
-      // Move X axis back to normal dropoff position - BLOCKING
-      transferArm.getXStepper().moveTo(X_DROPOFF_POS);
-      smartLog("Moving X to dropoff position: " + String(X_DROPOFF_POS));
-      transferArm.getXStepper().runToPosition();  // Blocking call
-      smartLog("X reached dropoff position, transport sequence complete");
-      currentTransportState = TRANSPORT_COMPLETE;
+      // Move X axis back to normal dropoff position. Z starts lowering for
+      // dropoff once X is inside the blend window and Stage 2 allows it; the
+      // dropoff sequence finishes the descent.
+      if (transferPath.isIdle()) {
+        setZAxisDropoffSpeed();
+        transferPath = startBlendedMove(X_DROPOFF_POS, Z_UP_POS, Z_DROPOFF_POS,
+                                        stage2AllowsZLowering);
+      }
+      if (transferPath.isDescending()) {
+        LOG_DEBUG("Z lowering for dropoff, transport sequence complete");
+        currentTransportState = TRANSPORT_COMPLETE;
+      }
       break;
       
     case TRANSPORT_COMPLETE:
       // Transport sequence finished, ready to transition to dropoff
-      smartLog("Transport sequence complete, ready for dropoff");
+      LOG_DEBUG("Transport sequence complete, ready for dropoff");
       currentTransportState = TRANSPORT_ROTATE_SERVO_TO_TRAVEL;  // Reset for next cycle
       break;
   }
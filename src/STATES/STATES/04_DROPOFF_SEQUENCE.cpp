@@ -2,6 +2,8 @@
 #include "../../Config/Pins_Definitions.h"
 #include "../../../include/TransferArm.h"
 #include "../../../include/Utils.h"
+#include "../../../include/BlendedMove.h"
+#include "../../../include/ReferenceCheck.h"
 
 // Forward declarations for functions defined in 04_DROPOFF_SEQUENCE_FUNCTIONS.cpp
 void initializeDropoffSequence();
@@ -23,29 +25,30 @@ void restoreZAxisToNormalSpeed();
 // State variables
 DropoffSequenceState currentDropoffState = DROPOFF_LOWER_Z_FOR_DROPOFF;
 unsigned long dropoffStateTimer = 0;
+extern BlendedPath transferPath;  // Defined in PickCycle.cpp
 
 // Initialize the dropoff sequence
 void initializeDropoffSequence() {
   currentDropoffState = DROPOFF_LOWER_Z_FOR_DROPOFF;
   dropoffStateTimer = 0;
   setupZAxisForDropoff();
-  smartLog("Dropoff sequence initialized");
+  LOG_DEBUG("Dropoff sequence initialized");
 }
 
 // Update the dropoff sequence state machine
 void updateDropoffSequence() {
   switch (currentDropoffState) {
     case DROPOFF_LOWER_Z_FOR_DROPOFF:
-      // Check Stage 2 safety signal before lowering Z axis
-      if (!transferArm.isStage2SafeForZLowering()) {
-        // Wait for Stage 2 to signal it's safe (pin goes low)
-        return;  // Stay in this state until safe
+      // Lower Z axis for dropoff at slower speed. The transport sequence
+      // normally started the descent while X was arriving; the Stage 2
+      // safety signal gates the descent inside the blended move.
+      if (transferPath.isIdle()) {
+        transferPath = startBlendedMove(X_DROPOFF_POS, Z_UP_POS, Z_DROPOFF_POS,
+                                        stage2AllowsZLowering);
       }
-      
-      // Lower Z axis for dropoff at slower speed
-      transferArm.getZStepper().moveTo(Z_DROPOFF_POS);
-      if (transferArm.getZStepper().distanceToGo() == 0) {
-        smartLog("Z-axis lowered for dropoff, releasing object");
+      if (transferPath.isDone()) {
+        LOG_DEBUG("Z-axis lowered for dropoff, releasing object");
+        transferPath.reset();
         //! Step 1: Release Object
         currentDropoffState = DROPOFF_RELEASE_OBJECT_STATE;
       }
@@ -54,7 +57,7 @@ void updateDropoffSequence() {
     case DROPOFF_RELEASE_OBJECT_STATE:
       // Turn off the vacuum solenoid
       releaseObject();
-      smartLog("Object released, waiting briefly");
+      LOG_DEBUG("Object released, waiting briefly");
       dropoffStateTimer = 0;
       //! Step 2: Wait After Release
       currentDropoffState = DROPOFF_WAIT_AFTER_RELEASE;
@@ -63,7 +66,7 @@ void updateDropoffSequence() {
     case DROPOFF_WAIT_AFTER_RELEASE:
       // Wait briefly after release
       if (Wait(DROPOFF_HOLD_TIME, &dropoffStateTimer)) {
-        smartLog("Wait complete, raising Z-axis");
+        LOG_DEBUG("Wait complete, raising Z-axis");
         restoreZAxisToNormalSpeed();
         //! Step 3: Raise Z-axis After Dropoff
         currentDropoffState = DROPOFF_RAISE_Z_AFTER_DROPOFF;
@@ -71,17 +74,20 @@ void updateDropoffSequence() {
       break;
 
     case DROPOFF_RAISE_Z_AFTER_DROPOFF:
-      // Raise Z axis after dropoff
-      transferArm.getZStepper().moveTo(Z_UP_POS);
-      if (transferArm.getZStepper().distanceToGo() == 0) {
-        smartLog("Z-axis raised, dropoff sequence complete");
+      // Raise Z axis after dropoff - X starts its return move as soon as Z is
+      // inside the clearance envelope (completion finishes the move)
+      if (transferPath.isIdle()) {
+        transferPath = startBlendedMove(startXReturn(), Z_UP_POS, Z_UP_POS);
+      }
+      if (transferPath.isXReleased()) {
+        LOG_DEBUG("Z-axis clear, dropoff sequence complete");
         currentDropoffState = DROPOFF_COMPLETE;
       }
       break;
       
     case DROPOFF_COMPLETE:
       // Dropoff sequence finished, ready to transition to completion
-      smartLog("Dropoff sequence complete, ready for completion sequence");
+      LOG_DEBUG("Dropoff sequence complete, ready for completion sequence");
       currentDropoffState = DROPOFF_LOWER_Z_FOR_DROPOFF;  // Reset for next cycle
       break;
   }
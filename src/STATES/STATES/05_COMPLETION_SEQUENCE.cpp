@@ -2,12 +2,15 @@
 #include "../../Config/Pins_Definitions.h"
 #include "../../../include/TransferArm.h"
 #include "../../../include/Utils.h"
+#include "../../../include/BlendedMove.h"
+#include "../../../include/ReferenceCheck.h"
 
 // Forward declarations for functions defined in 05_COMPLETION_SEQUENCE_FUNCTIONS.cpp
 void initializeCompletionSequence();
 void updateCompletionSequence();
-bool moveToPosition(AccelStepper& stepper, float targetPosition);
-void homeXAxis();
+void startHomeXAxis();
+bool updateHomeXAxis();
+bool isHomingFaulted();
 void signalStage2();
 void setupStage2Signal();
 
@@ -16,20 +19,24 @@ void setupStage2Signal();
 //* ************************************************************************
 // This state handles the final completion sequence including:
 // - Signaling Stage 2 machine
-// - Returning to pickup position
-// - Homing X-axis
+// - Returning X out of dropoff (directly to pickup, or through the home
+//   switch for a drift check - see ReferenceCheck.h)
+// - Homing X-axis when it is due or the drift check failed
 // - Final move to pickup position
 
 // State variables
 CompletionSequenceState currentCompletionState = COMPLETION_SIGNAL_STAGE2_STATE;
 unsigned long completionStateTimer = 0;
+MotionHandle completionMotion;
+extern BlendedPath transferPath;  // Defined in PickCycle.cpp
 
 // Initialize the completion sequence
 void initializeCompletionSequence() {
   currentCompletionState = COMPLETION_SIGNAL_STAGE2_STATE;
   completionStateTimer = 0;
+  completionMotion.reset();
   setupStage2Signal();
-  smartLog("Completion sequence initialized");
+  LOG_DEBUG("Completion sequence initialized");
 }
 
 // Update the completion sequence state machine
@@ -38,42 +45,68 @@ void updateCompletionSequence() {
     case COMPLETION_SIGNAL_STAGE2_STATE:
       // Send signal to Stage 2 machine
       signalStage2();
-      smartLog("Stage 2 signaled, returning to pickup position (pre-homing)");
-      //! Step 1: Return to Pickup Position (pre-homing)
+      LOG_DEBUG("Stage 2 signaled, returning X from dropoff");
+      //! Step 1: Return X from dropoff
       currentCompletionState = COMPLETION_RETURN_TO_PICKUP_PRE_HOME;
       break;
 
     case COMPLETION_RETURN_TO_PICKUP_PRE_HOME:
-      // Return to pickup position to prepare for homing - BLOCKING
-      transferArm.getXStepper().moveTo(.3);
-      smartLog("Moving X to pickup position (pre-homing): " + String(X_PICKUP_POS));
-      transferArm.getXStepper().runToPosition();  // Blocking call
-      smartLog("X reached pickup position (pre-homing), initiating X-axis homing");
-      //! Step 2: Home X-axis
-      currentCompletionState = COMPLETION_HOME_X_AXIS_STATE;
+      // Return X along this cycle's return plan. The dropoff sequence
+      // normally started this move while Z was still rising.
+      if (transferPath.isIdle()) {
+        transferPath = startBlendedMove(startXReturn(), Z_UP_POS, Z_UP_POS);
+      }
+      // A drift check that stopped just past the switch waits for the
+      // latched edge to be confirmed before it is judged
+      if (transferPath.isDone() && !transferArm.getXHomeLatch().isConfirming()) {
+        transferPath.reset();
+        XReturnPlan plan = getXReturnPlan();
+        if (finishXReturn()) {
+          LOG_INFO("X next to home switch, initiating X-axis homing");
+          startHomeXAxis();
+          //! Step 2: Home X-axis (only when due or after drift)
+          currentCompletionState = COMPLETION_HOME_X_AXIS_STATE;
+        } else if (plan == X_RETURN_DRIFT_CHECK) {
+          //! Step 3: Final Move to Pickup Position (after the drift check)
+          currentCompletionState = COMPLETION_FINAL_MOVE_TO_PICKUP_POS;
+        } else {
+          LOG_INFO("X at pickup position, cycle complete");
+          //! Cycle Complete: Ready for next cycle
+          currentCompletionState = COMPLETION_COMPLETE;
+        }
+      }
       break;
 
     case COMPLETION_HOME_X_AXIS_STATE:
       // Home the X-axis
-      homeXAxis();  // This is a blocking call
-      smartLog("X-axis homed, moving to pickup position (post-homing)");
-      //! Step 3: Final Move to Pickup Position (post-homing)
-      currentCompletionState = COMPLETION_FINAL_MOVE_TO_PICKUP_POS;
+      if (updateHomeXAxis()) {
+        if (isHomingFaulted()) {
+          LOG_ERROR("X-axis re-home failed, stopping in idle until re-homed");
+          currentCompletionState = COMPLETION_COMPLETE;
+          break;
+        }
+        LOG_INFO("X-axis homed, moving to pickup position (post-homing)");
+        //! Step 3: Final Move to Pickup Position (post-homing)
+        currentCompletionState = COMPLETION_FINAL_MOVE_TO_PICKUP_POS;
+      }
       break;
 
     case COMPLETION_FINAL_MOVE_TO_PICKUP_POS:
-      // Move to pickup position after homing - BLOCKING
-      transferArm.getXStepper().moveTo(X_PICKUP_POS);
-      smartLog("Moving X to pickup position (post-homing): " + String(X_PICKUP_POS));
-      transferArm.getXStepper().runToPosition();  // Blocking call
-      smartLog("X reached pickup position (post-homing), cycle complete");
-      //! Cycle Complete: Ready for next cycle
-      currentCompletionState = COMPLETION_COMPLETE;
+      // Move to pickup position after homing or the drift check
+      if (completionMotion.isIdle()) {
+        completionMotion = moveXToPickup();
+      }
+      if (completionMotion.isDone()) {
+        LOG_INFO("X at pickup position, cycle complete");
+        completionMotion.reset();
+        //! Cycle Complete: Ready for next cycle
+        currentCompletionState = COMPLETION_COMPLETE;
+      }
       break;
       
     case COMPLETION_COMPLETE:
       // Completion sequence finished, ready to return to idle
-      smartLog("Completion sequence complete, returning to idle state");
+      LOG_DEBUG("Completion sequence complete, returning to idle state");
       currentCompletionState = COMPLETION_SIGNAL_STAGE2_STATE;  // Reset for next cycle
       break;
   }
@@ -88,4 +121,5 @@ CompletionSequenceState getCurrentCompletionState() {
 void setCompletionState(CompletionSequenceState newState) {
   currentCompletionState = newState;
   completionStateTimer = 0;
+  completionMotion.reset();
 } 
\ No newline at end of file
@@ -4,41 +4,90 @@
 #include "../../../include/Utils.h"
 
 // Forward declarations for functions defined in HOMING_FUNCTIONS.cpp
-void homeZAxis();
-void homeXAxis();
+void startHomeZAxis();
+bool updateHomeZAxis();
+void startHomeXAxis();
+bool updateHomeXAxis();
+bool isHomingFaulted();
 
 //* ************************************************************************
 //* ************************ HOMING ***************************
 //* ************************************************************************
 // This file contains the main homing state machine logic for the Transfer Arm.
 // The homing sequence coordinates X and Z axes to establish reference positions
-// using limit switches.
+// using limit switches. It runs as a non-blocking sequence from the pick cycle
+// state machine, so the main loop keeps running while the axes home.
 
-// Main homing sequence that coordinates all axes according to the specified sequence
-void homeSystem() {
-  smartLog("Starting homing sequence...");
+// State variables
+HomingSequenceState currentHomingState = HOMING_COMPLETE;
+MotionHandle homingMotion;
+
+// Initialize the homing sequence
+void initializeHomingSequence() {
+  LOG_INFO("Starting homing sequence...");
+  homingMotion.reset();
 
   //! Step 1: Home Z axis first
-  homeZAxis();
+  startHomeZAxis();
+  currentHomingState = HOMING_Z_AXIS;
+}
 
-  //! Step 2: Move Z axis up 5 inches
-  smartLog("Moving Z-axis up 5 inches from home...");
-  transferArm.getZStepper().moveTo(Z_UP_POS);
+// Update the homing sequence state machine
+void updateHomingSequence() {
+  switch (currentHomingState) {
+    case HOMING_Z_AXIS:
+      if (updateHomeZAxis()) {
+        if (isHomingFaulted()) {
+          LOG_ERROR("Homing aborted: Z axis has no reference");
+          currentHomingState = HOMING_COMPLETE;
+          break;
+        }
+        //! Step 2: Move Z axis up 5 inches
+        LOG_INFO("Moving Z-axis up 5 inches from home...");
+        homingMotion = moveZToUp();
+        currentHomingState = HOMING_RAISE_Z;
+      }
+      break;
 
-  // Wait for Z movement to complete
-  while (transferArm.getZStepper().distanceToGo() != 0) {
-    transferArm.getZStepper().run();
-    yield();
-  }
+    case HOMING_RAISE_Z:
+      // Wait for Z movement to complete
+      if (homingMotion.isDone()) {
+        homingMotion.reset();
+        //! Step 3: Home X axis
+        startHomeXAxis();
+        currentHomingState = HOMING_X_AXIS;
+      }
+      break;
 
-  //! Step 3: Home X axis
-  homeXAxis();
+    case HOMING_X_AXIS:
+      if (updateHomeXAxis()) {
+        if (isHomingFaulted()) {
+          LOG_ERROR("Homing aborted: X axis has no reference");
+          currentHomingState = HOMING_COMPLETE;
+          break;
+        }
+        //! Step 4: Move X axis to pickup position
+        LOG_INFO("Moving X-axis to pickup position...");
+        homingMotion = moveXToPickup();
+        currentHomingState = HOMING_MOVE_X_TO_PICKUP;
+      }
+      break;
 
-  //! Step 4: Move X axis to pickup position - BLOCKING
-  smartLog("Moving X-axis to pickup position...");
-  transferArm.getXStepper().moveTo(X_PICKUP_POS);
-  transferArm.getXStepper().runToPosition();  // Blocking call
-  smartLog("X-axis reached pickup position");
+    case HOMING_MOVE_X_TO_PICKUP:
+      if (homingMotion.isDone()) {
+        homingMotion.reset();
+        LOG_INFO("Homing sequence completed");
+        currentHomingState = HOMING_COMPLETE;
+      }
+      break;
+
+    case HOMING_COMPLETE:
+      // Homing finished or aborted, pick cycle state machine returns to idle
+      break;
+  }
+}
 
-  smartLog("Homing sequence completed");
-} 
\ No newline at end of file
+// Get current homing state
+HomingSequenceState getCurrentHomingState() {
+  return currentHomingState;
+}
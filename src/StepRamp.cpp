@@ -0,0 +1,180 @@
+#include "../include/StepRamp.h"
+
+//* ************************************************************************
+//* ************************ STEP RAMP ***************************
+//* ************************************************************************
+// Integer step interval ramp. Configuration happens in task context (64-bit
+// integer math); stepRampNext() runs inside the step ISR and only uses
+// 32-bit integer math.
+
+// Scale factor for fixed point intervals
+static const uint32_t RAMP_ONE = 1UL << STEP_RAMP_FRACTION_BITS;
+
+// Speed (Q16.16 steps/s) times interval (fixed point ticks) is constant
+static const uint64_t SPEED_INTERVAL_PRODUCT =
+    (uint64_t)STEP_TIMER_TICKS_PER_SEC << (STEP_RAMP_FRACTION_BITS + Q16_SHIFT);
+
+// Equation 15 in Austin's paper with the 0.676 correction factor:
+//   c0 = 0.676 * sqrt(2 / a) * f
+// With a in Q16.16 and c0 in fixed point ticks this becomes
+//   c0 = C0_NUMERATOR / sqrt(a << 16)
+static const uint64_t C0_NUMERATOR =
+    (uint64_t)(0.676 * 1.4142135623730951 * STEP_TIMER_TICKS_PER_SEC *
+               (1 << STEP_RAMP_FRACTION_BITS) * (1 << Q16_SHIFT));
+
+// Integer square root (task context only)
+static uint64_t isqrt64(uint64_t value) {
+  uint64_t root = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+  while (bit > value) bit >>= 2;
+  while (bit != 0) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+// Ramp steps needed to reach a speed from standstill: v^2 / 2a
+static int32_t rampStepsForSpeed(q16_t speed, q16_t acceleration) {
+  uint64_t vSquared = (uint64_t)speed * (uint64_t)speed;  // Q32.32
+  return (int32_t)((vSquared / (2 * (uint64_t)acceleration)) >> Q16_SHIFT);
+}
+
+//* ************************************************************************
+//* ************************ CONFIGURATION ***************************
+//* ************************************************************************
+
+// Configure ramp limits from max speed (steps/s) and acceleration (steps/s^2)
+void stepRampConfigure(StepRamp& ramp, q16_t maxSpeed, q16_t acceleration) {
+  if (maxSpeed < Q16_ONE) maxSpeed = Q16_ONE;
+  if (acceleration < Q16_ONE) acceleration = Q16_ONE;
+
+  ramp.c0 = (uint32_t)(C0_NUMERATOR / isqrt64((uint64_t)acceleration << Q16_SHIFT));
+  ramp.cMin = stepRampIntervalForSpeed(maxSpeed);
+  ramp.maxRampSteps = rampStepsForSpeed(maxSpeed, acceleration);
+  if (ramp.maxRampSteps < 1) ramp.maxRampSteps = 1;
+  ramp.acceleration = acceleration;
+
+  // Keep a running ramp consistent with the new acceleration
+  if (ramp.n != 0) {
+    stepRampSetSpeed(ramp, ramp.direction * stepRampSpeed(ramp));
+  }
+}
+
+// Re-seed the ramp counter from a speed in steps/s (sign gives direction)
+void stepRampSetSpeed(StepRamp& ramp, q16_t speed) {
+  q16_t magnitude = q16Abs(speed);
+  if (magnitude < Q16_ONE) {
+    stepRampReset(ramp);
+    return;
+  }
+
+  int32_t n = rampStepsForSpeed(magnitude, ramp.acceleration);
+  if (n < 1) n = 1;
+  if (n > ramp.maxRampSteps) n = ramp.maxRampSteps;
+
+  ramp.n = n;
+  ramp.cn = stepRampIntervalForSpeed(magnitude);
+  ramp.direction = (speed > 0) ? 1 : -1;
+}
+
+// Clear motion state
+void stepRampReset(StepRamp& ramp) {
+  ramp.n = 0;
+  ramp.cn = 0;
+  ramp.remainder = 0;
+  ramp.direction = 0;
+}
+
+//* ************************************************************************
+//* ************************ ISR PATH ***************************
+//* ************************************************************************
+
+// Compute the interval before the next step (mirrors AccelStepper's
+// computeNewSpeed(), integer only)
+uint32_t IRAM_ATTR stepRampNext(StepRamp& ramp, int32_t distanceToGo) {
+  int32_t stepsToStop = stepRampStepsToStop(ramp);
+
+  // At the target and slow enough to stop
+  if (distanceToGo == 0 && stepsToStop <= 1) {
+    stepRampReset(ramp);
+    return 0;
+  }
+
+  if (distanceToGo > 0) {
+    if (ramp.n > 0) {
+      // Accelerating: start decelerating if we would overshoot or are going the wrong way
+      if (stepsToStop >= distanceToGo || ramp.direction < 0) ramp.n = -stepsToStop;
+    } else if (ramp.n < 0) {
+      // Decelerating: accelerate again if there is room and we are going the right way
+      if (stepsToStop < distanceToGo && ramp.direction > 0) ramp.n = -ramp.n;
+    }
+  } else if (distanceToGo < 0) {
+    if (ramp.n > 0) {
+      if (stepsToStop >= -distanceToGo || ramp.direction > 0) ramp.n = -stepsToStop;
+    } else if (ramp.n < 0) {
+      if (stepsToStop < -distanceToGo && ramp.direction < 0) ramp.n = -ramp.n;
+    }
+  } else if (ramp.n > 0) {
+    // On target but still fast: decelerate through it and come back
+    ramp.n = -stepsToStop;
+  }
+
+  if (ramp.n == 0) {
+    // First step from standstill
+    ramp.cn = ramp.c0;
+    ramp.direction = (distanceToGo > 0) ? 1 : -1;
+  } else {
+    // Equation 13 in Austin's paper. The change per step is only a few
+    // fixed point units near full speed, so it is rounded rather than
+    // truncated; truncation made the ramp lag the ideal one by ~2%.
+    int32_t cn = (int32_t)ramp.cn;
+    int32_t denominator = 4 * ramp.n + 1;
+    int32_t magnitude = (denominator > 0) ? denominator : -denominator;
+    int32_t change = (2 * cn + magnitude / 2) / magnitude;
+    cn -= (denominator > 0) ? change : -change;
+    ramp.cn = (cn < (int32_t)ramp.cMin) ? ramp.cMin : (uint32_t)cn;
+  }
+
+  // Hold the counter once at cruise so stepsToStop stays correct
+  if (ramp.n < ramp.maxRampSteps) {
+    ramp.n++;
+  }
+
+  // Carry the fractional part so the average rate is exact
+  uint32_t total = ramp.cn + ramp.remainder;
+  uint32_t ticks = total >> STEP_RAMP_FRACTION_BITS;
+  ramp.remainder = total & (RAMP_ONE - 1);
+  return (ticks > 0) ? ticks : 1;
+}
+
+// Current speed in steps per second
+q16_t stepRampSpeed(const StepRamp& ramp) {
+  if (ramp.direction == 0 || ramp.cn == 0) return 0;
+  return stepRampSpeedForInterval(ramp.cn);
+}
+
+// Fixed point interval for a speed in steps/s
+uint32_t stepRampIntervalForSpeed(q16_t speed) {
+  q16_t magnitude = q16Abs(speed);
+  if (magnitude == 0) return UINT32_MAX;
+  uint64_t interval = SPEED_INTERVAL_PRODUCT / (uint64_t)magnitude;
+  return (interval > UINT32_MAX) ? UINT32_MAX : (uint32_t)interval;
+}
+
+// Speed in steps/s for a fixed point interval
+q16_t stepRampSpeedForInterval(uint32_t interval) {
+  if (interval == 0) return 0;
+  uint64_t speed = SPEED_INTERVAL_PRODUCT / interval;
+  return (speed > INT32_MAX) ? INT32_MAX : (q16_t)speed;
+}
+
+// Steps needed to stop from the current speed
+int32_t IRAM_ATTR stepRampStepsToStop(const StepRamp& ramp) {
+  return (ramp.n >= 0) ? ramp.n : -ramp.n;
+}
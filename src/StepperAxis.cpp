@@ -0,0 +1,482 @@
+#include "../include/StepperAxis.h"
+#include "../include/TaskManager.h"
+
+//* ************************************************************************
+//* ************************ STEPPER AXIS ***************************
+//* ************************************************************************
+// Timer ISR step generation. Every step takes two timer interrupts:
+//   1. Rising edge  - position is updated and the step pin goes HIGH
+//   2. Falling edge - step pin goes LOW, the next interval is computed and
+//                     the DIR pin is updated for the following step
+// The timer auto-reloads on every alarm, so interrupt latency never
+// accumulates into the step schedule.
+
+// Timer prescaler for a 1 MHz tick from the 80 MHz APB clock
+static const uint16_t STEP_TIMER_DIVIDER = 80;
+
+// Delay between setting DIR and the first step from standstill (ticks)
+static const uint32_t DIR_SETUP_TICKS = 10;
+
+// Number of hardware timers on the ESP32
+static const uint8_t MAX_STEP_TIMERS = 4;
+
+// Axis bound to each hardware timer
+static StepperAxis* axisForTimer[MAX_STEP_TIMERS] = {nullptr, nullptr, nullptr, nullptr};
+
+// Arduino timer callbacks take no argument, so each timer gets a trampoline
+static void IRAM_ATTR onStepTimer0() { axisForTimer[0]->handleTimerInterrupt(); }
+static void IRAM_ATTR onStepTimer1() { axisForTimer[1]->handleTimerInterrupt(); }
+static void IRAM_ATTR onStepTimer2() { axisForTimer[2]->handleTimerInterrupt(); }
+static void IRAM_ATTR onStepTimer3() { axisForTimer[3]->handleTimerInterrupt(); }
+
+static void (*const stepTimerCallbacks[MAX_STEP_TIMERS])() = {
+    onStepTimer0, onStepTimer1, onStepTimer2, onStepTimer3};
+
+//* ************************************************************************
+//* ************************ CONSTRUCTION ***************************
+//* ************************************************************************
+
+StepperAxis::StepperAxis(uint8_t stepPin, uint8_t dirPin, uint8_t timerIndex)
+    : stepPin(stepPin),
+      dirPin(dirPin),
+      timerIndex(timerIndex),
+      timer(nullptr),
+      lock(portMUX_INITIALIZER_UNLOCKED),
+      minPulseWidth(3),
+      stepHook(nullptr),
+      stepErrorHistogram(nullptr),
+      traceAxis(-1),
+      currentPos(0),
+      targetPos(0),
+      running(false),
+      stepPinHigh(false),
+      issuedMoves(0),
+      completedMoves(0),
+      mode(AXIS_MODE_POSITION),
+      pinDirection(0),
+      jogDirection(0),
+      jogInterval(0),
+      jogRemainder(0),
+      maxSpeed(Q16_ONE),
+      acceleration(Q16_ONE),
+      profileType(PROFILE_TRAPEZOID),
+      jerk(0),
+      cachedMoveCount(0),
+      profileTable(nullptr),
+      profileRampSteps(0),
+      profileSteps(0),
+      profileStep(0),
+      profileDirection(0),
+      profileCruise(0),
+      profileRemainder(0),
+      profileInterval(0) {
+  ramp = StepRamp();
+  stepRampConfigure(ramp, maxSpeed, acceleration);
+}
+
+// Attach the hardware timer and configure pins
+void StepperAxis::begin() {
+  pinMode(stepPin, OUTPUT);
+  pinMode(dirPin, OUTPUT);
+  digitalWrite(stepPin, LOW);
+  digitalWrite(dirPin, LOW);
+
+  if (timerIndex >= MAX_STEP_TIMERS) {
+    return;
+  }
+  axisForTimer[timerIndex] = this;
+  timer = timerBegin(timerIndex, STEP_TIMER_DIVIDER, true);
+  timerAttachInterrupt(timer, stepTimerCallbacks[timerIndex], true);
+  timerAlarmDisable(timer);
+}
+
+//* ************************************************************************
+//* ************************ CONFIGURATION ***************************
+//* ************************************************************************
+
+// Set maximum speed in steps per second
+void StepperAxis::setMaxSpeed(q16_t speed) {
+  maxSpeed = q16Abs(speed);
+  portENTER_CRITICAL(&lock);
+  stepRampConfigure(ramp, maxSpeed, acceleration);
+  portEXIT_CRITICAL(&lock);
+}
+
+// Set acceleration in steps per second^2
+void StepperAxis::setAcceleration(q16_t newAcceleration) {
+  acceleration = q16Abs(newAcceleration);
+  portENTER_CRITICAL(&lock);
+  stepRampConfigure(ramp, maxSpeed, acceleration);
+  portEXIT_CRITICAL(&lock);
+}
+
+// Set step pulse high time in microseconds
+void StepperAxis::setMinPulseWidth(unsigned int microseconds) {
+  minPulseWidth = (microseconds > 0) ? microseconds : 1;
+}
+
+// Select the profile shape used by moveTo()
+void StepperAxis::setProfile(MotionProfileType type, long newJerk) {
+  profileType = type;
+  jerk = labs(newJerk);
+}
+
+// Limits in the form the profile generator takes (planning only)
+ProfileLimits StepperAxis::profileLimits() const {
+  ProfileLimits limits = {q16ToFloat(maxSpeed), q16ToFloat(acceleration), (float)jerk};
+  return limits;
+}
+
+// Precompute the step intervals for a fixed move
+bool StepperAxis::cacheMove(long from, long to) {
+  if (cachedMoveCount >= MAX_CACHED_MOVES || from == to) {
+    return false;
+  }
+
+  ProfileLimits limits = profileLimits();
+  uint32_t cruise = 0;
+  int32_t rampSteps = buildProfileRamp(limits, profileType, to - from, planTable,
+                                       MAX_PROFILE_RAMP_STEPS, &cruise);
+  if (rampSteps < 0) {
+    return false;
+  }
+
+  uint16_t* intervals = (uint16_t*)malloc((rampSteps > 0 ? rampSteps : 1) * sizeof(uint16_t));
+  if (intervals == nullptr) {
+    return false;
+  }
+  memcpy(intervals, planTable, rampSteps * sizeof(uint16_t));
+
+  CachedMove& entry = cachedMoves[cachedMoveCount++];
+  entry.from = from;
+  entry.to = to;
+  entry.type = profileType;
+  entry.maxSpeed = maxSpeed;
+  entry.acceleration = acceleration;
+  entry.jerk = jerk;
+  entry.intervals = intervals;
+  entry.rampSteps = rampSteps;
+  entry.cruiseInterval = cruise;
+  return true;
+}
+
+// Cached move planned with the current limits, or nullptr
+const StepperAxis::CachedMove* StepperAxis::findCachedMove(long from, long to) const {
+  for (uint8_t i = 0; i < cachedMoveCount; i++) {
+    const CachedMove& entry = cachedMoves[i];
+    if (entry.from == from && entry.to == to && entry.type == profileType &&
+        entry.maxSpeed == maxSpeed && entry.acceleration == acceleration &&
+        (entry.type != PROFILE_SCURVE || entry.jerk == jerk)) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+//* ************************************************************************
+//* ************************ MOTION COMMANDS ***************************
+//* ************************************************************************
+
+// Set an absolute target and start stepping if idle
+void StepperAxis::moveTo(long absolute) {
+  // Table moves are planned from standstill, outside the lock
+  bool planned = !running ? planProfileMove(absolute) : false;
+
+  portENTER_CRITICAL(&lock);
+  if (planned && !running) {
+    mode = AXIS_MODE_PROFILE;
+  } else if (mode == AXIS_MODE_PROFILE) {
+    // New target mid-move: finish on the trapezoid ramp from the current speed
+    handOffProfileLocked();
+  } else if (mode == AXIS_MODE_JOG) {
+    // Hand the jog speed to the ramp so the switch is smooth
+    mode = AXIS_MODE_POSITION;
+    if (running) {
+      stepRampSetSpeed(ramp, jogDirection * stepRampSpeedForInterval(jogInterval));
+    }
+  }
+  targetPos = absolute;
+  issuedMoves++;
+  startLocked();
+  if (!running) {
+    // Already at the target - the move is complete immediately
+    completedMoves = issuedMoves;
+  }
+  portEXIT_CRITICAL(&lock);
+}
+
+// Set a target relative to the current position
+void StepperAxis::move(long relative) {
+  moveTo(currentPosition() + relative);
+}
+
+// Run at a constant speed (steps/s, sign gives direction) until stop()
+void StepperAxis::jog(q16_t speed) {
+  q16_t magnitude = q16Abs(speed);
+  if (magnitude < Q16_ONE) {
+    stop();
+    return;
+  }
+
+  portENTER_CRITICAL(&lock);
+  mode = AXIS_MODE_JOG;
+  jogDirection = (speed > 0) ? 1 : -1;
+  jogInterval = stepRampIntervalForSpeed(magnitude);
+  jogRemainder = 0;
+  stepRampReset(ramp);
+  startLocked();
+  portEXIT_CRITICAL(&lock);
+}
+
+// Decelerate to a stop as quickly as the acceleration allows
+void StepperAxis::stop() {
+  portENTER_CRITICAL(&lock);
+  if (mode == AXIS_MODE_JOG) {
+    // No ramp while jogging - stop now, or at the end of a pulse in progress
+    mode = AXIS_MODE_POSITION;
+    if (running && !stepPinHigh) {
+      timerAlarmDisable(timer);
+      running = false;
+      traceMotion(TRACE_MOTION_END, currentPos);
+    }
+    targetPos = currentPos;
+    completedMoves = issuedMoves;
+    stepRampReset(ramp);
+  } else if (running) {
+    if (mode == AXIS_MODE_PROFILE) {
+      handOffProfileLocked();
+    }
+    long stepsToStop = stepRampStepsToStop(ramp);
+    targetPos = currentPos + (ramp.direction > 0 ? stepsToStop : -stepsToStop);
+  }
+  portEXIT_CRITICAL(&lock);
+}
+
+//* ************************************************************************
+//* ************************ STATUS ***************************
+//* ************************************************************************
+
+long StepperAxis::distanceToGo() const {
+  return targetPos - currentPos;
+}
+
+long StepperAxis::targetPosition() const {
+  return targetPos;
+}
+
+// Redefine the current position; like AccelStepper this also stops the axis
+void StepperAxis::setCurrentPosition(long position) {
+  portENTER_CRITICAL(&lock);
+  if (running && timer != nullptr) {
+    timerAlarmDisable(timer);
+    digitalWrite(stepPin, LOW);
+    stepPinHigh = false;
+    running = false;
+    traceMotion(TRACE_MOTION_END, currentPos);
+  }
+  mode = AXIS_MODE_POSITION;
+  currentPos = position;
+  targetPos = position;
+  completedMoves = issuedMoves;  // Any pending move is cancelled
+  stepRampReset(ramp);
+  portEXIT_CRITICAL(&lock);
+}
+
+// Current speed in steps per second (signed)
+q16_t StepperAxis::speed() const {
+  if (!running) return 0;
+  if (mode == AXIS_MODE_JOG) {
+    return jogDirection * stepRampSpeedForInterval(jogInterval);
+  }
+  if (mode == AXIS_MODE_PROFILE) {
+    if (profileInterval == 0) return 0;
+    return profileDirection * stepRampSpeedForInterval(profileInterval << STEP_RAMP_FRACTION_BITS);
+  }
+  return ramp.direction * stepRampSpeed(ramp);
+}
+
+//* ************************************************************************
+//* ************************ S-CURVE PLAYBACK ***************************
+//* ************************************************************************
+
+// Select the interval table for a move from standstill: a cached move if
+// one matches, otherwise an S-curve planned now. Planning costs a Newton
+// solve per ramp step - milliseconds for a long move - so on the motion task
+// an uncached move never plans and runs on the trapezoid ramp instead; only
+// cacheMove() (setup) and other tasks pay for it. Returns false if the move
+// should run on the trapezoid ramp (not cached, planned on the motion task,
+// too short, or the ramp does not fit).
+bool StepperAxis::planProfileMove(long absolute) {
+  long from = currentPos;
+  long distance = absolute - from;
+  const uint16_t* table = nullptr;
+  int32_t rampSteps = -1;
+  uint32_t cruise = 0;
+
+  const CachedMove* cached = findCachedMove(from, absolute);
+  if (cached != nullptr) {
+    table = cached->intervals;
+    rampSteps = cached->rampSteps;
+    cruise = cached->cruiseInterval;
+  } else if (profileType == PROFILE_SCURVE && !isMotionTask()) {
+    ProfileLimits limits = profileLimits();
+    rampSteps = buildSCurveRamp(limits, distance, planTable, MAX_PROFILE_RAMP_STEPS, &cruise);
+    table = planTable;
+  }
+  if (rampSteps < 0) {
+    return false;
+  }
+
+  portENTER_CRITICAL(&lock);
+  profileTable = table;
+  profileRampSteps = rampSteps;
+  profileSteps = (distance > 0) ? distance : -distance;
+  profileStep = 0;
+  profileDirection = (distance > 0) ? 1 : -1;
+  profileCruise = cruise;
+  profileRemainder = 0;
+  profileInterval = 0;
+  portEXIT_CRITICAL(&lock);
+  return true;
+}
+
+// Continue a running S-curve move on the trapezoid ramp (lock held)
+void StepperAxis::handOffProfileLocked() {
+  mode = AXIS_MODE_POSITION;
+  if (running && profileInterval > 0) {
+    stepRampSetSpeed(ramp, profileDirection * stepRampSpeedForInterval(profileInterval << STEP_RAMP_FRACTION_BITS));
+  } else {
+    stepRampReset(ramp);
+  }
+}
+
+// Next interval from the profile table, 0 once the move is done (lock held)
+uint32_t IRAM_ATTR StepperAxis::nextProfileIntervalLocked() {
+  ramp.direction = profileDirection;
+  int32_t step = profileStep;
+  if (step >= profileSteps) {
+    // Move complete - back to position mode at rest
+    mode = AXIS_MODE_POSITION;
+    stepRampReset(ramp);
+    profileInterval = 0;
+    return 0;
+  }
+  profileStep = step + 1;
+  if (step == 0) {
+    // First step fires after the DIR setup time
+    return 1;
+  }
+
+  // Gap between step `step` and the next one
+  int32_t gap = step - 1;
+  int32_t lastGap = profileSteps - 2;
+  uint32_t ticks;
+  if (gap < profileRampSteps) {
+    ticks = profileTable[gap];
+  } else if (gap > lastGap - profileRampSteps) {
+    ticks = profileTable[lastGap - gap];
+  } else {
+    uint32_t total = profileCruise + profileRemainder;
+    profileRemainder = total & ((1 << STEP_RAMP_FRACTION_BITS) - 1);
+    ticks = total >> STEP_RAMP_FRACTION_BITS;
+  }
+  if (ticks == 0) ticks = 1;
+  profileInterval = ticks;
+  return ticks;
+}
+
+//* ************************************************************************
+//* ************************ STEP GENERATION ***************************
+//* ************************************************************************
+
+// Start the timer if there is anything to do (lock held)
+void StepperAxis::startLocked() {
+  if (running || timer == nullptr) {
+    return;
+  }
+
+  if (nextIntervalLocked() == 0) {
+    return;
+  }
+
+  applyDirectionLocked();
+  running = true;
+  stepPinHigh = false;
+  traceMotion(TRACE_MOTION_START, mode == AXIS_MODE_JOG ? currentPos : targetPos);
+
+  // First step fires once DIR has settled
+  timerWrite(timer, 0);
+  timerAlarmWrite(timer, DIR_SETUP_TICKS, true);
+  timerAlarmEnable(timer);
+}
+
+// Interval before the next step in ticks, 0 to stop (lock held)
+uint32_t IRAM_ATTR StepperAxis::nextIntervalLocked() {
+  if (mode == AXIS_MODE_JOG) {
+    uint32_t total = jogInterval + jogRemainder;
+    jogRemainder = total & ((1 << STEP_RAMP_FRACTION_BITS) - 1);
+    ramp.direction = jogDirection;
+    uint32_t ticks = total >> STEP_RAMP_FRACTION_BITS;
+    return (ticks > 0) ? ticks : 1;
+  }
+  if (mode == AXIS_MODE_PROFILE) {
+    return nextProfileIntervalLocked();
+  }
+  return stepRampNext(ramp, targetPos - currentPos);
+}
+
+// Drive the DIR pin for the upcoming step (lock held)
+void IRAM_ATTR StepperAxis::applyDirectionLocked() {
+  if (ramp.direction != pinDirection) {
+    digitalWrite(dirPin, ramp.direction > 0 ? HIGH : LOW);
+    pinDirection = ramp.direction;
+  }
+}
+
+// Record a motion start or end if this axis is traced
+void IRAM_ATTR StepperAxis::traceMotion(TraceEventType type, long position) {
+  if (traceAxis >= 0) {
+    traceEvent(type, (uint8_t)traceAxis, position);
+  }
+}
+
+// Timer alarm handler - alternates between the rising and falling edge
+void IRAM_ATTR StepperAxis::handleTimerInterrupt() {
+  portENTER_CRITICAL_ISR(&lock);
+
+  if (!stepPinHigh) {
+    // Rising edge: this is the step. The timer restarted from zero when the
+    // alarm fired, so its count is how late the edge is.
+    uint32_t lateTicks = (uint32_t)timerRead(timer);
+    digitalWrite(stepPin, HIGH);
+    stepPinHigh = true;
+    currentPos += pinDirection;
+    timerAlarmWrite(timer, minPulseWidth, true);
+    if (stepHook != nullptr) {
+      stepHook(this, currentPos, pinDirection);
+    }
+    if (stepErrorHistogram != nullptr) {
+      stepErrorHistogram->record(lateTicks);  // Timer ticks are microseconds
+    }
+  } else {
+    // Falling edge: end the pulse and schedule the next step
+    digitalWrite(stepPin, LOW);
+    stepPinHigh = false;
+
+    uint32_t interval = nextIntervalLocked();
+    if (interval == 0) {
+      timerAlarmDisable(timer);
+      running = false;
+      traceMotion(TRACE_MOTION_END, currentPos);
+      if (mode == AXIS_MODE_POSITION) {
+        completedMoves = issuedMoves;
+      }
+    } else {
+      applyDirectionLocked();
+      uint32_t lowTime = (interval > minPulseWidth) ? interval - minPulseWidth : 1;
+      timerAlarmWrite(timer, lowTime, true);
+    }
+  }
+
+  portEXIT_CRITICAL_ISR(&lock);
+}
@@ -0,0 +1,71 @@
+#include "../include/SwitchLatch.h"
+#include "../include/Utils.h"
+#include "Config/Config.h"
+
+//* ************************************************************************
+//* ************************ SWITCH LATCH ***************************
+//* ************************************************************************
+
+SwitchLatch::SwitchLatch()
+    : axis(nullptr),
+      debounced(nullptr),
+      pin(0),
+      armed(false),
+      captured(false),
+      position(0),
+      edgeMicros(0),
+      latched(false),
+      glitchCount(0) {}
+
+// Attach the edge interrupt
+void SwitchLatch::begin(uint8_t switchPin, Bounce& switchDebouncer, StepperAxis& latchAxis) {
+  axis = &latchAxis;
+  debounced = &switchDebouncer;
+  pin = switchPin;
+  attachInterruptArg(digitalPinToInterrupt(pin), handleEdge, this, RISING);
+}
+
+// Clear any previous capture and wait for the next rising edge
+void SwitchLatch::arm() {
+  latched = false;
+  captured = false;
+  armed = true;
+}
+
+// Stop capturing edges and drop an unconfirmed capture
+void SwitchLatch::disarm() {
+  armed = false;
+  captured = false;
+}
+
+// Accept the captured edge once the debounced switch has stayed closed for
+// the confirm window; a switch that reads open again was a spike
+void SwitchLatch::update() {
+  if (!captured || latched || debounced == nullptr) {
+    return;
+  }
+  if (micros() - edgeMicros < HOME_SWITCH_CONFIRM_MS * 1000UL) {
+    return;
+  }
+  if (debounced->read() == HIGH) {
+    latched = true;
+    return;
+  }
+  glitchCount++;
+  captured = false;
+  armed = true;
+  LOG_DEBUG("Home switch glitch on pin %u ignored", (unsigned)pin);
+}
+
+// Switch edge ISR - only the first edge after arm() counts, so contact
+// bounce cannot move the captured position
+void IRAM_ATTR SwitchLatch::handleEdge(void* context) {
+  SwitchLatch* latch = (SwitchLatch*)context;
+  if (!latch->armed || latch->axis == nullptr) {
+    return;
+  }
+  latch->position = latch->axis->currentPosition();
+  latch->edgeMicros = micros();
+  latch->captured = true;
+  latch->armed = false;
+}
@@ -0,0 +1,262 @@
+#include "../include/TaskManager.h"
+#include "../include/TransferArm.h"
+#include "../include/PickCycle.h"
+#include "../include/OTA_Manager.h"
+#include "../include/SpscQueue.h"
+#include "../include/Utils.h"
+#include "../include/Logger.h"
+#include "../include/LatencyStats.h"
+#include "../include/TraceStore.h"
+#include "../include/ResourceMonitor.h"
+#include "../include/DashboardServer.h"
+#include "../include/Telemetry.h"
+#include "../include/CommandProcessor.h"
+#include "Config/Pins_Definitions.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+
+//* ************************************************************************
+//* ************************ TASK MANAGER ***************************
+//* ************************************************************************
+
+// Fixed-size text entries for the handoff queues (no heap use per entry)
+struct CommandLine {
+  char text[COMMAND_LINE_LENGTH];
+};
+
+// Handoff points
+static SpscQueue<CommandLine, 4> commandQueue;  // Comms -> motion
+static std::atomic<bool> emergencyStopRequested(false);  // Any task -> motion, never dropped
+static std::atomic<uint32_t> snapshotSequence(0);  // Odd while the snapshot is being written
+static MotionSnapshot motionSnapshot;
+
+// Tasks and their accounting
+static TaskHandle_t motionTaskHandle = nullptr;
+static TaskHandle_t commsTaskHandle = nullptr;
+static TaskStats motionStats = {"motion"};
+static TaskStats commsStats = {"comms"};
+static portMUX_TYPE statsLock = portMUX_INITIALIZER_UNLOCKED;  // Stats are read from the other core
+
+// Copy text into a fixed entry, truncating if needed
+static void copyText(char* dest, size_t size, const char* text) {
+  size_t length = strlen(text);
+  if (length >= size) length = size - 1;
+  memcpy(dest, text, length);
+  dest[length] = '\0';
+}
+
+//* ************************************************************************
+//* ************************ ACCOUNTING ***************************
+//* ************************************************************************
+
+// Record one period of work. lateness is how far past its scheduled start
+// the period began.
+static void recordRun(TaskStats& stats, int64_t runMicros, int64_t latenessMicros) {
+  uint32_t run = (uint32_t)runMicros;
+  uint32_t lateness = (latenessMicros > 0) ? (uint32_t)latenessMicros : 0;
+
+  portENTER_CRITICAL(&statsLock);
+  stats.runs++;
+  stats.busyMicros += run;
+  stats.lastRunMicros = run;
+  if (run > stats.maxRunMicros) stats.maxRunMicros = run;
+  if (lateness > stats.maxLatenessMicros) stats.maxLatenessMicros = lateness;
+  if (lateness + run > stats.periodMicros) stats.deadlineMisses++;
+  portEXIT_CRITICAL(&statsLock);
+}
+
+static TaskStats copyStats(const TaskStats& stats) {
+  portENTER_CRITICAL(&statsLock);
+  TaskStats copy = stats;
+  portEXIT_CRITICAL(&statsLock);
+  return copy;
+}
+
+//* ************************************************************************
+//* ************************ HANDOFF POINTS ***************************
+//* ************************************************************************
+
+bool isMotionTask() {
+  return motionTaskHandle != nullptr && xTaskGetCurrentTaskHandle() == motionTaskHandle;
+}
+
+// Comms -> motion: queue a Serial command line
+bool queueCommand(const char* command) {
+  CommandLine* line = commandQueue.reserve();
+  if (line == nullptr) {
+    return false;
+  }
+  copyText(line->text, sizeof(line->text), command);
+  commandQueue.commit();
+  return true;
+}
+
+// Any task: request an emergency stop
+void requestEmergencyStop() {
+  emergencyStopRequested.store(true, std::memory_order_release);
+}
+
+// Motion task: act on a stop request, then run queued commands
+void processQueuedCommands() {
+  CommandLine line;
+  if (emergencyStopRequested.exchange(false, std::memory_order_acq_rel)) {
+    // Commands sent before the stop must not move the machine after it
+    uint32_t discarded = 0;
+    while (commandQueue.pop(line)) discarded++;
+    emergencyStopPickCycle();
+    if (discarded > 0) {
+      LOG_WARN("Emergency stop: %lu queued commands discarded", (unsigned long)discarded);
+    }
+    return;
+  }
+  while (commandQueue.pop(line)) {
+    runQueuedCommand(line.text);
+  }
+}
+
+// Motion task: publish the state copy read by the comms side (seqlock writer)
+static void publishMotionSnapshot(uint32_t sequence) {
+  StepperAxis& xAxis = transferArm.getXStepper();
+  StepperAxis& zAxis = transferArm.getZStepper();
+
+  snapshotSequence.fetch_add(1, std::memory_order_acq_rel);  // Odd: write in progress
+  std::atomic_thread_fence(std::memory_order_release);
+  motionSnapshot.sequence = sequence;
+  motionSnapshot.xPosition = xAxis.currentPosition();
+  motionSnapshot.zPosition = zAxis.currentPosition();
+  motionSnapshot.xSpeed = xAxis.speed();
+  motionSnapshot.zSpeed = zAxis.speed();
+  motionSnapshot.servoPosition = transferArm.getServoPosition();
+  motionSnapshot.pickCycleState = getCurrentState();
+  motionSnapshot.vacuumOn = digitalRead(SOLENOID_RELAY_PIN) == HIGH;
+  motionSnapshot.xHomeSwitch = transferArm.getXHomeSwitch().read();
+  motionSnapshot.zHomeSwitch = transferArm.getZHomeSwitch().read();
+  std::atomic_thread_fence(std::memory_order_release);
+  snapshotSequence.fetch_add(1, std::memory_order_release);  // Even: snapshot complete
+}
+
+// Comms side: latest consistent snapshot (seqlock reader, retries on a torn copy)
+bool readMotionSnapshot(MotionSnapshot& snapshot) {
+  for (int attempt = 0; attempt < 8; attempt++) {
+    uint32_t before = snapshotSequence.load(std::memory_order_acquire);
+    if (before == 0) return false;  // Nothing published yet
+    if (before & 1) continue;       // Writer active
+    snapshot = motionSnapshot;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (snapshotSequence.load(std::memory_order_relaxed) == before) return true;
+  }
+  return false;
+}
+
+//* ************************************************************************
+//* ************************ TASKS ***************************
+//* ************************************************************************
+
+// Motion task: fixed-period update of the state machines
+static void motionTask(void* parameter) {
+  const TickType_t periodTicks = pdMS_TO_TICKS(MOTION_TASK_PERIOD_MS);
+  const int64_t periodMicros = (int64_t)MOTION_TASK_PERIOD_MS * 1000;
+  TickType_t lastWake = xTaskGetTickCount();
+  int64_t scheduled = esp_timer_get_time();
+  uint32_t sequence = 0;
+  int64_t previousStart = 0;
+
+  for (;;) {
+    vTaskDelayUntil(&lastWake, periodTicks);
+    int64_t start = esp_timer_get_time();
+    if (previousStart != 0) {
+      getLatencyHistogram(LATENCY_LOOP_PERIOD).record((uint32_t)(start - previousStart));
+    }
+    previousStart = start;
+    scheduled += periodMicros;
+    int64_t lateness = start - scheduled;
+    if (lateness > 10 * periodMicros) {
+      scheduled = start;  // Resynchronise after a long stall instead of reporting it every period
+    }
+
+    transferArm.update();
+    publishMotionSnapshot(++sequence);
+    recordTraceStoreSample();
+    recordTelemetrySample();
+
+    recordRun(motionStats, esp_timer_get_time() - start, lateness);
+  }
+}
+
+// Comms task: OTA and Serial input
+static void commsTask(void* parameter) {
+  const int64_t periodMicros = (int64_t)COMMS_TASK_PERIOD_MS * 1000;
+  int64_t scheduled = esp_timer_get_time();
+  beginDashboardServer();
+
+  for (;;) {
+    vTaskDelay(pdMS_TO_TICKS(COMMS_TASK_PERIOD_MS));
+    int64_t start = esp_timer_get_time();
+    int64_t lateness = start - (scheduled + periodMicros);
+
+    // Serial commands - reports run here, the rest are queued for the motion task
+    pollSerialCommands();
+
+    updateDashboardServer();
+    updateTelemetry();
+    updateResourceMonitor();
+
+    int64_t otaStart = esp_timer_get_time();
+    handleOTA();
+    getLatencyHistogram(LATENCY_OTA).record((uint32_t)(esp_timer_get_time() - otaStart));
+
+    int64_t end = esp_timer_get_time();
+    recordRun(commsStats, end - start, lateness);
+    scheduled = end;
+  }
+}
+
+// Create both tasks (call once at the end of setup)
+void startTasks() {
+  motionStats.periodMicros = MOTION_TASK_PERIOD_MS * 1000;
+  commsStats.periodMicros = COMMS_TASK_PERIOD_MS * 1000;
+
+  startLogDrain();
+  beginTraceStore();
+  xTaskCreatePinnedToCore(commsTask, "comms", COMMS_TASK_STACK_SIZE, nullptr,
+                          COMMS_TASK_PRIORITY, &commsTaskHandle, COMMS_TASK_CORE);
+  xTaskCreatePinnedToCore(motionTask, "motion", MOTION_TASK_STACK_SIZE, nullptr,
+                          MOTION_TASK_PRIORITY, &motionTaskHandle, MOTION_TASK_CORE);
+  LOG_INFO("Tasks started: motion on core %d, comms on core %d", MOTION_TASK_CORE, COMMS_TASK_CORE);
+}
+
+//* ************************************************************************
+//* ************************ REPORTING ***************************
+//* ************************************************************************
+
+// Print one task's statistics
+static void reportTask(const TaskStats& live, TaskHandle_t handle) {
+  TaskStats stats = copyStats(live);
+  uint64_t elapsed = (uint64_t)stats.runs * stats.periodMicros;
+  float cpuPercent = (elapsed > 0) ? 100.0f * (float)stats.busyMicros / (float)elapsed : 0.0f;
+  uint32_t stackFree = (handle != nullptr) ? uxTaskGetStackHighWaterMark(handle) : 0;
+
+  serialPrintf("%s: %lu runs, CPU %.1f%%, last %lu us, max %lu us, max late %lu us, %lu deadline misses, "
+               "stack free %lu\n",
+               stats.name, (unsigned long)stats.runs, cpuPercent, (unsigned long)stats.lastRunMicros,
+               (unsigned long)stats.maxRunMicros, (unsigned long)stats.maxLatenessMicros,
+               (unsigned long)stats.deadlineMisses, (unsigned long)stackFree);
+}
+
+// Print per-task CPU time and deadline statistics
+void reportTaskStats() {
+  Serial.println("Task Statistics:");
+  reportTask(motionStats, motionTaskHandle);
+  reportTask(commsStats, commsTaskHandle);
+  LoggerStats logStats = getLoggerStats();
+  serialPrintf("Queues: %lu commands dropped; log %lu records, %lu dropped, high water %lu\n",
+               (unsigned long)commandQueue.droppedCount(), (unsigned long)logStats.written,
+               (unsigned long)logStats.dropped, (unsigned long)logStats.highWater);
+
+  MotionSnapshot snapshot;
+  if (readMotionSnapshot(snapshot)) {
+    serialPrintf("Motion: period %lu, X %ld, Z %ld, state %s\n", (unsigned long)snapshot.sequence,
+                 (long)snapshot.xPosition, (long)snapshot.zPosition, getStateString(snapshot.pickCycleState));
+  }
+}
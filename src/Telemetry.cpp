@@ -0,0 +1,175 @@
+#include "../include/Telemetry.h"
+#include "../include/TransferArm.h"
+#include "../include/PickCycle.h"
+#include "../include/TraceStore.h"
+#include "../include/PulseOutput.h"
+#include "../include/SpscQueue.h"
+#include "../include/FixedPoint.h"
+#include "../include/Utils.h"
+#include "Config/Config.h"
+#include "Config/Pins_Definitions.h"
+#include <WiFiUdp.h>
+#include <atomic>
+
+//* ************************************************************************
+//* ************************ TELEMETRY ***************************
+//* ************************************************************************
+
+// Motion -> comms. 64 samples is 128 ms at 500 Hz - over two batches of
+// slack before the comms task falls behind and samples are dropped.
+static SpscQueue<TelemetrySample, 64> sampleQueue;
+static std::atomic<bool> streaming(false);
+static std::atomic<uint32_t> samplePeriodMs(2);
+static uint32_t lastSampleMs = 0;  // Motion task
+
+// Comms task state
+static WiFiUDP telemetryUdp;
+static IPAddress telemetryHost;
+static uint16_t telemetryPort = 0;
+static uint8_t packet[sizeof(TelemetryPacketHeader) + TELEMETRY_BATCH_SAMPLES * sizeof(TelemetrySample)];
+static uint16_t batchCount = 0;
+static uint32_t batchStartMs = 0;
+static uint32_t packetSequence = 0;
+static uint32_t droppedAtStart = 0;
+static uint32_t samplesSent = 0;
+static uint32_t sendFailures = 0;
+
+//* ************************************************************************
+//* ************************ SAMPLING ***************************
+//* ************************************************************************
+
+// Clamp a value into a 16-bit sample field
+static int16_t clampToInt16(long value) {
+  if (value > INT16_MAX) return INT16_MAX;
+  if (value < INT16_MIN) return INT16_MIN;
+  return (int16_t)value;
+}
+
+// Motion task: take a sample if streaming and one is due
+void recordTelemetrySample() {
+  if (!streaming.load(std::memory_order_acquire)) {
+    return;
+  }
+  uint32_t now = millis();
+  if (now - lastSampleMs < samplePeriodMs.load(std::memory_order_relaxed)) {
+    return;
+  }
+  lastSampleMs = now;
+
+  TelemetrySample* sample = sampleQueue.reserve();
+  if (sample == nullptr) {
+    return;  // Comms task behind - counted by the queue and reported in the packet header
+  }
+  StepperAxis& xAxis = transferArm.getXStepper();
+  StepperAxis& zAxis = transferArm.getZStepper();
+  sample->timestamp = micros();
+  sample->xPosition = xAxis.currentPosition();
+  sample->zPosition = zAxis.currentPosition();
+  sample->xSpeed = clampToInt16(q16ToInt(xAxis.speed()));
+  sample->zSpeed = clampToInt16(q16ToInt(zAxis.speed()));
+  sample->servoAngle = clampToInt16(lroundf(transferArm.getServoPosition() * 100.0f));
+  sample->outputs = 0;
+  if (digitalRead(SOLENOID_RELAY_PIN) == HIGH) sample->outputs |= 1 << TELEMETRY_OUTPUT_VACUUM;
+  if (isPulseActive(PULSE_STAGE2_SIGNAL)) sample->outputs |= 1 << TELEMETRY_OUTPUT_STAGE2_SIGNAL;
+  sample->inputs = readTraceInputs();
+  sample->phase = getPickCyclePhase();
+  sample->reserved[0] = sample->reserved[1] = sample->reserved[2] = 0;
+  sampleQueue.commit();
+}
+
+//* ************************************************************************
+//* ************************ SENDING ***************************
+//* ************************************************************************
+
+// Send the samples batched so far as one datagram
+static void sendBatch() {
+  TelemetryPacketHeader header;
+  header.magic = TELEMETRY_MAGIC;
+  header.version = TELEMETRY_VERSION;
+  header.sampleSize = sizeof(TelemetrySample);
+  header.sampleCount = batchCount;
+  header.sequence = packetSequence++;
+  header.dropped = sampleQueue.droppedCount() - droppedAtStart;
+  memcpy(packet, &header, sizeof(header));
+
+  size_t length = sizeof(header) + batchCount * sizeof(TelemetrySample);
+  if (telemetryUdp.beginPacket(telemetryHost, telemetryPort) && telemetryUdp.write(packet, length) == length &&
+      telemetryUdp.endPacket()) {
+    samplesSent += batchCount;
+  } else {
+    sendFailures++;
+  }
+  batchCount = 0;
+}
+
+// Comms task: batch queued samples and send full or aged batches
+void updateTelemetry() {
+  if (!streaming.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  TelemetrySample sample;
+  while (sampleQueue.pop(sample)) {
+    if (batchCount == 0) {
+      batchStartMs = millis();
+    }
+    memcpy(packet + sizeof(TelemetryPacketHeader) + batchCount * sizeof(TelemetrySample), &sample, sizeof(sample));
+    batchCount++;
+    if (batchCount == TELEMETRY_BATCH_SAMPLES) {
+      sendBatch();
+    }
+  }
+  if (batchCount > 0 && millis() - batchStartMs >= TELEMETRY_MAX_BATCH_MS) {
+    sendBatch();
+  }
+}
+
+//* ************************************************************************
+//* ************************ CONTROL ***************************
+//* ************************************************************************
+
+// Start streaming to a host; false if the rate is out of range
+bool startTelemetry(const IPAddress& host, uint16_t port, uint32_t rateHz) {
+  if (rateHz == 0 || rateHz > TELEMETRY_MAX_RATE_HZ || port == 0) {
+    return false;
+  }
+
+  streaming.store(false, std::memory_order_release);
+  TelemetrySample discarded;
+  while (sampleQueue.pop(discarded)) {
+  }
+  telemetryHost = host;
+  telemetryPort = port;
+  batchCount = 0;
+  packetSequence = 0;
+  samplesSent = 0;
+  sendFailures = 0;
+  droppedAtStart = sampleQueue.droppedCount();
+  samplePeriodMs.store(1000 / rateHz, std::memory_order_relaxed);
+  streaming.store(true, std::memory_order_release);
+
+  LOG_INFO("Telemetry streaming to %u.%u.%u.%u:%u every %lu ms", host[0], host[1], host[2], host[3], port,
+           (unsigned long)(1000 / rateHz));
+  return true;
+}
+
+// Stop streaming (a partial batch is discarded)
+void stopTelemetry() {
+  streaming.store(false, std::memory_order_release);
+  batchCount = 0;
+  LOG_INFO("Telemetry stopped");
+}
+
+// Print stream state and counters
+void reportTelemetry() {
+  if (!streaming.load(std::memory_order_relaxed)) {
+    Serial.println("Telemetry: off");
+  } else {
+    serialPrintf("Telemetry: streaming to %u.%u.%u.%u:%u at %lu Hz\n", telemetryHost[0], telemetryHost[1],
+                 telemetryHost[2], telemetryHost[3], telemetryPort,
+                 (unsigned long)(1000 / samplePeriodMs.load(std::memory_order_relaxed)));
+  }
+  serialPrintf("  %lu packets, %lu samples sent, %lu samples dropped, %lu send failures\n",
+               (unsigned long)packetSequence, (unsigned long)samplesSent,
+               (unsigned long)(sampleQueue.droppedCount() - droppedAtStart), (unsigned long)sendFailures);
+}
@@ -0,0 +1,201 @@
+#include "../include/TraceStore.h"
+#include "../include/TransferArm.h"
+#include "../include/PickCycle.h"
+#include "../include/EventTrace.h"
+#include "../include/Utils.h"
+#include <atomic>
+
+//* ************************************************************************
+//* ************************ TRACE STORE ***************************
+//* ************************************************************************
+
+// One circular tier. Sample n lives in slot n % capacity and was taken at
+// startMs + n * periodMs.
+struct HistoryTier {
+  const char* name;
+  HistorySample* samples;
+  uint32_t capacity;
+  uint32_t periodMs;
+  uint32_t startMs;
+  std::atomic<uint32_t> written;  // Samples written since start (motion task writes, comms reads)
+};
+
+static HistoryTier fineTier = {"fine", nullptr, 0, 1, 0, {0}};
+static HistoryTier coarseTier = {"coarse", nullptr, 0, 100, 0, {0}};
+static HistoryTier* const historyTiers[] = {&fineTier, &coarseTier};
+static const uint8_t HISTORY_TIER_COUNT = sizeof(historyTiers) / sizeof(historyTiers[0]);
+static bool traceStoreStarted = false;
+
+// Allocate one tier in PSRAM
+static bool allocateTier(HistoryTier& tier, uint32_t bytes, uint32_t periodMs) {
+  tier.capacity = bytes / sizeof(HistorySample);
+  tier.periodMs = (periodMs > 0) ? periodMs : 1;
+  tier.samples = (HistorySample*)ps_malloc((size_t)tier.capacity * sizeof(HistorySample));
+  if (tier.samples == nullptr) {
+    tier.capacity = 0;
+    LOG_ERROR("Trace store: could not allocate %lu bytes of PSRAM for the %s tier", (unsigned long)bytes,
+              tier.name);
+    return false;
+  }
+  return true;
+}
+
+// Allocate both tiers in PSRAM
+bool beginTraceStore() {
+  if (!psramFound()) {
+    LOG_WARN("Trace store disabled - no PSRAM found");
+    return false;
+  }
+
+  bool fineReady = allocateTier(fineTier, TRACE_STORE_FINE_BYTES, TRACE_STORE_FINE_PERIOD_MS);
+  bool coarseReady = allocateTier(coarseTier, TRACE_STORE_COARSE_BYTES, TRACE_STORE_COARSE_PERIOD_MS);
+  LOG_INFO("Trace store: %lu fine samples every %lu ms, %lu coarse samples every %lu ms",
+           (unsigned long)fineTier.capacity, (unsigned long)fineTier.periodMs, (unsigned long)coarseTier.capacity,
+           (unsigned long)coarseTier.periodMs);
+  return fineReady || coarseReady;
+}
+
+//* ************************************************************************
+//* ************************ RECORDING ***************************
+//* ************************************************************************
+
+// Clamp a value into a 16-bit sample field
+static int16_t clampToInt16(long value) {
+  if (value > INT16_MAX) return INT16_MAX;
+  if (value < INT16_MIN) return INT16_MIN;
+  return (int16_t)value;
+}
+
+// Debounced inputs, bit n = TraceInput n
+uint8_t readTraceInputs() {
+  uint8_t inputs = 0;
+  if (transferArm.getStartButton().read()) inputs |= 1 << TRACE_INPUT_START_BUTTON;
+  if (transferArm.getStage1Signal().read()) inputs |= 1 << TRACE_INPUT_STAGE1;
+  if (transferArm.getStopSignalStage2().read()) inputs |= 1 << TRACE_INPUT_STAGE2_STOP;
+  if (transferArm.getXHomeSwitch().read()) inputs |= 1 << TRACE_INPUT_X_HOME;
+  if (transferArm.getZHomeSwitch().read()) inputs |= 1 << TRACE_INPUT_Z_HOME;
+  return inputs;
+}
+
+// Current machine state as one sample
+static HistorySample takeSample() {
+  StepperAxis& xAxis = transferArm.getXStepper();
+  StepperAxis& zAxis = transferArm.getZStepper();
+
+  HistorySample sample;
+  sample.xPosition = clampToInt16(xAxis.currentPosition());
+  sample.zPosition = clampToInt16(zAxis.currentPosition());
+  sample.xSpeed = clampToInt16(q16ToInt(xAxis.speed()));
+  sample.zSpeed = clampToInt16(q16ToInt(zAxis.speed()));
+  sample.inputs = readTraceInputs();
+  sample.phase = getPickCyclePhase();
+  return sample;
+}
+
+// Write every sample the tier is due, repeating the current one for periods
+// the motion task missed, so sample indexes stay on the time grid
+static void recordTier(HistoryTier& tier, uint32_t now, const HistorySample& sample) {
+  if (tier.samples == nullptr) {
+    return;
+  }
+  uint32_t due = (now - tier.startMs) / tier.periodMs + 1;
+  uint32_t written = tier.written.load(std::memory_order_relaxed);
+  while (written != due) {
+    tier.samples[written % tier.capacity] = sample;
+    written++;
+    tier.written.store(written, std::memory_order_release);
+  }
+}
+
+// Motion task: record the current state if a sample is due
+void recordTraceStoreSample() {
+  uint32_t now = millis();
+  if (!traceStoreStarted) {
+    for (uint8_t i = 0; i < HISTORY_TIER_COUNT; i++) {
+      historyTiers[i]->startMs = now;
+    }
+    traceStoreStarted = true;
+  }
+
+  HistorySample sample = takeSample();
+  for (uint8_t i = 0; i < HISTORY_TIER_COUNT; i++) {
+    recordTier(*historyTiers[i], now, sample);
+  }
+}
+
+//* ************************************************************************
+//* ************************ QUERIES ***************************
+//* ************************************************************************
+
+// Oldest sample index still held by the tier
+static uint32_t oldestIndex(const HistoryTier& tier, uint32_t written) {
+  return (written > tier.capacity) ? written - tier.capacity : 0;
+}
+
+// Copy sample n; false if the writer has reused its slot meanwhile
+static bool readSample(const HistoryTier& tier, uint32_t index, HistorySample& sample) {
+  sample = tier.samples[index % tier.capacity];
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint32_t written = tier.written.load(std::memory_order_acquire);
+  return index + tier.capacity > written;
+}
+
+// Print tier sizes, rates and the time span each one covers
+void reportTraceStore() {
+  for (uint8_t i = 0; i < HISTORY_TIER_COUNT; i++) {
+    const HistoryTier& tier = *historyTiers[i];
+    if (tier.samples == nullptr) {
+      serialPrintf("Trace store %s: not allocated\n", tier.name);
+      continue;
+    }
+    uint32_t written = tier.written.load(std::memory_order_acquire);
+    uint32_t held = written - oldestIndex(tier, written);
+    serialPrintf("Trace store %s: every %lu ms, %lu of %lu samples, last %.1f of %.1f minutes\n", tier.name,
+                 (unsigned long)tier.periodMs, (unsigned long)held, (unsigned long)tier.capacity,
+                 (float)held * tier.periodMs / 60000.0f, (float)tier.capacity * tier.periodMs / 60000.0f);
+  }
+}
+
+// Print durationSeconds of samples starting secondsAgo seconds back
+void queryTraceStore(uint32_t secondsAgo, uint32_t durationSeconds, uint32_t stepMs) {
+  uint32_t now = millis();
+  uint32_t windowStart = (secondsAgo * 1000UL < now) ? now - secondsAgo * 1000UL : 0;
+  uint32_t windowEnd = windowStart + durationSeconds * 1000UL;
+
+  // Finest tier that still holds the start of the window, else the longest one
+  const HistoryTier* tier = nullptr;
+  for (uint8_t i = 0; i < HISTORY_TIER_COUNT; i++) {
+    const HistoryTier& candidate = *historyTiers[i];
+    if (candidate.samples == nullptr) continue;
+    tier = &candidate;
+    uint32_t written = candidate.written.load(std::memory_order_acquire);
+    uint32_t oldestTime = candidate.startMs + oldestIndex(candidate, written) * candidate.periodMs;
+    if ((int32_t)(windowStart - oldestTime) >= 0) break;
+  }
+  if (tier == nullptr || !traceStoreStarted) {
+    Serial.println("Trace store is empty");
+    return;
+  }
+
+  uint32_t step = (stepMs > tier->periodMs) ? stepMs / tier->periodMs : 1;  // In samples
+  uint32_t written = tier->written.load(std::memory_order_acquire);
+  uint32_t first = ((int32_t)(windowStart - tier->startMs) > 0) ? (windowStart - tier->startMs) / tier->periodMs : 0;
+  uint32_t last = ((int32_t)(windowEnd - tier->startMs) > 0) ? (windowEnd - tier->startMs) / tier->periodMs : 0;
+  if (first < oldestIndex(*tier, written)) first = oldestIndex(*tier, written);
+  if (last >= written) last = written - 1;
+
+  serialPrintf("# history from %s tier, %lu ms per line\n", tier->name, (unsigned long)(step * tier->periodMs));
+  Serial.println("time_ms,x,z,x_speed,z_speed,inputs,main_state,sub_state");
+  uint32_t lines = 0;
+  for (uint32_t index = first; index <= last && written > 0; index += step) {
+    HistorySample sample;
+    if (!readSample(*tier, index, sample)) {
+      continue;  // Overwritten while printing
+    }
+    serialPrintf("%lu,%d,%d,%d,%d,0x%02x,%u,%u\n", (unsigned long)(tier->startMs + index * tier->periodMs),
+                 sample.xPosition, sample.zPosition, sample.xSpeed, sample.zSpeed, sample.inputs,
+                 sample.phase >> 4, sample.phase & 0x0F);
+    lines++;
+  }
+  serialPrintf("# %lu samples\n", (unsigned long)lines);
+}
@@ -0,0 +1,138 @@
+#include "../include/TriggerCapture.h"
+#include "../include/SpscQueue.h"
+#include "../include/LatencyStats.h"
+#include "../include/Utils.h"
+#include "Config/Config.h"
+#include "Config/Pins_Definitions.h"
+
+//* ************************************************************************
+//* ************************ TRIGGER CAPTURE ***************************
+//* ************************************************************************
+
+static const uint8_t TRIGGER_SOURCE_COUNT = 2;
+
+static SpscQueue<CapturedTrigger, 8> edgeQueue;     // ISR -> motion task, unconfirmed edges
+static SpscQueue<CapturedTrigger, 8> pendingQueue;  // Motion task only, confirmed triggers
+
+// ISR state
+static uint8_t sourcePins[TRIGGER_SOURCE_COUNT];
+static volatile uint32_t lastEdgeMicros[TRIGGER_SOURCE_COUNT];
+static volatile uint32_t bounceCount = 0;
+static uint32_t bounceWindowMicros = 0;  // TRIGGER_CONFIRM_MS, copied for the ISR
+
+// Motion task state
+static CapturedTrigger candidate;  // Edge waiting for confirmation
+static bool candidateHeld = false;
+static uint32_t capturedCount = 0;
+static uint32_t glitchCount = 0;
+static uint32_t expiredCount = 0;
+static bool awaitingMotion = false;
+static uint32_t awaitingTriggerMicros = 0;
+
+// Rising edge ISR - context is the TriggerSource
+static void IRAM_ATTR handleTriggerEdge(void* context) {
+  uint8_t source = (uint8_t)(uintptr_t)context;
+  uint32_t now = micros();
+  if (now - lastEdgeMicros[source] < bounceWindowMicros) {
+    lastEdgeMicros[source] = now;  // Still bouncing - extend the window
+    bounceCount++;
+    return;
+  }
+  lastEdgeMicros[source] = now;
+
+  CapturedTrigger edge;
+  edge.timestamp = now;
+  edge.source = source;
+  edgeQueue.push(edge);  // Counts a drop when full
+}
+
+// Attach the edge interrupts
+void beginTriggerCapture() {
+  sourcePins[TRIGGER_SOURCE_START_BUTTON] = (uint8_t)START_BUTTON_PIN;
+  sourcePins[TRIGGER_SOURCE_STAGE1] = (uint8_t)STAGE1_SIGNAL_PIN;
+  bounceWindowMicros = TRIGGER_CONFIRM_MS * 1000UL;
+  uint32_t now = micros();
+  for (uint8_t source = 0; source < TRIGGER_SOURCE_COUNT; source++) {
+    lastEdgeMicros[source] = now - bounceWindowMicros;
+    attachInterruptArg(digitalPinToInterrupt(sourcePins[source]), handleTriggerEdge, (void*)(uintptr_t)source,
+                       RISING);
+  }
+  LOG_INFO("Trigger capture attached to start button and Stage 1 signal");
+}
+
+//* ************************************************************************
+//* ************************ MOTION TASK ***************************
+//* ************************************************************************
+
+// Confirm captured edges once the input has stayed HIGH
+void updateTriggerCapture() {
+  uint32_t now = micros();
+  for (;;) {
+    if (!candidateHeld) {
+      if (!edgeQueue.pop(candidate)) {
+        return;
+      }
+      candidateHeld = true;
+    }
+    if (now - candidate.timestamp < TRIGGER_CONFIRM_MS * 1000UL) {
+      return;  // Not settled yet
+    }
+    candidateHeld = false;
+
+    if (digitalRead(sourcePins[candidate.source]) == HIGH) {
+      capturedCount++;
+      if (!pendingQueue.push(candidate)) {
+        LOG_WARN("Trigger queue full - trigger dropped");
+      }
+    } else {
+      glitchCount++;
+    }
+  }
+}
+
+// Take the oldest pending trigger, discarding stale ones
+bool takeTrigger(CapturedTrigger& trigger) {
+  uint32_t now = micros();
+  while (pendingQueue.pop(trigger)) {
+    uint32_t ageMs = (now - trigger.timestamp) / 1000;
+    if (ageMs > TRIGGER_MAX_AGE_MS) {
+      expiredCount++;
+      LOG_WARN("Discarded trigger from %lu ms ago", (unsigned long)ageMs);
+      continue;
+    }
+    awaitingMotion = true;
+    awaitingTriggerMicros = trigger.timestamp;
+    return true;
+  }
+  return false;
+}
+
+// Record trigger-to-motion latency once an axis starts moving
+void updateTriggerLatency(bool axisMoving) {
+  if (awaitingMotion && axisMoving) {
+    getLatencyHistogram(LATENCY_TRIGGER_TO_MOTION).record(micros() - awaitingTriggerMicros);
+    awaitingMotion = false;
+  }
+}
+
+// Drop every captured and pending trigger
+void discardPendingTriggers() {
+  CapturedTrigger trigger;
+  while (edgeQueue.pop(trigger)) {
+  }
+  while (pendingQueue.pop(trigger)) {
+  }
+  candidateHeld = false;
+  awaitingMotion = false;
+}
+
+TriggerCaptureStats getTriggerCaptureStats() {
+  TriggerCaptureStats stats;
+  stats.captured = capturedCount;
+  stats.bounces = bounceCount;
+  stats.glitches = glitchCount;
+  stats.dropped = edgeQueue.droppedCount() + pendingQueue.droppedCount();
+  stats.expired = expiredCount;
+  stats.pending = pendingQueue.size() + edgeQueue.size() + (candidateHeld ? 1 : 0);
+  return stats;
+}
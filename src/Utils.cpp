@@ -2,10 +2,13 @@
 #include "Config/Config.h"
 #include "Config/Pins_Definitions.h"
 #include "../include/TransferArm.h"
-#include <AccelStepper.h>
+#include "../include/MotionHandle.h"
+#include "../include/MotionProfile.h"
+#include "../include/PulseOutput.h"
 #include <Arduino.h>
 #include <Bounce2.h>
 #include <ESP32Servo.h>
+#include <stdarg.h>
 
 //* ************************************************************************
 //* ************************ UTILITY FUNCTIONS ***************************
@@ -17,42 +20,21 @@
 //* ************************ MOVEMENT FUNCTIONS ***************************
 //* ************************************************************************
 
-// Move a stepper to a position and return true when motion is complete
-bool moveToPosition(AccelStepper& stepper, float position) {
-  static float lastTarget = -999999.0;   // Track the last target position
-  static bool motionStarted = false;     // Track if motion has started
-
-  // If this is a new target position or motion hasn't started yet
-  if (position != lastTarget || !motionStarted) {
-    smartLog("Setting new target position: " + String(position) +
-             ", Current pos: " + String(stepper.currentPosition()));
-
-    // Set the target position
-    stepper.moveTo(position);
-    lastTarget = position;
-    motionStarted = true;
-    return false;  // Motion is not complete
-  }
-
-  // Return true if the motor has reached the target position
-  if (stepper.distanceToGo() == 0) {
-    motionStarted = false;  // Reset for next movement
-    return true;            // Motion is complete
-  }
-
-  return false;  // Motion is still in progress
+// Completion callback for helper moves - context is the arrival message
+static void logMoveComplete(void* context) {
+  LOG_DEBUG((const char*)context);
 }
 
 // Activate vacuum solenoid (cylinder extended)
 void activateVacuum() {
-  digitalWrite(SOLENOID_RELAY_PIN, HIGH);
-  smartLog("Vacuum activated (cylinder extended)");
+  traceDigitalWrite(SOLENOID_RELAY_PIN, HIGH);
+  LOG_DEBUG("Vacuum activated (cylinder extended)");
 }
 
 // Deactivate vacuum solenoid (cylinder retracted)
 void deactivateVacuum() {
-  digitalWrite(SOLENOID_RELAY_PIN, LOW);
-  smartLog("Vacuum deactivated (cylinder retracted)");
+  traceDigitalWrite(SOLENOID_RELAY_PIN, LOW);
+  LOG_DEBUG("Vacuum deactivated (cylinder retracted)");
 }
 
 //* ************************************************************************
@@ -88,25 +70,25 @@ void resetStateTimer(unsigned long* timer) {
 // Set servo to pickup position
 void setServoPickup() {
   transferArm.setServoPosition(SERVO_PICKUP_POS);
-  smartLog("Servo set to pickup position: " + String(SERVO_PICKUP_POS));
+  LOG_DEBUG("Servo set to pickup position: %.2f", SERVO_PICKUP_POS);
 }
 
 // Set servo to travel position
 void setServoTravel() {
   transferArm.setServoPosition(SERVO_TRAVEL_POS);
-  smartLog("Servo set to travel position: " + String(SERVO_TRAVEL_POS));
+  LOG_DEBUG("Servo set to travel position: %.2f", SERVO_TRAVEL_POS);
 }
 
 // Set servo to dropoff position
 void setServoDropoff() {
   transferArm.setServoPosition(SERVO_DROPOFF_POS);
-  smartLog("Servo set to dropoff position: " + String(SERVO_DROPOFF_POS));
+  LOG_DEBUG("Servo set to dropoff position: %.2f", SERVO_DROPOFF_POS);
 }
 
 // Set servo to home position
 void setServoHome() {
   transferArm.setServoPosition(SERVO_HOME_POS);
-  smartLog("Servo set to home position: " + String(SERVO_HOME_POS));
+  LOG_DEBUG("Servo set to home position: %.2f", SERVO_HOME_POS);
 }
 
 //* ************************************************************************
@@ -126,42 +108,114 @@ void setZAxisDropoffSpeed() {
 }
 
 // Move Z to pickup position
-void moveZToPickup() {
-  transferArm.getZStepper().moveTo(Z_PICKUP_POS);
+MotionHandle moveZToPickup() {
+  return moveAxisTo(transferArm.getZStepper(), Z_PICKUP_POS);
 }
 
 // Move Z to up position
-void moveZToUp() {
-  transferArm.getZStepper().moveTo(Z_UP_POS);
+MotionHandle moveZToUp() {
+  return moveAxisTo(transferArm.getZStepper(), Z_UP_POS);
 }
 
 // Move Z to dropoff position
-void moveZToDropoff() {
-  transferArm.getZStepper().moveTo(Z_DROPOFF_POS);
+MotionHandle moveZToDropoff() {
+  return moveAxisTo(transferArm.getZStepper(), Z_DROPOFF_POS);
+}
+
+// Move X to pickup position - non-blocking, logs on arrival
+MotionHandle moveXToPickup() {
+  LOG_DEBUG("Moving X to pickup position: %ld", X_PICKUP_POS);
+  return moveAxisTo(transferArm.getXStepper(), X_PICKUP_POS,
+                    logMoveComplete, (void*)"X reached pickup position");
 }
 
-// Move X to pickup position - BLOCKING
-void moveXToPickup() {
-  transferArm.getXStepper().moveTo(X_PICKUP_POS);
-  smartLog("Moving X to pickup position: " + String(X_PICKUP_POS));
-  transferArm.getXStepper().runToPosition();  // Blocking call
-  smartLog("X reached pickup position");
+// Move X to dropoff position - non-blocking, logs on arrival
+MotionHandle moveXToDropoff() {
+  LOG_DEBUG("Moving X to dropoff position: %ld", X_DROPOFF_POS);
+  return moveAxisTo(transferArm.getXStepper(), X_DROPOFF_POS,
+                    logMoveComplete, (void*)"X reached dropoff position");
 }
 
-// Move X to dropoff position - BLOCKING
-void moveXToDropoff() {
-  transferArm.getXStepper().moveTo(X_DROPOFF_POS);
-  smartLog("Moving X to dropoff position: " + String(X_DROPOFF_POS));
-  transferArm.getXStepper().runToPosition();  // Blocking call
-  smartLog("X reached dropoff position");
+// Move X to dropoff overshoot position - non-blocking, logs on arrival
+MotionHandle moveXToDropoffOvershoot() {
+  LOG_DEBUG("Moving X to dropoff overshoot position: %ld", X_DROPOFF_OVERSHOOT_POS);
+  return moveAxisTo(transferArm.getXStepper(), X_DROPOFF_OVERSHOOT_POS,
+                    logMoveComplete, (void*)"X reached dropoff overshoot position");
 }
 
-// Move X to dropoff overshoot position - BLOCKING
-void moveXToDropoffOvershoot() {
-  transferArm.getXStepper().moveTo(X_DROPOFF_OVERSHOOT_POS);
-  smartLog("Moving X to dropoff overshoot position: " + String(X_DROPOFF_OVERSHOOT_POS));
-  transferArm.getXStepper().runToPosition();  // Blocking call
-  smartLog("X reached dropoff overshoot position");
+// Move X back to the home switch position - non-blocking, logs on arrival
+MotionHandle moveXToHome() {
+  LOG_DEBUG("Moving X to home position: %ld", X_HOME_POS);
+  return moveAxisTo(transferArm.getXStepper(), X_HOME_POS,
+                    logMoveComplete, (void*)"X reached home position");
+}
+
+//* ************************************************************************
+//* ************************ PROFILE FUNCTIONS ***************************
+//* ************************************************************************
+
+// Cache one move and log the result
+static void cacheAxisMove(StepperAxis& axis, const char* name, long from, long to) {
+  if (!axis.cacheMove(from, to)) {
+    LOG_WARN("Move not cached: %s", name);
+  }
+}
+
+// Precompute step interval tables for the fixed production moves so they
+// run from a table lookup per step. Limits must already be configured;
+// Z dropoff moves are cached with the dropoff speed settings they run at.
+void cacheProductionMoves() {
+  StepperAxis& xAxis = transferArm.getXStepper();
+  StepperAxis& zAxis = transferArm.getZStepper();
+
+  cacheAxisMove(xAxis, "X pickup -> overshoot", X_PICKUP_POS, X_DROPOFF_OVERSHOOT_POS);
+  cacheAxisMove(xAxis, "X overshoot -> dropoff", X_DROPOFF_OVERSHOOT_POS, X_DROPOFF_POS);
+  cacheAxisMove(xAxis, "X pickup -> dropoff", X_PICKUP_POS, X_DROPOFF_POS);
+  cacheAxisMove(xAxis, "X dropoff -> pickup", X_DROPOFF_POS, X_PICKUP_POS);
+  cacheAxisMove(xAxis, "X dropoff -> drift check", X_DROPOFF_POS, X_HOME_POS - X_DRIFT_CHECK_OVERTRAVEL_STEPS);
+  cacheAxisMove(xAxis, "X dropoff -> home approach", X_DROPOFF_POS, X_HOME_POS + HOME_BACKOFF_STEPS);
+
+  setZAxisNormalSpeed();
+  cacheAxisMove(zAxis, "Z up -> pickup", Z_UP_POS, Z_PICKUP_POS);
+  cacheAxisMove(zAxis, "Z pickup -> up", Z_PICKUP_POS, Z_UP_POS);
+  cacheAxisMove(zAxis, "Z dropoff -> up", Z_DROPOFF_POS, Z_UP_POS);
+
+  setZAxisDropoffSpeed();
+  cacheAxisMove(zAxis, "Z up -> dropoff", Z_UP_POS, Z_DROPOFF_POS);
+  setZAxisNormalSpeed();
+
+  LOG_INFO("Production moves cached");
+}
+
+// Print the ideal time of one production leg under both profile types
+static void reportLeg(const char* name, const ProfileLimits& limits, long from, long to) {
+  long distance = to - from;
+  float trapezoid = estimateMoveTime(limits, PROFILE_TRAPEZOID, distance);
+  float sCurve = estimateMoveTime(limits, PROFILE_SCURVE, distance);
+  serialPrintf("%s: %ld steps, trapezoid %.1f ms, S-curve %.1f ms\n", name, distance, trapezoid * 1000.0f,
+               sCurve * 1000.0f);
+}
+
+// Compare move times for the pickup -> overshoot -> dropoff legs using the
+// configured speed, acceleration and jerk limits (serial command output,
+// not filtered by log level)
+void reportProfileMoveTimes() {
+  ProfileLimits xLimits = {q16ToFloat(X_MAX_SPEED), q16ToFloat(X_ACCELERATION), (float)X_JERK};
+  ProfileLimits zLimits = {q16ToFloat(Z_MAX_SPEED), q16ToFloat(Z_ACCELERATION), (float)Z_JERK};
+  ProfileLimits zDropoffLimits = {q16ToFloat(Z_DROPOFF_MAX_SPEED), q16ToFloat(Z_DROPOFF_ACCELERATION), (float)Z_JERK};
+
+  serialPrintf("Move time estimates (X jerk %ld, Z jerk %ld):\n", X_JERK, Z_JERK);
+  reportLeg("Z pickup lower", zLimits, Z_UP_POS, Z_PICKUP_POS);
+  reportLeg("Z pickup raise", zLimits, Z_PICKUP_POS, Z_UP_POS);
+  reportLeg("X pickup -> overshoot", xLimits, X_PICKUP_POS, X_DROPOFF_OVERSHOOT_POS);
+  reportLeg("X overshoot -> dropoff", xLimits, X_DROPOFF_OVERSHOOT_POS, X_DROPOFF_POS);
+  reportLeg("Z dropoff lower", zDropoffLimits, Z_UP_POS, Z_DROPOFF_POS);
+
+  float xTrapezoid = estimateMoveTime(xLimits, PROFILE_TRAPEZOID, X_DROPOFF_OVERSHOOT_POS - X_PICKUP_POS) +
+                     estimateMoveTime(xLimits, PROFILE_TRAPEZOID, X_DROPOFF_OVERSHOOT_POS - X_DROPOFF_POS);
+  float xSCurve = estimateMoveTime(xLimits, PROFILE_SCURVE, X_DROPOFF_OVERSHOOT_POS - X_PICKUP_POS) +
+                  estimateMoveTime(xLimits, PROFILE_SCURVE, X_DROPOFF_OVERSHOOT_POS - X_DROPOFF_POS);
+  serialPrintf("X transfer total: trapezoid %.1f ms, S-curve %.1f ms\n", xTrapezoid * 1000.0f, xSCurve * 1000.0f);
 }
 
 //* ************************************************************************
@@ -183,6 +237,17 @@ bool isZAtSuctionStart() {
   return (transferArm.getZStepper().currentPosition() >= Z_SUCTION_START_POS);
 }
 
+// X target for the move out of pickup - straight to dropoff when the servo
+// rotates in motion, otherwise the overshoot position
+long getTransportXTarget() {
+  return (TRANSPORT_MODE == TRANSPORT_MODE_ROTATE_IN_MOTION) ? X_DROPOFF_POS : X_DROPOFF_OVERSHOOT_POS;
+}
+
+// Descent gate for blended moves - Stage 2 must signal safe before Z lowers
+bool stage2AllowsZLowering() {
+  return transferArm.isStage2SafeForZLowering();
+}
+
 //* ************************************************************************
 //* ************************ STATE FUNCTIONS ***************************
 //* ************************************************************************
@@ -233,19 +298,28 @@ const char* getStateString(PickCycleState state) {
 //* ************************ SIGNAL FUNCTIONS ***************************
 //* ************************************************************************
 
-// Send signal pulse to Stage 2
+// Send signal pulse to Stage 2 (returns at once, a timer ends the pulse)
 void signalStage2() {
-  digitalWrite(STAGE2_SIGNAL_PIN, HIGH);
-  delay(100);  // Brief pulse
-  digitalWrite(STAGE2_SIGNAL_PIN, LOW);
-  smartLog("Stage 2 signal sent");
+  if (!pulseOutput(PULSE_STAGE2_SIGNAL)) {
+    LOG_ERROR("Stage 2 signal pulse could not be started");
+    return;
+  }
+  LOG_DEBUG("Stage 2 signal sent");
 }
 
 //* ************************************************************************
-//* ************************ LOGGING FUNCTIONS ***************************
+//* ************************ OUTPUT FUNCTIONS ***************************
 //* ************************************************************************
 
-// Smart logging function - outputs to Serial only
-void smartLog(const String& message) {
-  Serial.println(message);
-}
\ No newline at end of file
+// printf to Serial without touching the heap
+void serialPrintf(const char* format, ...) {
+  char buffer[SERIAL_PRINTF_BUFFER];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (length <= 0) {
+    return;
+  }
+  Serial.write((const uint8_t*)buffer, ((size_t)length < sizeof(buffer)) ? (size_t)length : sizeof(buffer) - 1);
+}
@@ -0,0 +1,449 @@
+#include "../../include/HostDashboardServer.h"
+#include "Config/Config.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+//* ************************************************************************
+//* ************************ HOST DASHBOARD SERVER ***************************
+//* ************************************************************************
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // A client that disconnects mid-send must not raise SIGPIPE
+#endif
+
+static const int HOST_DASHBOARD_CLIENT_MAX = 4;
+static const size_t CLIENT_BUFFER_SIZE = 2048;  // Handshake request, or unread frames
+
+// Frame opcodes (RFC 6455 section 5.2)
+enum WebSocketOpcode : uint8_t {
+  OPCODE_TEXT = 0x1,
+  OPCODE_CLOSE = 0x8,
+  OPCODE_PING = 0x9,
+  OPCODE_PONG = 0xA
+};
+
+struct HostClient {
+  bool connected;  // Slot in use
+  bool upgraded;   // Handshake done, frames from here on
+  int socket;
+  uint8_t input[CLIENT_BUFFER_SIZE];
+  size_t inputLength;
+};
+
+static int listenSocket = -1;
+static uint16_t boundPort = 0;
+static HostClient clients[HOST_DASHBOARD_CLIENT_MAX];
+static void (*commandHandler)(char* line) = nullptr;
+static DashboardStatus currentStatus;
+static bool haveStatus = false;
+static DashboardPushState pushState = {};
+static uint32_t lastPushMs = 0;
+
+static uint32_t hostMillis() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)(now.tv_sec * 1000 + now.tv_nsec / 1000000);
+}
+
+//* ************************************************************************
+//* ************************ HANDSHAKE ***************************
+//* ************************************************************************
+
+static uint32_t rotateLeft(uint32_t value, int bits) {
+  return (value << bits) | (value >> (32 - bits));
+}
+
+// SHA-1 of a short message (the handshake key plus the RFC 6455 GUID)
+static void sha1(const uint8_t* data, size_t length, uint8_t digest[20]) {
+  uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+  uint64_t bitLength = (uint64_t)length * 8;
+  size_t paddedLength = ((length + 8) / 64 + 1) * 64;
+
+  for (size_t block = 0; block < paddedLength; block += 64) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) {
+      w[i] = 0;
+      for (int j = 0; j < 4; j++) {
+        size_t index = block + i * 4 + j;
+        uint8_t byte;
+        if (index < length) {
+          byte = data[index];
+        } else if (index == length) {
+          byte = 0x80;
+        } else if (index >= paddedLength - 8) {
+          byte = (uint8_t)(bitLength >> (8 * (paddedLength - 1 - index)));
+        } else {
+          byte = 0;
+        }
+        w[i] = (w[i] << 8) | byte;
+      }
+    }
+    for (int i = 16; i < 80; i++) {
+      w[i] = rotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+      uint32_t f, k;
+      if (i < 20) {
+        f = (b & c) | (~b & d);
+        k = 0x5A827999;
+      } else if (i < 40) {
+        f = b ^ c ^ d;
+        k = 0x6ED9EBA1;
+      } else if (i < 60) {
+        f = (b & c) | (b & d) | (c & d);
+        k = 0x8F1BBCDC;
+      } else {
+        f = b ^ c ^ d;
+        k = 0xCA62C1D6;
+      }
+      uint32_t temp = rotateLeft(a, 5) + f + e + k + w[i];
+      e = d;
+      d = c;
+      c = rotateLeft(b, 30);
+      b = a;
+      a = temp;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+  }
+
+  for (int i = 0; i < 20; i++) {
+    digest[i] = (uint8_t)(h[i / 4] >> (24 - 8 * (i % 4)));
+  }
+}
+
+// Base64 of a byte string; output must hold 4 * ceil(length / 3) + 1 bytes
+static void base64Encode(const uint8_t* data, size_t length, char* output) {
+  static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  size_t out = 0;
+  for (size_t i = 0; i < length; i += 3) {
+    uint32_t group = (uint32_t)data[i] << 16;
+    if (i + 1 < length) group |= (uint32_t)data[i + 1] << 8;
+    if (i + 2 < length) group |= data[i + 2];
+    output[out++] = ALPHABET[(group >> 18) & 0x3F];
+    output[out++] = ALPHABET[(group >> 12) & 0x3F];
+    output[out++] = (i + 1 < length) ? ALPHABET[(group >> 6) & 0x3F] : '=';
+    output[out++] = (i + 2 < length) ? ALPHABET[group & 0x3F] : '=';
+  }
+  output[out] = '\0';
+}
+
+// Sec-WebSocket-Accept for a client's Sec-WebSocket-Key
+static void webSocketAccept(const char* key, size_t keyLength, char accept[29]) {
+  static const char GUID[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+  uint8_t keyAndGuid[128];
+  size_t guidLength = sizeof(GUID) - 1;
+  if (keyLength > sizeof(keyAndGuid) - guidLength) {
+    keyLength = sizeof(keyAndGuid) - guidLength;
+  }
+  memcpy(keyAndGuid, key, keyLength);
+  memcpy(keyAndGuid + keyLength, GUID, guidLength);
+  uint8_t digest[20];
+  sha1(keyAndGuid, keyLength + guidLength, digest);
+  base64Encode(digest, sizeof(digest), accept);
+}
+
+//* ************************************************************************
+//* ************************ CLIENTS ***************************
+//* ************************************************************************
+
+static void closeClient(HostClient& client) {
+  if (client.connected) {
+    close(client.socket);
+  }
+  client.connected = false;
+  client.upgraded = false;
+  client.inputLength = 0;
+}
+
+// Blocking write of the whole buffer; a failed client is closed
+static bool writeClient(HostClient& client, const void* data, size_t length) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  while (length > 0 && client.connected) {
+    ssize_t written = send(client.socket, bytes, length, MSG_NOSIGNAL);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      closeClient(client);
+      return false;
+    }
+    bytes += written;
+    length -= (size_t)written;
+  }
+  return client.connected;
+}
+
+// One unmasked frame (servers never mask)
+static void sendFrame(HostClient& client, uint8_t opcode, const void* payload, size_t length) {
+  if (!client.connected || length > 0xFFFF) {
+    return;
+  }
+  uint8_t header[4];
+  size_t headerLength = 2;
+  header[0] = 0x80 | opcode;  // FIN, never fragmented
+  if (length < 126) {
+    header[1] = (uint8_t)length;
+  } else {
+    header[1] = 126;
+    header[2] = (uint8_t)(length >> 8);
+    header[3] = (uint8_t)length;
+    headerLength = 4;
+  }
+  if (writeClient(client, header, headerLength)) {
+    writeClient(client, payload, length);
+  }
+}
+
+static void sendHostText(uint8_t client, const char* text, size_t length) {
+  if (client < HOST_DASHBOARD_CLIENT_MAX) {
+    sendFrame(clients[client], OPCODE_TEXT, text, length);
+  }
+}
+
+static void submitHostCommand(char* line) {
+  if (commandHandler != nullptr) {
+    commandHandler(line);
+  }
+}
+
+static bool readHostStatus(DashboardStatus& status) {
+  status = currentStatus;
+  return haveStatus;
+}
+
+static const DashboardTransport hostTransport = {sendHostText, submitHostCommand, readHostStatus};
+
+// Drop the first count bytes of a client's input
+static void consumeInput(HostClient& client, size_t count) {
+  memmove(client.input, client.input + count, client.inputLength - count);
+  client.inputLength -= count;
+}
+
+// Answer the upgrade request once it is complete; greet the client as
+// DashboardServer.cpp does on WStype_CONNECTED
+static void handleHandshake(HostClient& client, uint8_t index) {
+  client.input[client.inputLength] = '\0';  // Buffer keeps a byte spare
+  char* request = (char*)client.input;
+  char* end = strstr(request, "\r\n\r\n");
+  if (end == nullptr) {
+    if (client.inputLength >= CLIENT_BUFFER_SIZE - 1) {
+      closeClient(client);  // Request too long
+    }
+    return;
+  }
+
+  const char* key = strcasestr(request, "\r\nSec-WebSocket-Key:");
+  if (key == nullptr || key > end) {
+    static const char BAD_REQUEST[] = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n";
+    writeClient(client, BAD_REQUEST, sizeof(BAD_REQUEST) - 1);
+    closeClient(client);
+    return;
+  }
+  key += strlen("\r\nSec-WebSocket-Key:");
+  while (*key == ' ') key++;
+  size_t keyLength = strcspn(key, " \r\n");
+
+  char accept[29];
+  webSocketAccept(key, keyLength, accept);
+  char response[160];
+  int length = snprintf(response, sizeof(response),
+                        "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n"
+                        "Connection: Upgrade\r\nSec-WebSocket-Accept: %s\r\n\r\n",
+                        accept);
+  consumeInput(client, (size_t)(end + 4 - request));
+  if (!writeClient(client, response, (size_t)length)) {
+    return;
+  }
+  client.upgraded = true;
+  sendDashboardStatus(hostTransport, index);
+  sendDashboardConfig(hostTransport, index);
+}
+
+// Act on every complete frame in a client's input
+static void handleFrames(HostClient& client, uint8_t index) {
+  while (client.connected && client.inputLength >= 2) {
+    const uint8_t* frame = client.input;
+    uint8_t opcode = frame[0] & 0x0F;
+    bool masked = (frame[1] & 0x80) != 0;
+    size_t length = frame[1] & 0x7F;
+    size_t headerLength = 2;
+    if (length == 126) {
+      if (client.inputLength < 4) {
+        return;
+      }
+      length = ((size_t)frame[2] << 8) | frame[3];
+      headerLength = 4;
+    }
+    // Clients must mask, and nothing the dashboard sends needs a 64-bit length
+    if (!masked || length == 127 || headerLength + 4 + length > CLIENT_BUFFER_SIZE - 1) {
+      closeClient(client);
+      return;
+    }
+    size_t frameLength = headerLength + 4 + length;
+    if (client.inputLength < frameLength) {
+      return;
+    }
+
+    const uint8_t* mask = frame + headerLength;
+    char text[CLIENT_BUFFER_SIZE];
+    for (size_t i = 0; i < length; i++) {
+      text[i] = (char)(frame[headerLength + 4 + i] ^ mask[i % 4]);
+    }
+    text[length] = '\0';
+    consumeInput(client, frameLength);
+
+    if (opcode == OPCODE_TEXT) {
+      if (length >= DASHBOARD_MESSAGE_SIZE) {
+        sendDashboardLog(hostTransport, index, "Message too long");
+      } else {
+        handleDashboardMessage(hostTransport, index, text);
+      }
+    } else if (opcode == OPCODE_PING) {
+      sendFrame(client, OPCODE_PONG, text, length);
+    } else if (opcode == OPCODE_CLOSE) {
+      sendFrame(client, OPCODE_CLOSE, nullptr, 0);
+      closeClient(client);
+    }
+  }
+}
+
+// Read whatever a client has sent without waiting for more
+static void serveClient(HostClient& client, uint8_t index) {
+  ssize_t received = recv(client.socket, client.input + client.inputLength,
+                          CLIENT_BUFFER_SIZE - 1 - client.inputLength, MSG_DONTWAIT);
+  if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+    closeClient(client);
+    return;
+  }
+  if (received > 0) {
+    client.inputLength += (size_t)received;
+  }
+  if (!client.upgraded) {
+    handleHandshake(client, index);
+  }
+  if (client.upgraded) {
+    handleFrames(client, index);
+  }
+}
+
+static void acceptClients() {
+  int socket;
+  while ((socket = accept(listenSocket, nullptr, nullptr)) >= 0) {
+    HostClient* slot = nullptr;
+    for (HostClient& client : clients) {
+      if (!client.connected) {
+        slot = &client;
+        break;
+      }
+    }
+    if (slot == nullptr) {
+      close(socket);  // Full, as WebSocketsServer refuses past its client limit
+      continue;
+    }
+    fcntl(socket, F_SETFL, fcntl(socket, F_GETFL) & ~O_NONBLOCK);  // Writes block, reads use MSG_DONTWAIT
+    slot->socket = socket;
+    slot->connected = true;
+    slot->upgraded = false;
+    slot->inputLength = 0;
+  }
+}
+
+//* ************************************************************************
+//* ************************ SERVER ***************************
+//* ************************************************************************
+
+bool beginHostDashboardServer(uint16_t port, void (*submitCommand)(char* line)) {
+  endHostDashboardServer();
+  commandHandler = submitCommand;
+
+  listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+  if (listenSocket < 0) {
+    return false;
+  }
+  int reuse = 1;
+  setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  struct sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(port);
+  socklen_t addressLength = sizeof(address);
+  if (bind(listenSocket, (struct sockaddr*)&address, sizeof(address)) < 0 ||
+      listen(listenSocket, HOST_DASHBOARD_CLIENT_MAX) < 0 ||
+      getsockname(listenSocket, (struct sockaddr*)&address, &addressLength) < 0) {
+    endHostDashboardServer();
+    return false;
+  }
+  fcntl(listenSocket, F_SETFL, fcntl(listenSocket, F_GETFL) | O_NONBLOCK);
+  boundPort = ntohs(address.sin_port);
+  return true;
+}
+
+void endHostDashboardServer() {
+  for (HostClient& client : clients) {
+    closeClient(client);
+  }
+  if (listenSocket >= 0) {
+    close(listenSocket);
+  }
+  listenSocket = -1;
+  boundPort = 0;
+  haveStatus = false;
+  pushState = DashboardPushState();
+  lastPushMs = 0;
+}
+
+uint16_t getHostDashboardPort() {
+  return boundPort;
+}
+
+void setHostDashboardStatus(const DashboardStatus& status) {
+  currentStatus = status;
+  haveStatus = true;
+}
+
+// Serve clients, then broadcast one delta message if the status changed
+void updateHostDashboardServer() {
+  if (listenSocket < 0) {
+    return;
+  }
+  acceptClients();
+  bool anyClient = false;
+  for (uint8_t i = 0; i < HOST_DASHBOARD_CLIENT_MAX; i++) {
+    if (clients[i].connected) {
+      serveClient(clients[i], i);
+    }
+    anyClient = anyClient || clients[i].upgraded;
+  }
+
+  uint32_t now = hostMillis();
+  if (now - lastPushMs < DASHBOARD_STATUS_INTERVAL_MS) {
+    return;
+  }
+  lastPushMs = now;
+  if (!anyClient || !haveStatus) {
+    return;
+  }
+
+  char message[DASHBOARD_MESSAGE_SIZE];
+  size_t length = formatDashboardPush(pushState, currentStatus, message, sizeof(message));
+  for (HostClient& client : clients) {
+    if (length > 0 && client.upgraded) {
+      sendFrame(client, OPCODE_TEXT, message, length);
+    }
+  }
+}
@@ -1,5 +1,4 @@
 #include <Arduino.h>
-#include <AccelStepper.h>
 #include <Bounce2.h>
 #include <ESP32Servo.h>
 
@@ -13,6 +12,14 @@
 #include "../include/TransferArm.h"
 #include "../include/Utils.h"
 #include "../include/OTA_Manager.h"
+#include "../include/MotionHandle.h"
+#include "../include/BlendedMove.h"
+#include "../include/PositionTrigger.h"
+#include "../include/TaskManager.h"
+#include "../include/LatencyStats.h"
+#include "../include/EventTrace.h"
+#include "../include/TriggerCapture.h"
+#include "../include/PulseOutput.h"
 
 // Global variable definitions
 const char* BOARD_ID = "TRANSFER_ARM_001";
@@ -34,8 +41,10 @@ TransferArm transferArm;
 
 // Constructor - Initialize hardware with proper pin configurations
 TransferArm::TransferArm()
-    : xStepper(AccelStepper::DRIVER, X_STEP_PIN, X_DIR_PIN),
-      zStepper(AccelStepper::DRIVER, Z_STEP_PIN, Z_DIR_PIN) {
+    : xStepper(X_STEP_PIN, X_DIR_PIN, X_STEP_TIMER),
+      zStepper(Z_STEP_PIN, Z_DIR_PIN, Z_STEP_TIMER),
+      currentServoPosition(SERVO_HOME_POS),
+      servoCommandTime(0) {
   // Hardware instances are initialized in the member initializer list
 }
 
@@ -48,49 +57,58 @@ void TransferArm::begin() {
   // Initialize serial communication
   Serial.begin(115200);
   
-  smartLog("Transfer Arm Initialization Starting...");
+  LOG_INFO("Transfer Arm Initialization Starting...");
 
 
 
   // Configure all hardware components
   configurePins();
   configureDebouncers();
+  beginTriggerCapture();
   configureSteppers();
   configureServo();
 
-  // Initialize pick cycle state machine
+  // Initialize pick cycle state machine (homes the system automatically on
+  // startup - no user input required)
   initializePickCycle();
 
-  // Home the system (automatic on startup - no user input required)
-  homeSystem();
-
-  smartLog("Transfer Arm Initialized Successfully");
+  LOG_INFO("Transfer Arm Initialized Successfully");
 }
 
-// Main update method - replaces the old loop() function
+// Main update method - runs every period on the motion task
 void TransferArm::update() {
-  // Update debouncers
-  xHomeSwitch.update();
-  zHomeSwitch.update();
-  startButton.update();
-  stage1Signal.update();
-  stopSignalStage2.update();
-
-  // Handle serial communication
-  if (Serial.available()) {
-    String command = Serial.readStringUntil('\n');
-    command.trim();
-    if (command.length() > 0) {
-      handleSerialCommand(command);
-    }
-  }
-
-  // Update steppers
-  xStepper.run();
-  zStepper.run();
+  // Each subsystem is timed into its latency histogram
+  unsigned long start = micros();
+
+  // Update debouncers (update() is true on a debounced edge)
+  if (xHomeSwitch.update()) traceEvent(TRACE_INPUT, TRACE_INPUT_X_HOME, xHomeSwitch.read());
+  if (zHomeSwitch.update()) traceEvent(TRACE_INPUT, TRACE_INPUT_Z_HOME, zHomeSwitch.read());
+  if (startButton.update()) traceEvent(TRACE_INPUT, TRACE_INPUT_START_BUTTON, startButton.read());
+  if (stage1Signal.update()) traceEvent(TRACE_INPUT, TRACE_INPUT_STAGE1, stage1Signal.read());
+  if (stopSignalStage2.update()) traceEvent(TRACE_INPUT, TRACE_INPUT_STAGE2_STOP, stopSignalStage2.read());
+  xHomeLatch.update();     // Confirm interrupt-latched home switch edges
+  zHomeLatch.update();
+  updateTriggerCapture();  // Confirm interrupt-captured start and Stage 1 edges
+  unsigned long debounced = micros();
+  getLatencyHistogram(LATENCY_DEBOUNCE).record(debounced - start);
+
+  // Run serial commands received by the comms task
+  processQueuedCommands();
+  unsigned long commandsDone = micros();
+  getLatencyHistogram(LATENCY_SERIAL).record(commandsDone - debounced);
+
+  // Steppers are driven by their step timer interrupts - only completion
+  // callbacks for finished moves and deferred trigger actions run here
+  updateMotion();
+  updatePositionTriggers();
+  updateBlendedMove();
+  unsigned long steppingDone = micros();
+  getLatencyHistogram(LATENCY_STEPPING).record(steppingDone - commandsDone);
 
   // Update the pick cycle state machine
   updatePickCycle();
+  updateTriggerLatency(isAnyMotorMoving());
+  getLatencyHistogram(LATENCY_PICK_CYCLE).record(micros() - steppingDone);
 }
 
 //* ************************************************************************
@@ -99,7 +117,7 @@ void TransferArm::update() {
 
 // Configure input and output pins
 void TransferArm::configurePins() {
-  smartLog("Configuring pins...");
+  LOG_INFO("Configuring pins...");
   
   // Configure input pins (switches are active HIGH)
   pinMode((int)X_HOME_SWITCH_PIN, INPUT_PULLDOWN);
@@ -115,15 +133,14 @@ void TransferArm::configurePins() {
   pinMode((int)SOLENOID_RELAY_PIN, OUTPUT);
   digitalWrite((int)SOLENOID_RELAY_PIN, LOW);  // Ensure solenoid is retracted
   
-  pinMode((int)STAGE2_SIGNAL_PIN, OUTPUT);
-  digitalWrite((int)STAGE2_SIGNAL_PIN, LOW);  // Initialize stage 2 signal as LOW
+  beginPulseOutputs();  // Stage 2 signal at its idle level
   
-  smartLog("Pins configured successfully");
+  LOG_INFO("Pins configured successfully");
 }
 
 // Configure debouncer objects
 void TransferArm::configureDebouncers() {
-  smartLog("Configuring debouncers...");
+  LOG_INFO("Configuring debouncers...");
   
   xHomeSwitch.attach((int)X_HOME_SWITCH_PIN);
   xHomeSwitch.interval(2);  // 2ms debounce
@@ -140,35 +157,55 @@ void TransferArm::configureDebouncers() {
   stopSignalStage2.attach((int)STOP_SIGNAL_STAGE_2);
   stopSignalStage2.interval(10);  // 10ms debounce
   
-  smartLog("Debouncers configured successfully");
+  LOG_INFO("Debouncers configured successfully");
 }
 
 // Configure stepper motor settings
 void TransferArm::configureSteppers() {
-  smartLog("Configuring steppers...");
+  LOG_INFO("Configuring steppers...");
   
   // X-axis stepper configuration
+  xStepper.begin();
   xStepper.setMaxSpeed(X_MAX_SPEED);
   xStepper.setAcceleration(X_ACCELERATION);
+  xStepper.setProfile(X_MOTION_PROFILE, X_JERK);
   xStepper.setMinPulseWidth(3);
 
   // Z-axis stepper configuration
+  zStepper.begin();
   zStepper.setMaxSpeed(Z_MAX_SPEED);
   zStepper.setAcceleration(Z_ACCELERATION);
+  zStepper.setProfile(Z_MOTION_PROFILE, Z_JERK);
   zStepper.setMinPulseWidth(3);
+
+  // Step timing error telemetry
+  xStepper.setStepErrorHistogram(&getLatencyHistogram(LATENCY_X_STEP_ERROR));
+  zStepper.setStepErrorHistogram(&getLatencyHistogram(LATENCY_Z_STEP_ERROR));
+
+  // Motion start and end in the event trace
+  xStepper.setTraceAxis(TRACE_AXIS_X);
+  zStepper.setTraceAxis(TRACE_AXIS_Z);
+
+  // Latch the step count on home switch edges
+  xHomeLatch.begin((uint8_t)X_HOME_SWITCH_PIN, xHomeSwitch, xStepper);
+  zHomeLatch.begin((uint8_t)Z_HOME_SWITCH_PIN, zHomeSwitch, zStepper);
+
+  // Precompute the fixed production moves
+  cacheProductionMoves();
   
-  smartLog("Steppers configured successfully");
+  LOG_INFO("Steppers configured successfully");
 }
 
 // Configure servo motor
 void TransferArm::configureServo() {
-  smartLog("Configuring servo...");
+  LOG_INFO("Configuring servo...");
   
   gripperServo.attach((int)SERVO_PIN);
   gripperServo.write((int)SERVO_HOME_POS);
   currentServoPosition = SERVO_HOME_POS;
+  servoCommandTime = millis();
   
-  smartLog("Servo configured successfully - Position: " + String(SERVO_HOME_POS));
+  LOG_INFO("Servo configured successfully - Position: %.2f", SERVO_HOME_POS);
 }
 
 //* ************************************************************************
@@ -179,7 +216,9 @@ void TransferArm::configureServo() {
 void TransferArm::setServoPosition(float position) {
   gripperServo.write((int)position);
   currentServoPosition = position;
-  smartLog("Servo set to position: " + String(position));
+  servoCommandTime = millis();
+  traceEvent(TRACE_SERVO, 0, (int32_t)(position * 100.0f));
+  LOG_DEBUG("Servo set to position: %.2f", position);
 }
 
 //* ************************************************************************
@@ -189,13 +228,13 @@ void TransferArm::setServoPosition(float position) {
 // Enable X motor (active low enable pin)
 void TransferArm::enableXMotor() {
   digitalWrite((int)X_ENABLE_PIN, LOW);
-  smartLog("X motor enabled");
+  LOG_DEBUG("X motor enabled");
 }
 
 // Disable X motor (active low enable pin)
 void TransferArm::disableXMotor() {
   digitalWrite((int)X_ENABLE_PIN, HIGH);
-  smartLog("X motor disabled");
+  LOG_DEBUG("X motor disabled");
 }
 
 //* ************************************************************************
@@ -205,49 +244,19 @@ void TransferArm::disableXMotor() {
 // Check if Stage 2 machine signals it's safe for Z-axis lowering
 bool TransferArm::isStage2SafeForZLowering() {
   // Pin is active high normally, goes low when Stage 2 is safe
-  bool isSafe = (stopSignalStage2.read() == LOW);
-  if (!isSafe) {
-    smartLog("Waiting for Stage 2 safety signal before Z lowering");
-  }
-  return isSafe;
+  // Callers that poll this log the wait through a LogThrottle
+  return (stopSignalStage2.read() == LOW);
 }
 
 //* ************************************************************************
 //* ************************ COMMUNICATION METHODS ***************************
 //* ************************************************************************
 
-// Handle incoming serial commands
-void TransferArm::handleSerialCommand(const String& command) {
-  if (command == "status") {
-    Serial.println("Transfer Arm Status:");
-    Serial.println("X Position: " + String(xStepper.currentPosition()));
-    Serial.println("Z Position: " + String(zStepper.currentPosition()));
-    Serial.println("Servo Position: " + String(currentServoPosition));
-    Serial.println("X Moving: " + String(isXMoving() ? "Yes" : "No"));
-    Serial.println("Z Moving: " + String(isZMoving() ? "Yes" : "No"));
-  } else if (command == "home") {
-    Serial.println("Initiating homing sequence...");
-    homeSystem();
-  } else if (command == "cycle") {
-    Serial.println("Triggering pick cycle...");
-    triggerPickCycleFromWeb();
-  } else if (command == "help") {
-    Serial.println("Available commands:");
-    Serial.println("  status - Show system status");
-    Serial.println("  home - Start homing sequence");
-    Serial.println("  cycle - Trigger pick cycle");
-    Serial.println("  help - Show this help");
-  } else {
-    Serial.println("Unknown command: " + command);
-    Serial.println("Type 'help' for available commands");
-  }
-}
-
 // Send burst request (placeholder for photo capture communication)
 void TransferArm::sendBurstRequest() {
   // This is a placeholder for communication with external systems (like Raspberry Pi)
   // Could be implemented as HTTP request, MQTT message, or simple digital signal
-  smartLog("Burst request sent for photo capture");
+  LOG_DEBUG("Burst request sent for photo capture");
   
   // Example implementation - could be a digital pin signal
   // digitalWrite(BURST_REQUEST_PIN, HIGH);
@@ -259,8 +268,8 @@ void TransferArm::sendBurstRequest() {
 //* *************************** MAIN PROGRAM *****************************
 //* ************************************************************************
 // This is the main entry point for the Transfer Arm system.
-// It initializes the TransferArm class which handles all hardware,
-// state machines, and web server functionality.
+// setup() initializes the hardware, then hands over to the motion and
+// comms tasks (see TaskManager.h). The Arduino loop task is not used.
 
 // Arduino setup function - runs once at startup
 void setup() {
@@ -268,13 +277,13 @@ void setup() {
   initOTA();
   // Initialize the Transfer Arm system
   displayIP();
+  // Step timer and switch interrupts attach to this core (the motion core)
   transferArm.begin();
+  //! Start the motion and comms tasks
+  startTasks();
 }
 
-// Arduino loop function - runs repeatedly
+// Arduino loop function - work runs in the motion and comms tasks
 void loop() {
-  // Update the Transfer Arm system
-  transferArm.update();
-    //! Handle OTA updates
-  handleOTA();
+  vTaskDelete(NULL);
 }
@@ -0,0 +1,269 @@
+#include <unity.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include "HostDashboardServer.h"
+#include "DashboardProtocol.h"
+#include "Config/Config.h"
+
+//* ************************************************************************
+//* ************************ HOST DASHBOARD SERVER TESTS ***************************
+//* ************************************************************************
+// Host tests for the dashboard server over a real socket (pio test -e
+// native). The server listens on a free loopback port and a minimal
+// WebSocket client talks to it the way data/index.html and
+// tools/dashboard_client.py do. Everything runs on one thread: while the
+// client waits for a frame it keeps polling updateHostDashboardServer().
+
+static const int FRAME_TIMEOUT_MS = 2000;
+static const int MAX_LINES = 4;
+
+static int clientSocket = -1;
+static uint8_t received[4096];
+static size_t receivedLength;
+static char lines[MAX_LINES][DASHBOARD_COMMAND_LENGTH];
+static int lineCount;
+
+static void recordCommand(char* line) {
+  TEST_ASSERT_TRUE(lineCount < MAX_LINES);
+  strcpy(lines[lineCount++], line);
+}
+
+static DashboardStatus makeStatus() {
+  DashboardStatus status;
+  status.state = "IDLE";
+  status.xPos = 1200;
+  status.zPos = -35;
+  status.servoPos = 90.0f;
+  status.vacuum = false;
+  status.xHome = true;
+  status.zHome = false;
+  status.freeHeapKb = 182;
+  status.resourceWarnings = 0;
+  return status;
+}
+
+static long elapsedMs(const struct timespec& start) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000;
+}
+
+// Serve the server and read what the client has been sent
+static void pump() {
+  updateHostDashboardServer();
+  ssize_t count = recv(clientSocket, received + receivedLength, sizeof(received) - receivedLength, MSG_DONTWAIT);
+  if (count > 0) {
+    receivedLength += (size_t)count;
+  }
+  usleep(1000);
+}
+
+static void consumeReceived(size_t count) {
+  memmove(received, received + count, receivedLength - count);
+  receivedLength -= count;
+}
+
+// Next text frame from the server into text; false if none within timeoutMs
+static bool readFrame(char* text, size_t size, int timeoutMs) {
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  while (elapsedMs(start) < timeoutMs) {
+    pump();
+    if (receivedLength < 2) {
+      continue;
+    }
+    TEST_ASSERT_EQUAL_MESSAGE(0x81, received[0], "expected one unfragmented text frame");
+    TEST_ASSERT_EQUAL_MESSAGE(0, received[1] & 0x80, "server frames must not be masked");
+    size_t length = received[1] & 0x7F;
+    size_t header = 2;
+    if (length == 126) {
+      if (receivedLength < 4) {
+        continue;
+      }
+      length = ((size_t)received[2] << 8) | received[3];
+      header = 4;
+    }
+    if (receivedLength < header + length) {
+      continue;
+    }
+    TEST_ASSERT_TRUE(length < size);
+    memcpy(text, received + header, length);
+    text[length] = '\0';
+    consumeReceived(header + length);
+    return true;
+  }
+  return false;
+}
+
+// One masked text frame, as every client must send
+static void sendText(const char* text) {
+  size_t length = strlen(text);
+  TEST_ASSERT_TRUE(length < 126);
+  uint8_t frame[6 + 126];
+  const uint8_t mask[4] = {0x37, 0xFA, 0x21, 0x3D};
+  frame[0] = 0x81;
+  frame[1] = 0x80 | (uint8_t)length;
+  memcpy(frame + 2, mask, 4);
+  for (size_t i = 0; i < length; i++) {
+    frame[6 + i] = (uint8_t)text[i] ^ mask[i % 4];
+  }
+  TEST_ASSERT_EQUAL(6 + length, send(clientSocket, frame, 6 + length, 0));
+}
+
+// Connect and complete the handshake; returns the server's response headers
+static void connectClient(char* response, size_t size) {
+  clientSocket = socket(AF_INET, SOCK_STREAM, 0);
+  TEST_ASSERT_TRUE(clientSocket >= 0);
+  struct sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(getHostDashboardPort());
+  TEST_ASSERT_EQUAL(0, connect(clientSocket, (struct sockaddr*)&address, sizeof(address)));
+
+  // Key and accept value from the example in RFC 6455 section 1.3
+  const char request[] =
+      "GET / HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+      "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+  TEST_ASSERT_EQUAL(sizeof(request) - 1, send(clientSocket, request, sizeof(request) - 1, 0));
+
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  while (elapsedMs(start) < FRAME_TIMEOUT_MS) {
+    pump();
+    received[receivedLength < sizeof(received) ? receivedLength : sizeof(received) - 1] = '\0';
+    char* end = strstr((char*)received, "\r\n\r\n");
+    if (end != nullptr) {
+      size_t length = (size_t)(end + 4 - (char*)received);
+      TEST_ASSERT_TRUE(length < size);
+      memcpy(response, received, length);
+      response[length] = '\0';
+      consumeReceived(length);
+      return;
+    }
+  }
+  TEST_FAIL_MESSAGE("no handshake response");
+}
+
+// Connect and read the greeting (full status, then config)
+static void connectAndGreet() {
+  char text[DASHBOARD_MESSAGE_SIZE];
+  connectClient(text, sizeof(text));
+  TEST_ASSERT_TRUE(readFrame(text, sizeof(text), FRAME_TIMEOUT_MS));
+  TEST_ASSERT_TRUE(readFrame(text, sizeof(text), FRAME_TIMEOUT_MS));
+}
+
+void setUp(void) {
+  receivedLength = 0;
+  lineCount = 0;
+  TEST_ASSERT_TRUE(beginHostDashboardServer(0, recordCommand));
+  setHostDashboardStatus(makeStatus());
+}
+
+void tearDown(void) {
+  if (clientSocket >= 0) {
+    close(clientSocket);
+    clientSocket = -1;
+  }
+  endHostDashboardServer();
+}
+
+//* ************************************************************************
+//* ************************ TESTS ***************************
+//* ************************************************************************
+
+// The handshake is answered per RFC 6455, then the full status and the
+// config arrive unasked
+void test_connect_sends_full_status_and_config(void) {
+  char response[DASHBOARD_MESSAGE_SIZE];
+  connectClient(response, sizeof(response));
+  TEST_ASSERT_EQUAL(0, strncmp(response, "HTTP/1.1 101 ", 13));
+  TEST_ASSERT_NOT_NULL(strstr(response, "\r\nSec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n"));
+
+  char expected[DASHBOARD_MESSAGE_SIZE];
+  formatDashboardStatus(expected, sizeof(expected), makeStatus(), FIELD_ALL);
+  char text[DASHBOARD_MESSAGE_SIZE];
+  TEST_ASSERT_TRUE(readFrame(text, sizeof(text), FRAME_TIMEOUT_MS));
+  TEST_ASSERT_EQUAL_STRING(expected, text);
+  TEST_ASSERT_TRUE(readFrame(text, sizeof(text), FRAME_TIMEOUT_MS));
+  TEST_ASSERT_EQUAL(0, strncmp(text, "{\"type\":\"config\",\"config\":{", 27));
+}
+
+// After the first push, a change is pushed as a delta and nothing is sent
+// while the status holds still
+void test_changes_are_pushed_as_deltas(void) {
+  connectAndGreet();
+  char text[DASHBOARD_MESSAGE_SIZE];
+  TEST_ASSERT_TRUE(readFrame(text, sizeof(text), FRAME_TIMEOUT_MS));  // First push holds every field
+  TEST_ASSERT_NOT_NULL(strstr(text, "\"state\":\"IDLE\""));
+
+  DashboardStatus status = makeStatus();
+  status.xPos = 1300;
+  status.vacuum = true;
+  setHostDashboardStatus(status);
+  TEST_ASSERT_TRUE(readFrame(text, sizeof(text), FRAME_TIMEOUT_MS));
+  TEST_ASSERT_EQUAL_STRING("{\"type\":\"status\",\"xPos\":1300,\"vacuum\":true}", text);
+
+  TEST_ASSERT_FALSE(readFrame(text, sizeof(text), 3 * DASHBOARD_STATUS_INTERVAL_MS));
+}
+
+// getStatus is answered with the full status even when nothing changed
+void test_get_status_round_trip(void) {
+  connectAndGreet();
+  char text[DASHBOARD_MESSAGE_SIZE];
+  TEST_ASSERT_TRUE(readFrame(text, sizeof(text), FRAME_TIMEOUT_MS));  // First push
+  TEST_ASSERT_FALSE(readFrame(text, sizeof(text), 2 * DASHBOARD_STATUS_INTERVAL_MS));
+
+  sendText("{\"command\":\"getStatus\"}");
+  char expected[DASHBOARD_MESSAGE_SIZE];
+  formatDashboardStatus(expected, sizeof(expected), makeStatus(), FIELD_ALL);
+  TEST_ASSERT_TRUE(readFrame(text, sizeof(text), FRAME_TIMEOUT_MS));
+  TEST_ASSERT_EQUAL_STRING(expected, text);
+}
+
+// Commands reach the console handler and are acknowledged
+void test_commands_reach_console(void) {
+  connectAndGreet();
+  sendText("{\"command\":\"emergencyStop\"}");
+  char text[DASHBOARD_MESSAGE_SIZE];
+  do {
+    TEST_ASSERT_TRUE(readFrame(text, sizeof(text), FRAME_TIMEOUT_MS));
+  } while (strncmp(text, "{\"type\":\"log\"", 13) != 0);  // Skip the first push
+  TEST_ASSERT_EQUAL_STRING("{\"type\":\"log\",\"message\":\"Sent 'stop'\"}", text);
+  TEST_ASSERT_EQUAL(1, lineCount);
+  TEST_ASSERT_EQUAL_STRING("stop", lines[0]);
+}
+
+// A request without a WebSocket key is refused
+void test_plain_http_is_refused(void) {
+  clientSocket = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(getHostDashboardPort());
+  TEST_ASSERT_EQUAL(0, connect(clientSocket, (struct sockaddr*)&address, sizeof(address)));
+  const char request[] = "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+  send(clientSocket, request, sizeof(request) - 1, 0);
+
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  while (receivedLength < 12 && elapsedMs(start) < FRAME_TIMEOUT_MS) {
+    pump();
+  }
+  TEST_ASSERT_EQUAL(0, strncmp((char*)received, "HTTP/1.1 400", 12));
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_connect_sends_full_status_and_config);
+  RUN_TEST(test_changes_are_pushed_as_deltas);
+  RUN_TEST(test_get_status_round_trip);
+  RUN_TEST(test_commands_reach_console);
+  RUN_TEST(test_plain_http_is_refused);
+  return UNITY_END();
+}
@@ -0,0 +1,241 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "DashboardProtocol.h"
+#include "ConfigSettings.h"
+
+//* ************************************************************************
+//* ************************ DASHBOARD PROTOCOL TESTS ***************************
+//* ************************************************************************
+// Host tests for the dashboard's JSON protocol (pio test -e native). A
+// recording transport stands in for the WebSocket server and the console:
+// it keeps the last frame sent and every command line submitted, and
+// serves a status the test sets up.
+
+static const int MAX_LINES = 8;
+
+static char lastFrame[DASHBOARD_MESSAGE_SIZE];
+static uint8_t lastClient;
+static int frames;
+static char lines[MAX_LINES][DASHBOARD_COMMAND_LENGTH];
+static int lineCount;
+static DashboardStatus currentStatus;
+static bool haveStatus;
+
+static void recordText(uint8_t client, const char* text, size_t length) {
+  TEST_ASSERT_TRUE_MESSAGE(length < sizeof(lastFrame), "frame longer than DASHBOARD_MESSAGE_SIZE");
+  TEST_ASSERT_EQUAL(strlen(text), length);
+  memcpy(lastFrame, text, length + 1);
+  lastClient = client;
+  frames++;
+}
+
+static void recordCommand(char* line) {
+  TEST_ASSERT_TRUE(lineCount < MAX_LINES);
+  strcpy(lines[lineCount++], line);
+}
+
+static bool serveStatus(DashboardStatus& status) {
+  status = currentStatus;
+  return haveStatus;
+}
+
+static const DashboardTransport recorder = {recordText, recordCommand, serveStatus};
+
+static DashboardStatus makeStatus() {
+  DashboardStatus status;
+  status.state = "IDLE";
+  status.xPos = 1200;
+  status.zPos = -35;
+  status.servoPos = 90.0f;
+  status.vacuum = false;
+  status.xHome = true;
+  status.zHome = false;
+  status.freeHeapKb = 182;
+  status.resourceWarnings = 0;
+  return status;
+}
+
+void setUp(void) {
+  lastFrame[0] = '\0';
+  lastClient = 0xFF;
+  frames = 0;
+  lineCount = 0;
+  currentStatus = makeStatus();
+  haveStatus = true;
+}
+
+void tearDown(void) {}
+
+//* ************************************************************************
+//* ************************ STATUS ***************************
+//* ************************************************************************
+
+void test_full_status_has_every_field(void) {
+  char message[DASHBOARD_MESSAGE_SIZE];
+  formatDashboardStatus(message, sizeof(message), makeStatus(), FIELD_ALL);
+  TEST_ASSERT_EQUAL_STRING(
+      "{\"type\":\"status\",\"state\":\"IDLE\",\"xPos\":1200,\"zPos\":-35,\"servoPos\":90.0,"
+      "\"vacuum\":false,\"xHome\":true,\"zHome\":false,\"freeHeapKb\":182,\"resourceWarnings\":0}",
+      message);
+}
+
+// A delta holds only what changed, and nothing changed means no fields
+void test_delta_holds_changed_fields(void) {
+  DashboardStatus before = makeStatus();
+  DashboardStatus after = before;
+  TEST_ASSERT_EQUAL(0, changedDashboardFields(before, after));
+
+  char stateName[] = "IDLE";  // Same text at a different address is not a change
+  after.state = stateName;
+  TEST_ASSERT_EQUAL(0, changedDashboardFields(before, after));
+
+  after.xPos = 1300;
+  after.vacuum = true;
+  uint16_t fields = changedDashboardFields(before, after);
+  TEST_ASSERT_EQUAL(FIELD_X_POS | FIELD_VACUUM, fields);
+
+  char message[DASHBOARD_MESSAGE_SIZE];
+  formatDashboardStatus(message, sizeof(message), after, fields);
+  TEST_ASSERT_EQUAL_STRING("{\"type\":\"status\",\"xPos\":1300,\"vacuum\":true}", message);
+}
+
+// The first push holds every field, later pushes only what changed
+void test_push_sends_full_then_deltas(void) {
+  DashboardPushState push = {};
+  DashboardStatus status = makeStatus();
+  char message[DASHBOARD_MESSAGE_SIZE];
+  TEST_ASSERT_TRUE(formatDashboardPush(push, status, message, sizeof(message)) > 0);
+  TEST_ASSERT_NOT_NULL(strstr(message, "\"state\":\"IDLE\""));
+  TEST_ASSERT_EQUAL(0, formatDashboardPush(push, status, message, sizeof(message)));
+
+  status.zPos = 400;
+  TEST_ASSERT_TRUE(formatDashboardPush(push, status, message, sizeof(message)) > 0);
+  TEST_ASSERT_EQUAL_STRING("{\"type\":\"status\",\"zPos\":400}", message);
+  TEST_ASSERT_EQUAL(0, formatDashboardPush(push, status, message, sizeof(message)));
+}
+
+// Resource warnings and free heap are pushed like any other field
+void test_delta_holds_resource_fields(void) {
+  DashboardStatus before = makeStatus();
+  DashboardStatus after = before;
+  after.freeHeapKb = 40;
+  after.resourceWarnings = 0x05;  // Low heap and fragmented
+  uint16_t fields = changedDashboardFields(before, after);
+  TEST_ASSERT_EQUAL(FIELD_FREE_HEAP | FIELD_RESOURCE_WARNINGS, fields);
+
+  char message[DASHBOARD_MESSAGE_SIZE];
+  formatDashboardStatus(message, sizeof(message), after, fields);
+  TEST_ASSERT_EQUAL_STRING("{\"type\":\"status\",\"freeHeapKb\":40,\"resourceWarnings\":5}", message);
+}
+
+// A buffer too short for the message is filled and terminated, never overrun
+void test_status_truncates_to_buffer(void) {
+  char message[32];
+  memset(message, 'x', sizeof(message));
+  size_t length = formatDashboardStatus(message, 24, makeStatus(), FIELD_ALL);
+  TEST_ASSERT_EQUAL(23, length);
+  TEST_ASSERT_EQUAL('\0', message[23]);
+  TEST_ASSERT_EQUAL('x', message[24]);
+}
+
+void test_config_lists_every_setting(void) {
+  char message[DASHBOARD_MESSAGE_SIZE];
+  size_t length = formatDashboardConfig(message, sizeof(message));
+  TEST_ASSERT_TRUE_MESSAGE(length < sizeof(message) - 1, "config message does not fit");
+  TEST_ASSERT_EQUAL(0, strncmp(message, "{\"type\":\"config\",\"config\":{", 27));
+  TEST_ASSERT_EQUAL_STRING("}}", message + length - 2);
+  for (uint8_t i = 0; i < getConfigSettingCount(); i++) {
+    char key[48];
+    snprintf(key, sizeof(key), "\"%s\":", getConfigSetting(i).name);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(message, key), key);
+  }
+}
+
+//* ************************************************************************
+//* ************************ CLIENT MESSAGES ***************************
+//* ************************************************************************
+
+void test_get_status_replies_to_sender(void) {
+  handleDashboardMessage(recorder, 3, "{\"command\":\"getStatus\"}");
+  TEST_ASSERT_EQUAL(1, frames);
+  TEST_ASSERT_EQUAL(3, lastClient);
+  TEST_ASSERT_NOT_NULL(strstr(lastFrame, "\"xPos\":1200"));
+  TEST_ASSERT_EQUAL(0, lineCount);
+}
+
+// Nothing is sent before the first motion snapshot
+void test_get_status_without_status_sends_nothing(void) {
+  haveStatus = false;
+  handleDashboardMessage(recorder, 0, "{\"command\":\"getStatus\"}");
+  TEST_ASSERT_EQUAL(0, frames);
+}
+
+void test_emergency_stop_submits_stop(void) {
+  handleDashboardMessage(recorder, 0, "{\"command\":\"emergencyStop\"}");
+  TEST_ASSERT_EQUAL(1, lineCount);
+  TEST_ASSERT_EQUAL_STRING("stop", lines[0]);
+  TEST_ASSERT_EQUAL_STRING("{\"type\":\"log\",\"message\":\"Sent 'stop'\"}", lastFrame);
+}
+
+// manualControl actions become the console's manual commands
+void test_manual_control_maps_to_console(void) {
+  handleDashboardMessage(recorder, 0, "{\"command\":\"manualControl\",\"action\":\"home\"}");
+  handleDashboardMessage(recorder, 0, "{\"command\":\"manualControl\",\"action\":\"pickCycle\"}");
+  handleDashboardMessage(recorder, 0, "{\"command\": \"manualControl\", \"action\": \"moveX\", \"target\": 12.5}");
+  handleDashboardMessage(recorder, 0, "{\"command\":\"manualControl\",\"action\":\"moveZ\",\"target\":-1}");
+  handleDashboardMessage(recorder, 0, "{\"command\":\"manualControl\",\"action\":\"servo\",\"angle\":45}");
+  handleDashboardMessage(recorder, 0, "{\"command\":\"manualControl\",\"action\":\"vacuum\",\"state\":true}");
+  TEST_ASSERT_EQUAL(6, lineCount);
+  TEST_ASSERT_EQUAL_STRING("home", lines[0]);
+  TEST_ASSERT_EQUAL_STRING("cycle", lines[1]);
+  TEST_ASSERT_EQUAL_STRING("move x 12.500", lines[2]);
+  TEST_ASSERT_EQUAL_STRING("move z -1.000", lines[3]);
+  TEST_ASSERT_EQUAL_STRING("servo 45.0", lines[4]);
+  TEST_ASSERT_EQUAL_STRING("vacuum on", lines[5]);
+}
+
+// An action missing its argument is reported, not run
+void test_manual_control_needs_its_argument(void) {
+  handleDashboardMessage(recorder, 0, "{\"command\":\"manualControl\",\"action\":\"moveX\"}");
+  TEST_ASSERT_EQUAL(0, lineCount);
+  TEST_ASSERT_EQUAL_STRING("{\"type\":\"log\",\"message\":\"Manual control 'moveX' not understood\"}", lastFrame);
+}
+
+// Writable settings become 'config set'; read-only ones are refused
+void test_set_config(void) {
+  handleDashboardMessage(recorder, 0, "{\"command\":\"setConfig\",\"servoPickupPos\":80,\"pickupHoldTime\":250}");
+  TEST_ASSERT_EQUAL(2, lineCount);
+  TEST_ASSERT_EQUAL_STRING("config set servoPickupPos 80.00", lines[0]);
+  TEST_ASSERT_EQUAL_STRING("config set pickupHoldTime 250.00", lines[1]);
+
+  handleDashboardMessage(recorder, 0, "{\"command\":\"setConfig\",\"xMaxSpeed\":9000}");
+  TEST_ASSERT_EQUAL(2, lineCount);
+  TEST_ASSERT_NOT_NULL(strstr(lastFrame, "xMaxSpeed is compiled in"));
+}
+
+void test_bad_messages_are_reported(void) {
+  handleDashboardMessage(recorder, 0, "not json");
+  TEST_ASSERT_EQUAL_STRING("{\"type\":\"log\",\"message\":\"Malformed message\"}", lastFrame);
+  handleDashboardMessage(recorder, 0, "{\"command\":\"selfDestruct\"}");
+  TEST_ASSERT_EQUAL_STRING("{\"type\":\"log\",\"message\":\"Unknown command 'selfDestruct'\"}", lastFrame);
+  TEST_ASSERT_EQUAL(0, lineCount);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_full_status_has_every_field);
+  RUN_TEST(test_delta_holds_changed_fields);
+  RUN_TEST(test_push_sends_full_then_deltas);
+  RUN_TEST(test_delta_holds_resource_fields);
+  RUN_TEST(test_status_truncates_to_buffer);
+  RUN_TEST(test_config_lists_every_setting);
+  RUN_TEST(test_get_status_replies_to_sender);
+  RUN_TEST(test_get_status_without_status_sends_nothing);
+  RUN_TEST(test_emergency_stop_submits_stop);
+  RUN_TEST(test_manual_control_maps_to_console);
+  RUN_TEST(test_manual_control_needs_its_argument);
+  RUN_TEST(test_set_config);
+  RUN_TEST(test_bad_messages_are_reported);
+  return UNITY_END();
+}
@@ -0,0 +1,227 @@
+#include <unity.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "FixedPoint.h"
+#include "StepRamp.h"
+#include "Config/Config.h"
+
+//* ************************************************************************
+//* ************************ FIXED POINT TESTS ***************************
+//* ************************************************************************
+// Host tests for the move from float to integer steps and Q16.16 speeds
+// (pio test -e native). Each result is compared with the float code it
+// replaced: positions were float products truncated by moveTo(long), and
+// the step ramp was configured with float math.
+
+static const double Q16_LSB = 1.0 / 65536.0;
+
+// The float ramp configuration this code replaced
+struct FloatRamp {
+  uint32_t c0;
+  uint32_t cMin;
+  int32_t maxRampSteps;
+};
+
+static FloatRamp floatRampConfigure(float maxSpeed, float acceleration) {
+  FloatRamp ramp;
+  float c0 = 0.676f * sqrtf(2.0f / acceleration) * STEP_TIMER_TICKS_PER_SEC;
+  float cMin = STEP_TIMER_TICKS_PER_SEC / maxSpeed;
+  ramp.c0 = (uint32_t)(c0 * (1 << STEP_RAMP_FRACTION_BITS));
+  ramp.cMin = (uint32_t)(cMin * (1 << STEP_RAMP_FRACTION_BITS));
+  ramp.maxRampSteps = (int32_t)((maxSpeed * maxSpeed) / (2.0f * acceleration));
+  if (ramp.maxRampSteps < 1) ramp.maxRampSteps = 1;
+  return ramp;
+}
+
+// Every speed/acceleration pair the firmware configures
+struct RatePair {
+  q16_t speed;
+  q16_t acceleration;
+};
+
+static const RatePair CONFIG_RATES[] = {
+    {X_MAX_SPEED, X_ACCELERATION},
+    {Z_MAX_SPEED, Z_ACCELERATION},
+    {Z_DROPOFF_MAX_SPEED, Z_DROPOFF_ACCELERATION},
+    {X_HOME_SPEED, HOME_ACCELERATION},
+    {Z_HOME_SPEED, HOME_ACCELERATION},
+    {X_HOME_FAST_SPEED, HOME_ACCELERATION},
+    {Z_HOME_FAST_SPEED, HOME_ACCELERATION},
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+//* ************************************************************************
+//* ************************ POSITIONS ***************************
+//* ************************************************************************
+
+// Config positions are the float product rounded to the nearest step, and
+// never more than one step from what the old truncation produced
+void test_config_positions_match_float(void) {
+  struct Position {
+    long steps;
+    float inches;
+  };
+  const Position positions[] = {
+      {X_PICKUP_POS, X_PICKUP_POS_INCHES},
+      {X_DROPOFF_POS, X_DROPOFF_POS_INCHES},
+      {X_DROPOFF_OVERSHOOT_POS, X_DROPOFF_OVERSHOOT_INCHES},
+      {X_SERVO_ROTATE_POS, X_SERVO_ROTATE_INCHES},
+      {Z_PICKUP_POS, Z_PICKUP_LOWER_INCHES},
+      {Z_SUCTION_START_POS, Z_SUCTION_START_INCHES},
+      {Z_DROPOFF_POS, Z_DROPOFF_LOWER_INCHES},
+      {HOME_BACKOFF_STEPS, HOME_BACKOFF_INCHES},
+      {X_HOME_SEARCH_STEPS, X_HOME_SEARCH_INCHES},
+      {Z_HOME_SEARCH_STEPS, Z_HOME_SEARCH_INCHES},
+  };
+  for (const Position& position : positions) {
+    float product = position.inches * STEPS_PER_INCH;
+    TEST_ASSERT_FLOAT_WITHIN(0.5, product, position.steps);
+    TEST_ASSERT_INT32_WITHIN(1, (long)product, position.steps);
+  }
+}
+
+// inchesToSteps() rounds to the nearest step across the travel, both signs
+void test_inches_to_steps_rounds_to_nearest(void) {
+  for (int hundredths = -3000; hundredths <= 3000; hundredths++) {
+    float inches = hundredths / 100.0f;
+    float product = inches * STEPS_PER_INCH;
+    long steps = inchesToSteps(inches, STEPS_PER_INCH);
+    TEST_ASSERT_FLOAT_WITHIN(0.5 + 1e-3, product, steps);
+  }
+}
+
+//* ************************************************************************
+//* ************************ Q16.16 ***************************
+//* ************************************************************************
+
+// Whole values survive the round trip over the full range
+void test_q16_int_round_trip(void) {
+  for (int32_t value = -Q16_MAX_INT; value <= Q16_MAX_INT; value++) {
+    TEST_ASSERT_EQUAL_INT32(value, q16ToInt(q16FromInt(value)));
+  }
+  TEST_ASSERT_EQUAL_INT32(3, q16ToInt(q16FromFloat(2.5f)));    // Halves round away from zero
+  TEST_ASSERT_EQUAL_INT32(-3, q16ToInt(q16FromFloat(-2.5f)));
+}
+
+// Float conversions agree to half an LSB plus the float's own precision
+void test_q16_float_conversions(void) {
+  for (int i = -40000; i <= 40000; i++) {
+    float value = i * 0.8191f;  // Spans the range with fractional parts
+    double tolerance = Q16_LSB / 2 + fabs(value) * 1.2e-7;
+    TEST_ASSERT_FLOAT_WITHIN(tolerance, value, q16ToFloat(q16FromFloat(value)));
+  }
+}
+
+// Multiply and divide match double math on the same Q16.16 inputs to one
+// LSB (plus the float's precision when reading the result back)
+void test_q16_multiply_divide(void) {
+  const float values[] = {0.001f, 0.5f, 1.0f, 3.75f, 100.0f, 1234.5f, 7000.0f};
+  for (float a : values) {
+    for (float b : values) {
+      q16_t qa = q16FromFloat(a);
+      q16_t qb = q16FromFloat(b);
+      double product = (double)qa * qb * Q16_LSB * Q16_LSB;
+      if (product < Q16_MAX_INT) {
+        TEST_ASSERT_FLOAT_WITHIN(Q16_LSB + product * 1.2e-7, product, q16ToFloat(q16Mul(qa, qb)));
+      }
+      double quotient = (double)qa / qb;
+      if (quotient < Q16_MAX_INT) {
+        TEST_ASSERT_FLOAT_WITHIN(Q16_LSB + quotient * 1.2e-7, quotient, q16ToFloat(q16Div(qa, qb)));
+      }
+    }
+  }
+}
+
+//* ************************************************************************
+//* ************************ STEP RAMP ***************************
+//* ************************************************************************
+
+// Integer ramp configuration matches the float one for every config rate
+void test_ramp_configuration_matches_float(void) {
+  for (const RatePair& rates : CONFIG_RATES) {
+    StepRamp ramp = {};
+    stepRampReset(ramp);
+    stepRampConfigure(ramp, rates.speed, rates.acceleration);
+    FloatRamp reference = floatRampConfigure(q16ToFloat(rates.speed), q16ToFloat(rates.acceleration));
+
+    TEST_ASSERT_FLOAT_WITHIN(reference.c0 * 1e-5 + 1, reference.c0, ramp.c0);
+    TEST_ASSERT_UINT32_WITHIN(1, reference.cMin, ramp.cMin);
+    TEST_ASSERT_EQUAL_INT32(reference.maxRampSteps, ramp.maxRampSteps);
+  }
+}
+
+// A move on the integer-configured ramp steps at the same times as one on
+// the float-configured ramp, and the reported speed follows the interval
+void test_ramp_speed_sequence_matches_float(void) {
+  for (const RatePair& rates : CONFIG_RATES) {
+    StepRamp ramp = {};
+    stepRampReset(ramp);
+    stepRampConfigure(ramp, rates.speed, rates.acceleration);
+
+    FloatRamp reference = floatRampConfigure(q16ToFloat(rates.speed), q16ToFloat(rates.acceleration));
+    StepRamp floatRamp = ramp;
+    floatRamp.c0 = reference.c0;
+    floatRamp.cMin = reference.cMin;
+    floatRamp.maxRampSteps = reference.maxRampSteps;
+
+    // cMin is whole 1/256 ticks, so the cap sits a hair above the config speed
+    const double capSpeed = (double)STEP_TIMER_TICKS_PER_SEC * (1 << STEP_RAMP_FRACTION_BITS) / ramp.cMin;
+    const long distance = 6000;
+    long position = 0;
+    uint64_t time = 0, floatTime = 0;
+    stepRampNext(ramp, distance);
+    stepRampNext(floatRamp, distance);
+    for (;;) {
+      position += ramp.direction;
+      uint32_t interval = stepRampNext(ramp, distance - position);
+      uint32_t floatInterval = stepRampNext(floatRamp, distance - position);
+      TEST_ASSERT_UINT32_WITHIN(1, floatInterval, interval);
+      if (interval == 0) {
+        break;
+      }
+      time += interval;
+      floatTime += floatInterval;
+
+      double speed = (double)STEP_TIMER_TICKS_PER_SEC * (1 << STEP_RAMP_FRACTION_BITS) / ramp.cn;
+      TEST_ASSERT_FLOAT_WITHIN(Q16_LSB + speed * 1.2e-7, speed, q16ToFloat(stepRampSpeed(ramp)));
+      TEST_ASSERT_LESS_OR_EQUAL(capSpeed + Q16_LSB + capSpeed * 1.2e-7, q16ToFloat(stepRampSpeed(ramp)));
+    }
+    TEST_ASSERT_EQUAL(distance, position);
+    TEST_ASSERT_FLOAT_WITHIN(floatTime * 1e-4, floatTime, time);  // Same move time to 0.01%
+  }
+}
+
+// Re-seeding from a speed (jog and stop) matches the float version
+void test_ramp_set_speed_matches_float(void) {
+  StepRamp ramp = {};
+  stepRampReset(ramp);
+  stepRampConfigure(ramp, X_MAX_SPEED, X_ACCELERATION);
+  float acceleration = q16ToFloat(X_ACCELERATION);
+  for (int speed = 1; speed <= 7000; speed += 37) {
+    stepRampSetSpeed(ramp, q16FromInt(-speed));
+    int32_t n = (int32_t)(((float)speed * speed) / (2.0f * acceleration));
+    if (n < 1) n = 1;
+    if (n > ramp.maxRampSteps) n = ramp.maxRampSteps;
+    uint32_t cn = (uint32_t)((STEP_TIMER_TICKS_PER_SEC * (float)(1 << STEP_RAMP_FRACTION_BITS)) / speed);
+
+    TEST_ASSERT_EQUAL_INT32(n, ramp.n);
+    TEST_ASSERT_FLOAT_WITHIN(cn * 1e-6 + 1, cn, ramp.cn);
+    TEST_ASSERT_EQUAL(-1, ramp.direction);
+  }
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_config_positions_match_float);
+  RUN_TEST(test_inches_to_steps_rounds_to_nearest);
+  RUN_TEST(test_q16_int_round_trip);
+  RUN_TEST(test_q16_float_conversions);
+  RUN_TEST(test_q16_multiply_divide);
+  RUN_TEST(test_ramp_configuration_matches_float);
+  RUN_TEST(test_ramp_speed_sequence_matches_float);
+  RUN_TEST(test_ramp_set_speed_matches_float);
+  return UNITY_END();
+}
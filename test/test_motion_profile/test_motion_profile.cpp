@@ -0,0 +1,149 @@
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "MotionProfile.h"
+#include "StepRamp.h"
+#include "Config/Config.h"
+
+//* ************************************************************************
+//* ************************ MOTION PROFILE BENCHMARK ***************************
+//* ************************************************************************
+// Host benchmark for the pickup -> overshoot -> dropoff legs (pio test -e
+// native). Each leg is planned as a trapezoid and as an S-curve with the
+// configured limits, then played the way StepperAxis plays a profile table:
+// ramp intervals forward, cruise with the carried fraction, ramp intervals
+// backward. Reports the played move time and how long planning took, and
+// checks the played time against the ideal estimate the 'profiles' command
+// prints.
+
+static uint16_t table[MAX_PROFILE_RAMP_STEPS];
+
+// One production leg
+struct Leg {
+  const char* name;
+  long from;
+  long to;
+};
+
+static const Leg X_LEGS[] = {
+    {"X pickup -> overshoot", X_PICKUP_POS, X_DROPOFF_OVERSHOOT_POS},
+    {"X overshoot -> dropoff", X_DROPOFF_OVERSHOOT_POS, X_DROPOFF_POS},
+    {"X pickup -> dropoff", X_PICKUP_POS, X_DROPOFF_POS},
+};
+
+static ProfileLimits xLimits() {
+  ProfileLimits limits = {q16ToFloat(X_MAX_SPEED), q16ToFloat(X_ACCELERATION), (float)X_JERK};
+  return limits;
+}
+
+// Ticks from the first step to the last, as StepperAxis plays the table
+static uint64_t playTable(const uint16_t* intervals, int rampSteps, uint32_t cruise, long distance) {
+  long steps = labs(distance);
+  long lastGap = steps - 2;
+  uint32_t remainder = 0;
+  uint64_t ticks = 0;
+  for (long gap = 0; gap <= lastGap; gap++) {
+    uint32_t interval;
+    if (gap < rampSteps) {
+      interval = intervals[gap];
+    } else if (gap > lastGap - rampSteps) {
+      interval = intervals[lastGap - gap];
+    } else {
+      uint32_t total = cruise + remainder;
+      remainder = total & ((1 << STEP_RAMP_FRACTION_BITS) - 1);
+      interval = total >> STEP_RAMP_FRACTION_BITS;
+    }
+    ticks += (interval > 0) ? interval : 1;
+  }
+  return ticks;
+}
+
+// Plan one leg; returns the played time in seconds and the planning time in us
+static double planAndPlay(const ProfileLimits& limits, MotionProfileType type, long distance, double* planMicros) {
+  uint32_t cruise = 0;
+  auto start = std::chrono::steady_clock::now();
+  int rampSteps = buildProfileRamp(limits, type, distance, table, MAX_PROFILE_RAMP_STEPS, &cruise);
+  auto end = std::chrono::steady_clock::now();
+  *planMicros = std::chrono::duration<double, std::micro>(end - start).count();
+  TEST_ASSERT_TRUE_MESSAGE(rampSteps >= 0, "ramp does not fit the profile table");
+  return (double)playTable(table, rampSteps, cruise, distance) / STEP_TIMER_TICKS_PER_SEC;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+//* ************************************************************************
+//* ************************ TESTS ***************************
+//* ************************************************************************
+
+// The played table matches the ideal move time. The time to the first step
+// from rest is not part of the played time (it starts at the first step).
+void test_played_time_matches_estimate(void) {
+  ProfileLimits limits = xLimits();
+  const MotionProfileType types[] = {PROFILE_TRAPEZOID, PROFILE_SCURVE};
+  for (const Leg& leg : X_LEGS) {
+    for (MotionProfileType type : types) {
+      double planMicros = 0;
+      long distance = leg.to - leg.from;
+      double played = planAndPlay(limits, type, distance, &planMicros);
+      double ideal = estimateMoveTime(limits, type, distance);
+      double firstStep = (double)table[0] / STEP_TIMER_TICKS_PER_SEC;
+      TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.005 * ideal + firstStep, ideal, played, leg.name);
+    }
+  }
+}
+
+// With the same acceleration limit, limiting jerk can only lengthen a move
+void test_scurve_is_never_faster_at_equal_limits(void) {
+  ProfileLimits limits = xLimits();
+  for (const Leg& leg : X_LEGS) {
+    double planMicros = 0;
+    long distance = leg.to - leg.from;
+    double trapezoid = planAndPlay(limits, PROFILE_TRAPEZOID, distance, &planMicros);
+    double sCurve = planAndPlay(limits, PROFILE_SCURVE, distance, &planMicros);
+    TEST_ASSERT_GREATER_OR_EQUAL(trapezoid * 0.999, sCurve);
+  }
+}
+
+// Move time and planning cost for every leg under both profiles, plus the
+// S-curve at double the acceleration the trapezoid runs at
+void test_benchmark_transfer_legs(void) {
+  ProfileLimits limits = xLimits();
+  ProfileLimits raised = limits;
+  raised.acceleration *= 2.0f;
+
+  double totals[3] = {0, 0, 0};
+  for (const Leg& leg : X_LEGS) {
+    long distance = leg.to - leg.from;
+    double planMicros[3];
+    double played[3] = {
+        planAndPlay(limits, PROFILE_TRAPEZOID, distance, &planMicros[0]),
+        planAndPlay(limits, PROFILE_SCURVE, distance, &planMicros[1]),
+        planAndPlay(raised, PROFILE_SCURVE, distance, &planMicros[2]),
+    };
+    char text[200];
+    snprintf(text, sizeof(text),
+             "%s (%ld steps): trapezoid %.1f ms, S-curve %.1f ms, S-curve 2x accel %.1f ms "
+             "(planned in %.0f / %.0f / %.0f us on this host)",
+             leg.name, distance, played[0] * 1000, played[1] * 1000, played[2] * 1000, planMicros[0],
+             planMicros[1], planMicros[2]);
+    TEST_MESSAGE(text);
+    if (&leg != &X_LEGS[2]) {
+      for (int i = 0; i < 3; i++) totals[i] += played[i];
+    }
+  }
+  char text[160];
+  snprintf(text, sizeof(text), "X transfer via overshoot: trapezoid %.1f ms, S-curve %.1f ms, S-curve 2x accel %.1f ms",
+           totals[0] * 1000, totals[1] * 1000, totals[2] * 1000);
+  TEST_MESSAGE(text);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_played_time_matches_estimate);
+  RUN_TEST(test_scurve_is_never_faster_at_equal_limits);
+  RUN_TEST(test_benchmark_transfer_legs);
+  return UNITY_END();
+}
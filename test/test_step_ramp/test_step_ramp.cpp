@@ -0,0 +1,186 @@
+#include <unity.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "StepRamp.h"
+
+//* ************************************************************************
+//* ************************ STEP RAMP TESTS ***************************
+//* ************************************************************************
+// Host tests for the integer step ramp (pio test -e native). A virtual
+// timer plays the ramp the way StepperAxis's timer interrupt does: the
+// interval fetched when the move starts only sets the direction, the first
+// step fires straight away, and each later step fires one interval after
+// the one before. Step times are then compared with the ideal constant
+// acceleration ramp.
+
+// Largest move the virtual timer records
+static const int MAX_STEPS = 20000;
+
+// One move played on the virtual timer
+struct VirtualMove {
+  long position;           // Final position (steps)
+  int steps;               // Steps taken
+  uint32_t gaps[MAX_STEPS];  // Ticks between step i and step i + 1
+  uint64_t duration;       // Ticks from the first step to the last
+};
+
+static VirtualMove move;
+
+// Run a move of `distance` steps from standstill
+static void runVirtualMove(StepRamp& ramp, long distance) {
+  move.position = 0;
+  move.steps = 0;
+  move.duration = 0;
+  if (stepRampNext(ramp, distance) == 0) {
+    return;
+  }
+  for (;;) {
+    move.position += ramp.direction;  // Direction chosen by the previous interval
+    move.steps++;
+    uint32_t interval = stepRampNext(ramp, distance - move.position);
+    if (interval == 0) {
+      return;
+    }
+    TEST_ASSERT_TRUE_MESSAGE(move.steps < MAX_STEPS, "move did not finish");
+    move.gaps[move.steps - 1] = interval;
+    move.duration += interval;
+  }
+}
+
+static StepRamp makeRamp(int32_t maxSpeed, int32_t acceleration) {
+  StepRamp ramp = {};
+  stepRampReset(ramp);
+  stepRampConfigure(ramp, q16FromInt(maxSpeed), q16FromInt(acceleration));
+  return ramp;
+}
+
+// Ideal time (ticks) to travel `steps` from standstill at constant acceleration
+static double idealRampTime(double steps, double acceleration) {
+  return sqrt(2.0 * steps / acceleration) * STEP_TIMER_TICKS_PER_SEC;
+}
+
+// Ideal time (ticks) from the first step to the last for a trapezoid move
+static double idealMoveTime(long distance, double maxSpeed, double acceleration) {
+  double rampSteps = maxSpeed * maxSpeed / (2.0 * acceleration);
+  double start = idealRampTime(1, acceleration);  // The first step is the time origin
+  if (distance >= 2 * rampSteps) {
+    double cruise = (distance - 2 * rampSteps) / maxSpeed * STEP_TIMER_TICKS_PER_SEC;
+    return 2 * idealRampTime(rampSteps, acceleration) + cruise - start;
+  }
+  return 2 * idealRampTime(distance / 2.0, acceleration) - start;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+//* ************************************************************************
+//* ************************ TESTS ***************************
+//* ************************************************************************
+
+// Every move ends exactly on target, in either direction
+void test_moves_end_on_target(void) {
+  const long distances[] = {1, 2, 3, 10, 100, 2449, 2450, 2451, 8000, -1, -500, -8000};
+  for (long distance : distances) {
+    StepRamp ramp = makeRamp(7000, 10000);
+    runVirtualMove(ramp, distance);
+    TEST_ASSERT_EQUAL(distance, move.position);
+    TEST_ASSERT_EQUAL(labs(distance), move.steps);
+    TEST_ASSERT_EQUAL(0, ramp.direction);
+  }
+}
+
+// Acceleration intervals follow the ideal ramp to within 0.5% plus the
+// whole-tick rounding of each interval
+void test_acceleration_intervals_match_ideal(void) {
+  const double acceleration = 10000;
+  StepRamp ramp = makeRamp(7000, 10000);
+  runVirtualMove(ramp, 8000);
+
+  double worst = 0;
+  for (int i = 0; i < ramp.maxRampSteps - 1; i++) {
+    // Gap i is from position i + 1 to i + 2
+    double ideal = idealRampTime(i + 2, acceleration) - idealRampTime(i + 1, acceleration);
+    double error = fabs(move.gaps[i] - ideal);
+    if (i >= 3) {
+      // Austin's first intervals are a coarse approximation by design
+      TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(0.005 * ideal + 1, error, "acceleration interval off the ideal ramp");
+    }
+    if (error / ideal > worst) worst = error / ideal;
+  }
+  char text[64];
+  snprintf(text, sizeof(text), "worst acceleration interval error %.2f%%", worst * 100);
+  TEST_MESSAGE(text);
+}
+
+// At cruise the carried fraction keeps the average rate exact even though
+// each interval is whole ticks
+void test_cruise_rate_is_exact(void) {
+  StepRamp ramp = makeRamp(7000, 10000);
+  runVirtualMove(ramp, 20000 - 1);
+
+  int rampSteps = ramp.maxRampSteps;
+  int first = rampSteps + 10;
+  int last = move.steps - rampSteps - 10;
+  uint64_t ticks = 0;
+  for (int i = first; i < last; i++) {
+    TEST_ASSERT_UINT32_WITHIN(1, 143, move.gaps[i]);  // 1e6 / 7000 = 142.857
+    ticks += move.gaps[i];
+  }
+  double average = (double)ticks / (last - first);
+  TEST_ASSERT_FLOAT_WITHIN(0.01, 1e6 / 7000.0, average);
+}
+
+// The speed limit holds on every step
+void test_speed_never_exceeds_max(void) {
+  const int32_t speeds[] = {1000, 3000, 7000, 10000};
+  for (int32_t speed : speeds) {
+    StepRamp ramp = makeRamp(speed, 10000);
+    runVirtualMove(ramp, 10000);
+    uint32_t shortest = (uint32_t)(STEP_TIMER_TICKS_PER_SEC / speed);  // Whole ticks round down
+    for (int i = 0; i < move.steps - 1; i++) {
+      TEST_ASSERT_GREATER_OR_EQUAL(shortest, move.gaps[i]);
+    }
+  }
+}
+
+// Whole moves, triangular and trapezoidal, take the ideal time to within
+// 0.5%. The last interval before stopping is c0, which Austin's 0.676 factor
+// makes shorter than the ideal one by design, so that fixed amount is allowed
+// on top.
+void test_move_time_matches_ideal(void) {
+  const double acceleration = 10000;
+  const double c0Shortening = (1.0 - 0.676) * idealRampTime(1, acceleration);
+  const long distances[] = {20, 200, 1000, 4900, 8000, 19000};
+  for (long distance : distances) {
+    StepRamp ramp = makeRamp(7000, 10000);
+    runVirtualMove(ramp, distance);
+    double ideal = idealMoveTime(distance, 7000, acceleration);
+    double error = fabs((double)move.duration - ideal);
+    TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(0.005 * ideal + c0Shortening, error, "move time off the ideal trapezoid");
+  }
+}
+
+// Deceleration mirrors acceleration one step later: the last gap before
+// stopping is the first interval from standstill (c0)
+void test_deceleration_mirrors_acceleration(void) {
+  StepRamp ramp = makeRamp(7000, 10000);
+  runVirtualMove(ramp, 8000);
+  int gaps = move.steps - 1;
+  for (int i = 1; i < ramp.maxRampSteps; i++) {
+    double up = move.gaps[i - 1];
+    double down = move.gaps[gaps - 1 - i];
+    TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(0.005 * up + 1, fabs(up - down), "deceleration is not symmetric");
+  }
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_moves_end_on_target);
+  RUN_TEST(test_acceleration_intervals_match_ideal);
+  RUN_TEST(test_cruise_rate_is_exact);
+  RUN_TEST(test_speed_never_exceeds_max);
+  RUN_TEST(test_move_time_matches_ideal);
+  RUN_TEST(test_deceleration_mirrors_acceleration);
+  return UNITY_END();
+}
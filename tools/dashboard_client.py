@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+"""Command-line client for the Transfer Arm dashboard WebSocket server.
+
+Connects to ws://<host>:81 the way data/index.html does, prints every
+message the controller pushes and keeps the merged status on one line:
+
+    python3 tools/dashboard_client.py 192.168.1.212
+    python3 tools/dashboard_client.py 192.168.1.212 --send home
+    python3 tools/dashboard_client.py 192.168.1.212 --raw --seconds 10
+
+The host build of the server (HostDashboardServer.h) listens on a
+loopback port; pass localhost and --port to talk to it instead.
+
+--send takes a dashboard command (getStatus, getConfig, emergencyStop) or a
+manualControl action (home, pickCycle). Only the standard library is used,
+so it runs anywhere Python 3 does.
+"""
+
+import argparse
+import base64
+import json
+import os
+import socket
+import struct
+import sys
+import time
+
+COMMANDS = ("getStatus", "getConfig", "emergencyStop")
+ACTIONS = ("home", "pickCycle")
+
+
+def connect(host, port, timeout):
+    """Open the TCP connection and complete the WebSocket handshake."""
+    sock = socket.create_connection((host, port), timeout=timeout)
+    key = base64.b64encode(os.urandom(16)).decode()
+    request = (
+        f"GET / HTTP/1.1\r\nHost: {host}:{port}\r\nUpgrade: websocket\r\n"
+        f"Connection: Upgrade\r\nSec-WebSocket-Key: {key}\r\nSec-WebSocket-Version: 13\r\n\r\n"
+    )
+    sock.sendall(request.encode())
+    response = b""
+    while b"\r\n\r\n" not in response:
+        chunk = sock.recv(1024)
+        if not chunk:
+            raise ConnectionError("connection closed during handshake")
+        response += chunk
+    status_line = response.split(b"\r\n", 1)[0].decode(errors="replace")
+    if " 101 " not in status_line:
+        raise ConnectionError(f"handshake refused: {status_line}")
+    return sock, response.split(b"\r\n\r\n", 1)[1]
+
+
+def send_text(sock, text):
+    """Send one masked text frame (clients must mask)."""
+    payload = text.encode()
+    mask = os.urandom(4)
+    header = bytes([0x81])
+    if len(payload) < 126:
+        header += bytes([0x80 | len(payload)])
+    else:
+        header += bytes([0x80 | 126]) + struct.pack(">H", len(payload))
+    masked = bytes(b ^ mask[i % 4] for i, b in enumerate(payload))
+    sock.sendall(header + mask + masked)
+
+
+def read_exact(sock, buffer, count):
+    while len(buffer) < count:
+        chunk = sock.recv(4096)
+        if not chunk:
+            raise ConnectionError("connection closed")
+        buffer += chunk
+    return buffer[:count], buffer[count:]
+
+
+def read_frame(sock, buffer):
+    """Return (opcode, payload, remaining buffer) for the next frame."""
+    header, buffer = read_exact(sock, buffer, 2)
+    opcode = header[0] & 0x0F
+    length = header[1] & 0x7F
+    if length == 126:
+        extended, buffer = read_exact(sock, buffer, 2)
+        length = struct.unpack(">H", extended)[0]
+    elif length == 127:
+        extended, buffer = read_exact(sock, buffer, 8)
+        length = struct.unpack(">Q", extended)[0]
+    payload, buffer = read_exact(sock, buffer, length)
+    return opcode, payload, buffer
+
+
+def command_message(name):
+    if name in COMMANDS:
+        return {"command": name}
+    if name in ACTIONS:
+        return {"command": "manualControl", "action": name}
+    raise SystemExit(f"unknown command '{name}' (expected one of {', '.join(COMMANDS + ACTIONS)})")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("host", help="controller address (or localhost)")
+    parser.add_argument("--port", type=int, default=81)
+    parser.add_argument("--send", action="append", default=[], help="command or action to send after connecting")
+    parser.add_argument("--seconds", type=float, default=0, help="exit after this long (0 = run until Ctrl-C)")
+    parser.add_argument("--raw", action="store_true", help="print every message as received")
+    args = parser.parse_args()
+
+    sock, buffer = connect(args.host, args.port, timeout=5)
+    sock.settimeout(0.5)
+    print(f"Connected to ws://{args.host}:{args.port}", file=sys.stderr)
+    for name in args.send:
+        send_text(sock, json.dumps(command_message(name)))
+
+    status = {}
+    updates = 0
+    started = time.monotonic()
+    try:
+        while args.seconds <= 0 or time.monotonic() - started < args.seconds:
+            try:
+                opcode, payload, buffer = read_frame(sock, buffer)
+            except socket.timeout:
+                continue
+            if opcode == 0x8:
+                print("\nServer closed the connection", file=sys.stderr)
+                break
+            if opcode != 0x1:
+                continue
+            message = json.loads(payload)
+            if args.raw:
+                print(payload.decode())
+            elif message.get("type") == "status":
+                status.update(message)
+                updates += 1
+                line = " ".join(f"{key}={value}" for key, value in status.items() if key != "type")
+                print(f"\r[{updates}] {line}\033[K", end="", flush=True)
+            elif message.get("type") == "log":
+                print(f"\nlog: {message.get('message')}")
+            elif message.get("type") == "config":
+                print(f"\nconfig: {json.dumps(message.get('config'))}")
+    except KeyboardInterrupt:
+        pass
+    finally:
+        sock.close()
+    elapsed = time.monotonic() - started
+    print(f"\n{updates} status messages in {elapsed:.1f} s", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
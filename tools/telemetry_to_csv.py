@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Receive the Transfer Arm binary telemetry stream and write CSV.
+
+Start the receiver, then point the controller at it over Serial:
+
+    python3 tools/telemetry_to_csv.py -o run.csv           # listens on UDP 5005
+    telemetry 192.168.1.50 5005 500                        # on the controller
+    telemetry off
+
+Stops on Ctrl-C, after --seconds, or after --samples. Lost packets (gaps in
+the packet sequence) and samples the controller dropped are reported on
+stderr when the receiver stops.
+
+The packet layout mirrors include/Telemetry.h. Keep TelemetryPacketHeader,
+TelemetrySample and the bit numbers below in sync with it.
+"""
+
+import argparse
+import csv
+import socket
+import struct
+import sys
+import time
+
+TELEMETRY_MAGIC = 0x31544154
+TELEMETRY_VERSION = 1
+
+HEADER = struct.Struct("<IBBHII")  # magic, version, sampleSize, sampleCount, sequence, dropped
+SAMPLE = struct.Struct("<IiihhhBBB3x")  # timestamp, x, z, xSpeed, zSpeed, servo, outputs, inputs, phase
+
+# TelemetryOutput
+OUTPUT_VACUUM = 0
+OUTPUT_STAGE2_SIGNAL = 1
+
+COLUMNS = [
+    "time_s",
+    "x",
+    "z",
+    "x_speed",
+    "z_speed",
+    "servo_deg",
+    "vacuum",
+    "stage2_signal",
+    "inputs",
+    "main_state",
+    "sub_state",
+    "packet",
+]
+
+
+class Decoder:
+    """Turns datagrams into CSV rows, unwrapping the 32-bit micros() clock."""
+
+    def __init__(self, writer):
+        self.writer = writer
+        self.first_micros = None
+        self.last_micros = None
+        self.wraps = 0
+        self.next_sequence = None
+        self.lost_packets = 0
+        self.dropped = 0
+        self.samples = 0
+        self.rejected = 0
+
+    def decode(self, datagram):
+        if len(datagram) < HEADER.size:
+            self.rejected += 1
+            return
+        magic, version, sample_size, count, sequence, dropped = HEADER.unpack_from(datagram)
+        if magic != TELEMETRY_MAGIC or version != TELEMETRY_VERSION or sample_size < SAMPLE.size:
+            self.rejected += 1
+            return
+        if len(datagram) < HEADER.size + count * sample_size:
+            self.rejected += 1
+            return
+
+        if self.next_sequence is not None and sequence != self.next_sequence:
+            if sequence > self.next_sequence:
+                self.lost_packets += sequence - self.next_sequence
+            else:
+                # Stream restarted on the controller - start the clock over
+                self.first_micros = None
+        self.next_sequence = sequence + 1
+        self.dropped = dropped
+
+        for i in range(count):
+            fields = SAMPLE.unpack_from(datagram, HEADER.size + i * sample_size)
+            self.write_sample(sequence, *fields)
+
+    def write_sample(self, sequence, micros, x, z, x_speed, z_speed, servo, outputs, inputs, phase):
+        if self.first_micros is None:
+            self.first_micros = micros
+            self.last_micros = micros
+            self.wraps = 0
+        if micros < self.last_micros:
+            self.wraps += 1
+        self.last_micros = micros
+        elapsed = (micros + (self.wraps << 32) - self.first_micros) / 1e6
+
+        self.writer.writerow(
+            [
+                f"{elapsed:.6f}",
+                x,
+                z,
+                x_speed,
+                z_speed,
+                f"{servo / 100:.2f}",
+                (outputs >> OUTPUT_VACUUM) & 1,
+                (outputs >> OUTPUT_STAGE2_SIGNAL) & 1,
+                f"0x{inputs:02x}",
+                phase >> 4,
+                phase & 0x0F,
+                sequence,
+            ]
+        )
+        self.samples += 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("-o", "--output", help="CSV file (default stdout)")
+    parser.add_argument("--port", type=int, default=5005, help="UDP port to listen on")
+    parser.add_argument("--bind", default="0.0.0.0", help="address to listen on")
+    parser.add_argument("--seconds", type=float, default=0, help="stop after this long (0 = until Ctrl-C)")
+    parser.add_argument("--samples", type=int, default=0, help="stop after this many samples (0 = no limit)")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind((args.bind, args.port))
+    sock.settimeout(0.5)
+    print(f"Listening on UDP {args.bind}:{args.port}", file=sys.stderr)
+
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    writer = csv.writer(out)
+    writer.writerow(COLUMNS)
+    decoder = Decoder(writer)
+
+    started = time.monotonic()
+    try:
+        while args.seconds <= 0 or time.monotonic() - started < args.seconds:
+            if args.samples and decoder.samples >= args.samples:
+                break
+            try:
+                datagram, _ = sock.recvfrom(2048)
+            except socket.timeout:
+                continue
+            decoder.decode(datagram)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        sock.close()
+        if out is not sys.stdout:
+            out.close()
+
+    print(
+        f"{decoder.samples} samples, {decoder.lost_packets} packets lost in transit, "
+        f"{decoder.dropped} samples dropped on the controller, {decoder.rejected} packets rejected",
+        file=sys.stderr,
+    )
+
+
+if __name__ == "__main__":
+    main()
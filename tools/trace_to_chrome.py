@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+"""Convert a Transfer Arm 'trace dump' capture into Chrome trace JSON.
+
+Capture the Serial output of the 'trace dump' command to a file (log lines
+mixed in are ignored), then:
+
+    python3 tools/trace_to_chrome.py capture.txt -o cycle.json
+
+Open the result in chrome://tracing or https://ui.perfetto.dev. Each axis,
+the servo, every output pin, every input and the state machine get their
+own track, so one pick cycle reads as a Gantt chart.
+
+The numeric codes below mirror include/EventTrace.h, the MainState enum in
+src/PickCycle.cpp and the sequence state enums in include/Config/Config.h.
+Keep them in sync when those enums change.
+"""
+
+import argparse
+import json
+import re
+import sys
+
+# TraceEventType
+TRACE_STATE = 0
+TRACE_MOTION_START = 1
+TRACE_MOTION_END = 2
+TRACE_INPUT = 3
+TRACE_OUTPUT = 4
+TRACE_SERVO = 5
+
+AXIS_NAMES = {0: "X axis", 1: "Z axis"}
+
+INPUT_NAMES = {
+    0: "start button",
+    1: "Stage 1 signal",
+    2: "Stage 2 stop",
+    3: "X home switch",
+    4: "Z home switch",
+}
+
+# MainState -> (name, sub-state names)
+STATE_NAMES = {
+    0: ("homing", ["Z axis", "raise Z", "X axis", "move X to pickup", "complete"]),
+    1: ("idle", ["wait", "trigger detected"]),
+    2: ("pickup", ["move to pickup", "lower Z", "wait at pickup", "raise Z with object", "complete"]),
+    3: ("transport", ["rotate servo to travel", "move to overshoot", "rotate servo in motion",
+                      "wait for servo", "return to dropoff", "complete"]),
+    4: ("dropoff", ["lower Z", "release object", "wait after release", "raise Z", "complete"]),
+    5: ("completion", ["signal Stage 2", "return X", "home X", "final move to pickup", "complete"]),
+}
+
+EVENT_LINE = re.compile(r"^E,(\d+),(\d+),(\d+),(-?\d+)\s*$")
+OUTPUT_LINE = re.compile(r"^O,(\d+),(.+?)\s*$")
+
+PID = 1
+THREADS = ["state machine", "X axis", "Z axis", "servo"]
+
+
+def state_name(main_state, sub_state):
+    name, sub_names = STATE_NAMES.get(main_state, ("state %d" % main_state, []))
+    if sub_state < len(sub_names):
+        return "%s: %s" % (name, sub_names[sub_state])
+    return "%s: %d" % (name, sub_state)
+
+
+def parse_capture(lines):
+    """Return (events, output pin names). Timestamps are unwrapped to 64 bits."""
+    events = []
+    outputs = {}
+    offset = 0
+    last_raw = None
+    for line in lines:
+        match = OUTPUT_LINE.match(line)
+        if match:
+            outputs[int(match.group(1))] = match.group(2)
+            continue
+        match = EVENT_LINE.match(line)
+        if not match:
+            continue
+        raw, event_type, track, value = (int(group) for group in match.groups())
+        if last_raw is not None and raw < last_raw:
+            offset += 1 << 32  # micros() wrapped
+        last_raw = raw
+        events.append((raw + offset, event_type, track, value))
+    return events, outputs
+
+
+class TraceBuilder:
+    def __init__(self):
+        self.events = []
+        self.thread_ids = {}
+
+    def tid(self, thread):
+        if thread not in self.thread_ids:
+            self.thread_ids[thread] = len(self.thread_ids) + 1
+            self.events.append({"ph": "M", "name": "thread_name", "pid": PID,
+                                "tid": self.thread_ids[thread], "args": {"name": thread}})
+            self.events.append({"ph": "M", "name": "thread_sort_index", "pid": PID,
+                                "tid": self.thread_ids[thread], "args": {"sort_index": self.thread_ids[thread]}})
+        return self.thread_ids[thread]
+
+    def span(self, thread, name, start, end, args=None):
+        event = {"ph": "X", "name": name, "pid": PID, "tid": self.tid(thread),
+                 "ts": start, "dur": max(end - start, 0)}
+        if args:
+            event["args"] = args
+        self.events.append(event)
+
+    def instant(self, thread, name, ts, args=None):
+        event = {"ph": "i", "s": "t", "name": name, "pid": PID, "tid": self.tid(thread), "ts": ts}
+        if args:
+            event["args"] = args
+        self.events.append(event)
+
+    def counter(self, name, ts, values):
+        self.events.append({"ph": "C", "name": name, "pid": PID, "ts": ts, "args": values})
+
+
+def convert(events, outputs):
+    builder = TraceBuilder()
+    builder.events.append({"ph": "M", "name": "process_name", "pid": PID, "args": {"name": "Transfer Arm"}})
+    for thread in THREADS:
+        builder.tid(thread)
+
+    if not events:
+        return builder.events
+
+    first = events[0][0]
+    end = events[-1][0]
+    open_state = None     # (start, name)
+    open_motion = {}      # axis -> (start, target)
+    open_levels = {}      # thread -> start of the HIGH span
+
+    for ts, event_type, track, value in events:
+        if event_type == TRACE_STATE:
+            if open_state is not None:
+                builder.span("state machine", open_state[1], open_state[0], ts)
+            open_state = (ts, state_name(track, value))
+
+        elif event_type == TRACE_MOTION_START:
+            axis = AXIS_NAMES.get(track, "axis %d" % track)
+            if axis in open_motion:
+                start, target = open_motion[axis]
+                builder.span(axis, "move to %d" % target, start, ts, {"target": target})
+            open_motion[axis] = (ts, value)
+
+        elif event_type == TRACE_MOTION_END:
+            axis = AXIS_NAMES.get(track, "axis %d" % track)
+            if axis in open_motion:
+                start, target = open_motion.pop(axis)
+                builder.span(axis, "move to %d" % target, start, ts, {"target": target, "end": value})
+            else:
+                # Move started before the oldest recorded event
+                builder.span(axis, "move", first, ts, {"end": value})
+            builder.counter(axis + " position", ts, {"steps": value})
+
+        elif event_type in (TRACE_INPUT, TRACE_OUTPUT):
+            if event_type == TRACE_INPUT:
+                thread = "input: " + INPUT_NAMES.get(track, str(track))
+            else:
+                thread = "output: " + outputs.get(track, "GPIO %d" % track)
+            if value:
+                open_levels.setdefault(thread, ts)
+            elif thread in open_levels:
+                builder.span(thread, "high", open_levels.pop(thread), ts)
+            else:
+                builder.instant(thread, "low", ts)
+
+        elif event_type == TRACE_SERVO:
+            degrees = value / 100.0
+            builder.instant("servo", "servo %.1f" % degrees, ts, {"degrees": degrees})
+            builder.counter("servo position", ts, {"degrees": degrees})
+
+    # Close whatever is still open at the end of the capture
+    if open_state is not None:
+        builder.span("state machine", open_state[1], open_state[0], end)
+    for axis, (start, target) in open_motion.items():
+        builder.span(axis, "move to %d" % target, start, end, {"target": target, "unfinished": True})
+    for thread, start in open_levels.items():
+        builder.span(thread, "high", start, end)
+
+    # Chrome traces are in microseconds; start the view at zero
+    for event in builder.events:
+        if "ts" in event:
+            event["ts"] -= first
+    return builder.events
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", nargs="?", help="Serial capture of 'trace dump' (default: stdin)")
+    parser.add_argument("-o", "--output", help="Output JSON file (default: stdout)")
+    args = parser.parse_args()
+
+    if args.capture:
+        with open(args.capture, "r", errors="replace") as capture:
+            events, outputs = parse_capture(capture)
+    else:
+        events, outputs = parse_capture(sys.stdin)
+
+    trace = {"traceEvents": convert(events, outputs), "displayTimeUnit": "ms"}
+    if args.output:
+        with open(args.output, "w") as output:
+            json.dump(trace, output)
+    else:
+        json.dump(trace, sys.stdout)
+        sys.stdout.write("\n")
+
+    print("%d events converted" % len(events), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()